@@ -1,6 +1,8 @@
 #ifndef _CC_MEDIA_PLAYER_
 #define _CC_MEDIA_PLAYER_
 
+#include "platform/CCPlatformConfig.h"
+
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
 #define _WINSOCKAPI_    // stops windows.h including winsock.h
 // THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
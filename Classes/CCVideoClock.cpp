@@ -0,0 +1,84 @@
+#include "CCVideoClock.h"
+#include "audio/include/AudioEngine.h"
+
+#include <algorithm>
+
+USING_NS_CC;
+using cocos2d::experimental::AudioEngine;
+
+//-------------------------------CCVideoAudioClock----------------------------------------------//
+const double CCVideoAudioClock::MAX_EXTRAPOLATION = 0.1;
+
+CCVideoAudioClock * CCVideoAudioClock::create(int audioID, double offset)
+{
+	CCVideoAudioClock * clock = new (std::nothrow) CCVideoAudioClock(audioID, offset);
+	if (clock)
+	{
+		clock->autorelease();
+	}
+	return clock;
+}
+
+CCVideoAudioClock::CCVideoAudioClock(int audioID, double offset)
+: _audioID(audioID)
+, _offset(offset)
+, _lastPosition(0.0f)
+, _loops(0.0)
+, _extrapolated(0.0)
+, _lastTime(offset)
+{
+}
+
+bool CCVideoAudioClock::getTime(float dt, double& time)
+{
+	switch (AudioEngine::getState(_audioID))
+	{
+	case AudioEngine::AudioState::INITIALZING:
+	case AudioEngine::AudioState::PAUSED:
+		// the video waits for the sound.
+		time = _lastTime;
+		return true;
+	case AudioEngine::AudioState::PLAYING:
+		break;
+	default:
+		// the sound finished or was stopped, the video runs on its own.
+		return false;
+	}
+
+	float position = AudioEngine::getCurrentTime(_audioID);
+	if (position < 0.0f)
+	{
+		return false; // TIME_UNKNOWN
+	}
+
+	if (position != _lastPosition)
+	{
+		// a looping sound jumps back to its start, the clip time keeps going.
+		float duration = AudioEngine::getDuration(_audioID);
+		if (duration > 0.0f && position + duration * 0.5f < _lastPosition)
+		{
+			_loops += duration;
+		}
+		_lastPosition = position;
+		_extrapolated = 0.0;
+	}
+	else
+	{
+		_extrapolated = std::min(_extrapolated + dt, MAX_EXTRAPOLATION);
+	}
+
+	// when the position catches up with less than what was extrapolated the clock holds, repeating a frame.
+	_lastTime = std::max(_lastTime, _offset + _loops + position + _extrapolated);
+	time = _lastTime;
+	return true;
+}
+
+void CCVideoAudioClock::seek(double time)
+{
+	double position = std::max(time - _offset, 0.0);
+	AudioEngine::setCurrentTime(_audioID, (float)position);
+	_lastPosition = (float)position;
+	_loops = 0.0;
+	_extrapolated = 0.0;
+	_lastTime = _offset + position;
+}
@@ -0,0 +1,51 @@
+#ifndef _CC_VIDEO_CLOCK_
+#define _CC_VIDEO_CLOCK_
+
+#include "cocos2d.h"
+
+// Master clock of a CCVideoPlayer. Without one the player advances its clock by the frame delta,
+// with one frames are presented against the clock's time: when the clock runs ahead frames are
+// dropped, when it falls behind the current frame is shown again.
+class CCVideoClock : public cocos2d::Ref
+{
+public:
+
+	// Called once per player update on the cocos thread. Returns false when the clock can't tell
+	// the time right now, the player then advances by dt on its own.
+	virtual bool getTime(float dt, double& time) = 0;
+
+	// The player was seeked, the clock should continue from there.
+	virtual void seek(double time) {}
+};
+
+// Clock driven by the playback position of an AudioEngine sound, typically the soundtrack of the clip
+// started with AudioEngine::play2d. AudioEngine positions only move when the backend refills its
+// buffers, in between the clock extrapolates with the frame delta so the video stays smooth.
+class CCVideoAudioClock : public CCVideoClock
+{
+public:
+
+	// offset is the clip time at which the audio starts.
+	static CCVideoAudioClock * create(int audioID, double offset = 0.0);
+
+	virtual bool getTime(float dt, double& time) override;
+	virtual void seek(double time) override;
+
+	int getAudioID() const { return _audioID; }
+
+CC_CONSTRUCTOR_ACCESS:
+	CCVideoAudioClock(int audioID, double offset);
+
+protected:
+
+	static const double MAX_EXTRAPOLATION; // a stuck position stops the clock instead of running away
+
+	int _audioID;
+	double _offset;
+	float _lastPosition;   // last position reported by AudioEngine
+	double _loops;         // duration of the loops a looping sound already played
+	double _extrapolated;  // time since the position last moved
+	double _lastTime;      // the clock never runs backwards
+};
+
+#endif /*_CC_VIDEO_CLOCK_*/
@@ -0,0 +1,141 @@
+#include "CCVideoDecodePool.h"
+
+#include <algorithm>
+
+//-------------------------------CCVideoDecodePool----------------------------------------------//
+CCVideoDecodePool * CCVideoDecodePool::s_instance = nullptr;
+const int CCVideoDecodePool::IDLE_SLEEP_MS;
+
+CCVideoDecodePool * CCVideoDecodePool::getInstance()
+{
+	if (s_instance == nullptr)
+	{
+		s_instance = new CCVideoDecodePool();
+	}
+	return s_instance;
+}
+
+void CCVideoDecodePool::destroyInstance()
+{
+	delete s_instance;
+	s_instance = nullptr;
+}
+
+CCVideoDecodePool::CCVideoDecodePool()
+: _cursor(0)
+, _quit(false)
+{
+	// one core is left to the cocos thread, which uploads what the workers decode.
+	unsigned int cores = std::thread::hardware_concurrency();
+	_maxWorkers = cores > 1 ? cores - 1 : 1;
+}
+
+CCVideoDecodePool::~CCVideoDecodePool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_wakeUp.notify_all();
+	for (auto& worker : _workers)
+	{
+		worker.join();
+	}
+	for (auto entry : _entries)
+	{
+		delete entry;
+	}
+}
+
+void CCVideoDecodePool::addJob(void * owner, const Job& job)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_entries.push_back(new Entry{ owner, job, false, std::chrono::steady_clock::time_point() });
+		if (_workers.size() < std::min(_entries.size(), _maxWorkers))
+		{
+			_workers.emplace_back(&CCVideoDecodePool::workerLoop, this);
+		}
+	}
+	_wakeUp.notify_one();
+}
+
+void CCVideoDecodePool::removeJob(void * owner)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto it = std::find_if(_entries.begin(), _entries.end(), [owner](const Entry * entry) { return entry->owner == owner; });
+	if (it == _entries.end())
+	{
+		return;
+	}
+	Entry * entry = *it;
+	_released.wait(lock, [entry]() { return !entry->running; });
+
+	// indices move after the erase, the cursor only has to stay in range.
+	_entries.erase(std::find(_entries.begin(), _entries.end(), entry));
+	if (_cursor >= _entries.size())
+	{
+		_cursor = 0;
+	}
+	delete entry;
+}
+
+CCVideoDecodePool::Entry * CCVideoDecodePool::nextEntry(std::chrono::steady_clock::time_point now, std::chrono::steady_clock::time_point& wakeAt)
+{
+	wakeAt = std::chrono::steady_clock::time_point::max();
+	for (size_t i = 0; i < _entries.size(); ++i)
+	{
+		size_t index = (_cursor + i) % _entries.size();
+		Entry * entry = _entries[index];
+		if (entry->running)
+		{
+			continue;
+		}
+		if (entry->idleUntil <= now)
+		{
+			_cursor = (index + 1) % _entries.size();
+			return entry;
+		}
+		wakeAt = std::min(wakeAt, entry->idleUntil);
+	}
+	return nullptr;
+}
+
+void CCVideoDecodePool::workerLoop()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (!_quit)
+	{
+		std::chrono::steady_clock::time_point wakeAt;
+		Entry * entry = nextEntry(std::chrono::steady_clock::now(), wakeAt);
+		if (entry == nullptr)
+		{
+			// an idle worker sleeps until addJob, the timed wait is only for a throttled job.
+			if (wakeAt == std::chrono::steady_clock::time_point::max())
+			{
+				_wakeUp.wait(lock);
+			}
+			else
+			{
+				_wakeUp.wait_until(lock, wakeAt);
+			}
+			continue;
+		}
+
+		entry->running = true;
+		if (_entries.size() > 1)
+		{
+			// the other jobs may be runnable too, let a sleeping worker look at them.
+			_wakeUp.notify_one();
+		}
+		lock.unlock();
+		bool decoded = entry->job();
+		lock.lock();
+		entry->running = false;
+		if (!decoded)
+		{
+			entry->idleUntil = std::chrono::steady_clock::now() + std::chrono::milliseconds(IDLE_SLEEP_MS);
+		}
+		_released.notify_all();
+	}
+}
@@ -0,0 +1,66 @@
+#ifndef _CC_VIDEO_DECODE_POOL_
+#define _CC_VIDEO_DECODE_POOL_
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Decode threads shared by every CCVideoPlayer.
+// Each playing clip registers a job that decodes one frame per call, the workers take turns
+// over the jobs so N clips are spread across the cores instead of owning a thread each.
+// A job never runs on two workers at once, so a player's decoder and frame ring keep a single producer.
+class CCVideoDecodePool
+{
+public:
+
+	// Decodes one frame, returns false when there is nothing to do right now (ring full or end of clip).
+	typedef std::function<bool()> Job;
+
+	static CCVideoDecodePool * getInstance();
+	static void destroyInstance(); // joins the workers, every job must have been removed.
+
+	// owner identifies the job for removeJob.
+	void addJob(void * owner, const Job& job);
+	// Blocks until no worker runs the job, the owner may then touch its decoder again.
+	void removeJob(void * owner);
+
+	size_t getWorkerCount() const { return _workers.size(); }
+
+private:
+
+	static const int IDLE_SLEEP_MS = 4; // how long a job that had nothing to do is left alone
+
+	struct Entry
+	{
+		void * owner;
+		Job job;
+		bool running;
+		std::chrono::steady_clock::time_point idleUntil;
+	};
+
+	CCVideoDecodePool();
+	~CCVideoDecodePool();
+	CCVideoDecodePool(const CCVideoDecodePool&);
+	CCVideoDecodePool& operator=(const CCVideoDecodePool&);
+
+	void workerLoop();
+	// Round robin over the runnable jobs. Without one, wakeAt is set to when the first idle job may run again,
+	// or to time_point::max() when every job is running (or there is none) and only addJob can bring work.
+	Entry * nextEntry(std::chrono::steady_clock::time_point now, std::chrono::steady_clock::time_point& wakeAt);
+
+	static CCVideoDecodePool * s_instance;
+
+	std::mutex _mutex;
+	std::condition_variable _wakeUp;   // a job was added, or another runnable job is waiting
+	std::condition_variable _released; // a worker finished running a job
+	std::vector<Entry *> _entries;
+	size_t _cursor;
+	size_t _maxWorkers;
+	std::vector<std::thread> _workers; // started on demand, never more than jobs
+	bool _quit;
+};
+
+#endif /*_CC_VIDEO_DECODE_POOL_*/
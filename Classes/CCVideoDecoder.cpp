@@ -0,0 +1,328 @@
+#include "CCVideoDecoder.h"
+
+#include <algorithm>
+
+#if CC_USE_JPEG
+#include <setjmp.h>
+extern "C"
+{
+#include "jpeglib.h"
+}
+#endif // CC_USE_JPEG
+
+USING_NS_CC;
+
+static const size_t CCV_HEADER_SIZE = 32;
+static const size_t CCV_ENTRY_SIZE = 12;
+
+static uint16_t readU16(const unsigned char * p)
+{
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t readU32(const unsigned char * p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+#if CC_USE_JPEG
+namespace
+{
+	struct JpegErrorMgr
+	{
+		struct jpeg_error_mgr pub;
+		jmp_buf setjmpBuffer;
+	};
+
+	METHODDEF(void) jpegErrorExit(j_common_ptr cinfo)
+	{
+		char buffer[JMSG_LENGTH_MAX];
+		(*cinfo->err->format_message)(cinfo, buffer);
+		CCLOG("CCVideoDecoder: jpeg error: %s", buffer);
+		longjmp(((JpegErrorMgr *)cinfo->err)->setjmpBuffer, 1);
+	}
+
+	// Only the common 4:2:0 layout (what ffmpeg writes for yuvj420p) maps onto the YUV shader.
+	bool isYUV420(const jpeg_decompress_struct& cinfo)
+	{
+		return cinfo.num_components == 3 && cinfo.jpeg_color_space == JCS_YCbCr
+			&& cinfo.comp_info[0].h_samp_factor == 2 && cinfo.comp_info[0].v_samp_factor == 2
+			&& cinfo.comp_info[1].h_samp_factor == 1 && cinfo.comp_info[1].v_samp_factor == 1
+			&& cinfo.comp_info[2].h_samp_factor == 1 && cinfo.comp_info[2].v_samp_factor == 1;
+	}
+}
+#endif // CC_USE_JPEG
+
+//-------------------------------CCVideoDecoder----------------------------------------------//
+CCVideoDecoder::CCVideoDecoder()
+: _stream(nullptr)
+, _codec(CCVideoCodec::JPEG)
+, _width(0)
+, _height(0)
+, _frameDuration(0.0)
+, _outputYUV(true)
+{
+}
+
+CCVideoDecoder::~CCVideoDecoder()
+{
+	close();
+}
+
+bool CCVideoDecoder::open(const std::string& path)
+{
+	close();
+
+	std::string fullPath = CCVideoStream::fullPathForFilename(path);
+	if (fullPath.empty())
+	{
+		CCLOG("CCVideoDecoder: can't find %s", path.c_str());
+		return false;
+	}
+
+	CCVideoStream * stream = CCVideoStream::open(fullPath);
+	if (stream == nullptr)
+	{
+		CCLOG("CCVideoDecoder: can't open %s", fullPath.c_str());
+		return false;
+	}
+
+	if (!open(stream))
+	{
+		CCLOG("CCVideoDecoder: %s is not a valid CCV clip", fullPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool CCVideoDecoder::open(CCVideoStream * stream)
+{
+	close();
+	_stream.reset(stream);
+	if (!_stream || !readHeader())
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void CCVideoDecoder::close()
+{
+	_stream.reset();
+	_frames.clear();
+	_keyframes.clear();
+	_packet.clear();
+	_width = _height = 0;
+	_frameDuration = 0.0;
+}
+
+bool CCVideoDecoder::readHeader()
+{
+	unsigned char header[CCV_HEADER_SIZE];
+	if (!_stream->read(0, header, CCV_HEADER_SIZE) || memcmp(header, "CCVF", 4) != 0)
+	{
+		return false;
+	}
+
+	uint16_t version = readU16(header + 4);
+	uint16_t codec = readU16(header + 6);
+	_width = readU16(header + 8);
+	_height = readU16(header + 10);
+	uint32_t fpsNum = readU32(header + 12);
+	uint32_t fpsDen = readU32(header + 16);
+	uint32_t frameCount = readU32(header + 20);
+	uint32_t indexOffset = readU32(header + 24);
+
+	if (version != 1 || _width == 0 || _height == 0 || fpsNum == 0 || fpsDen == 0 || frameCount == 0)
+	{
+		return false;
+	}
+	if (codec != (uint16_t)CCVideoCodec::JPEG && codec != (uint16_t)CCVideoCodec::WEBP)
+	{
+		return false;
+	}
+	_codec = (CCVideoCodec)codec;
+	_frameDuration = (double)fpsDen / fpsNum;
+
+	// a broken header must not make us allocate a huge table.
+	if ((uint64_t)indexOffset + (uint64_t)frameCount * CCV_ENTRY_SIZE > _stream->getSize())
+	{
+		return false;
+	}
+	std::vector<unsigned char> table(frameCount * CCV_ENTRY_SIZE);
+	if (!_stream->read(indexOffset, table.data(), table.size()))
+	{
+		return false;
+	}
+
+	_frames.resize(frameCount);
+	for (uint32_t i = 0; i < frameCount; ++i)
+	{
+		const unsigned char * entry = table.data() + i * CCV_ENTRY_SIZE;
+		_frames[i].offset = readU32(entry);
+		_frames[i].size = readU32(entry + 4);
+		_frames[i].flags = readU32(entry + 8);
+		if (_frames[i].flags & FRAME_FLAG_KEYFRAME)
+		{
+			_keyframes.push_back((int)i);
+		}
+	}
+	return true;
+}
+
+int CCVideoDecoder::getFrameIndex(double seconds) const
+{
+	if (_frames.empty() || seconds <= 0.0)
+	{
+		return 0;
+	}
+	// a small epsilon so a time computed as index * duration maps back onto index.
+	int index = (int)(seconds / _frameDuration + 1e-6);
+	return std::min(index, (int)_frames.size() - 1);
+}
+
+int CCVideoDecoder::findKeyframe(int index) const
+{
+	auto it = std::upper_bound(_keyframes.begin(), _keyframes.end(), index);
+	return it == _keyframes.begin() ? 0 : *(it - 1);
+}
+
+bool CCVideoDecoder::readPacket(int index)
+{
+	const FrameEntry& entry = _frames[index];
+	_packet.resize(entry.size);
+	return _stream->read(entry.offset, _packet.data(), entry.size);
+}
+
+bool CCVideoDecoder::decodeFrame(int index, CCVideoFrame& frame)
+{
+	if (!_stream || index < 0 || index >= (int)_frames.size())
+	{
+		return false;
+	}
+	if (!readPacket(index))
+	{
+		CCLOG("CCVideoDecoder: failed to read frame %d", index);
+		return false;
+	}
+
+	bool ret = (_codec == CCVideoCodec::JPEG && _outputYUV && decodeJpegYUV(frame)) || decodeImage(frame);
+	if (ret)
+	{
+		frame.index = index;
+		frame.pts = index * _frameDuration;
+	}
+	else
+	{
+		CCLOG("CCVideoDecoder: failed to decode frame %d", index);
+	}
+	return ret;
+}
+
+bool CCVideoDecoder::decodeImage(CCVideoFrame& frame)
+{
+	// Image picks libjpeg or libwebp from the payload signature.
+	Image * image = new (std::nothrow) Image();
+	bool ret = image && image->initWithImageData(_packet.data(), _packet.size());
+	if (ret)
+	{
+		frame.width = frame.visibleWidth = image->getWidth();
+		frame.height = frame.visibleHeight = image->getHeight();
+		frame.format = image->getRenderFormat();
+		frame.planar = false;
+		frame.chromaWidth = frame.chromaHeight = 0;
+		frame.data.assign(image->getData(), image->getData() + image->getDataLen());
+	}
+	CC_SAFE_RELEASE(image);
+	return ret;
+}
+
+bool CCVideoDecoder::decodeJpegYUV(CCVideoFrame& frame)
+{
+#if CC_USE_JPEG
+	struct jpeg_decompress_struct cinfo;
+	JpegErrorMgr jerr;
+	cinfo.err = jpeg_std_error(&jerr.pub);
+	jerr.pub.error_exit = jpegErrorExit;
+	if (setjmp(jerr.setjmpBuffer))
+	{
+		jpeg_destroy_decompress(&cinfo);
+		return false;
+	}
+
+	jpeg_create_decompress(&cinfo);
+	jpeg_mem_src(&cinfo, _packet.data(), (unsigned long)_packet.size());
+	jpeg_read_header(&cinfo, TRUE);
+	if (!isYUV420(cinfo))
+	{
+		jpeg_destroy_decompress(&cinfo);
+		return false;
+	}
+
+	cinfo.raw_data_out = TRUE;
+	cinfo.do_fancy_upsampling = FALSE; // otherwise libjpeg 9 upsamples chroma through IDCT scaling
+	cinfo.dct_method = JDCT_IFAST;
+	jpeg_start_decompress(&cinfo);
+
+	// libjpeg writes whole MCUs, so the planes are padded to the MCU grid and the padding is
+	// cropped by the sprite's texture rect instead of being copied out on the CPU.
+	const jpeg_component_info& luma = cinfo.comp_info[0];
+	const jpeg_component_info& chroma = cinfo.comp_info[1];
+	const int lumaRows = luma.v_samp_factor * luma.DCT_v_scaled_size;       // rows per iMCU row
+	const int chromaRows = chroma.v_samp_factor * chroma.DCT_v_scaled_size;
+	if (lumaRows > 2 * DCTSIZE || chromaRows > DCTSIZE)
+	{
+		jpeg_destroy_decompress(&cinfo);
+		return false;
+	}
+
+	frame.width = luma.MCU_sample_width * cinfo.MCUs_per_row;
+	frame.height = lumaRows * cinfo.total_iMCU_rows;
+	frame.chromaWidth = chroma.MCU_sample_width * cinfo.MCUs_per_row;
+	frame.chromaHeight = chromaRows * cinfo.total_iMCU_rows;
+	frame.visibleWidth = cinfo.output_width;
+	frame.visibleHeight = cinfo.output_height;
+	frame.format = Texture2D::PixelFormat::I8;
+	frame.planar = true;
+	frame.data.resize(frame.width * frame.height + 2 * frame.chromaWidth * frame.chromaHeight);
+
+	// no heap objects below this point, a libjpeg error longjmps back to the setjmp above.
+	JSAMPROW rows[4 * DCTSIZE];
+	JSAMPARRAY planes[3] = { rows, rows + lumaRows, rows + lumaRows + chromaRows };
+	unsigned char * y = frame.data.data();
+	unsigned char * u = const_cast<unsigned char *>(frame.planeU());
+	unsigned char * v = const_cast<unsigned char *>(frame.planeV());
+
+	JDIMENSION mcuRow = 0;
+	for (; mcuRow < cinfo.total_iMCU_rows; ++mcuRow)
+	{
+		for (int i = 0; i < lumaRows; ++i)
+		{
+			planes[0][i] = y + (mcuRow * lumaRows + i) * frame.width;
+		}
+		for (int i = 0; i < chromaRows; ++i)
+		{
+			planes[1][i] = u + (mcuRow * chromaRows + i) * frame.chromaWidth;
+			planes[2][i] = v + (mcuRow * chromaRows + i) * frame.chromaWidth;
+		}
+		if (jpeg_read_raw_data(&cinfo, planes, lumaRows) == 0)
+		{
+			break;
+		}
+	}
+
+	// a truncated or corrupt payload decodes as far as it goes, libjpeg only warns and pads the rest,
+	// so a missing row or any warning drops the frame instead of showing a half grey picture.
+	bool ret = mcuRow == cinfo.total_iMCU_rows && cinfo.err->num_warnings == 0;
+	if (ret)
+	{
+		jpeg_finish_decompress(&cinfo);
+		ret = cinfo.err->num_warnings == 0;
+	}
+	jpeg_destroy_decompress(&cinfo);
+	return ret;
+#else
+	return false;
+#endif // CC_USE_JPEG
+}
@@ -0,0 +1,128 @@
+#ifndef _CC_VIDEO_DECODER_
+#define _CC_VIDEO_DECODER_
+
+#include "cocos2d.h"
+#include "CCVideoStream.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// CCV is the self-contained clip format read by the portable (texture) video backend.
+// It is a plain sequence of intra-coded frames (JPEG or WebP) behind a frame table, so it
+// can be decoded with the image codecs cocos2d already ships in external/.
+// Use tools/ccvpack.py to build a .ccv file from a folder of frames.
+//
+// Layout (all integers little-endian):
+//   char   magic[4]      "CCVF"
+//   uint16 version       1
+//   uint16 codec         CCVideoCodec
+//   uint16 width
+//   uint16 height
+//   uint32 fpsNum
+//   uint32 fpsDen
+//   uint32 frameCount
+//   uint32 indexOffset   byte offset of the frame table
+//   uint32 reserved
+//   frameCount x { uint32 offset; uint32 size; uint32 flags; }
+//   frame payloads
+//
+// Every payload is intra coded, so any frame decodes on its own and seeking is a table lookup.
+// FRAME_FLAG_KEYFRAME marks the seek points (e.g. chapter starts of a branching cut scene),
+// ccvpack.py flags every frame unless told otherwise.
+
+enum class CCVideoCodec : uint16_t
+{
+	JPEG = 1,
+	WEBP = 2
+};
+
+// One decoded picture, ready to be uploaded into a Texture2D.
+// Packed frames hold RGB888/RGBA8888 pixels. Planar frames hold YUV 4:2:0, the Y plane followed
+// by the U and V planes, each uploaded as an I8 texture and converted to RGB by the
+// GLProgram::SHADER_NAME_POSITION_TEXTURE_YUV_NO_MVP shader.
+struct CCVideoFrame
+{
+	int index = -1;         // position of the frame in the clip
+	double pts = 0.0;       // presentation time in seconds
+	int width = 0;          // size of the (luma) texture, may be padded to whole JPEG blocks
+	int height = 0;
+	int visibleWidth = 0;   // size of the picture inside the texture
+	int visibleHeight = 0;
+	cocos2d::Texture2D::PixelFormat format = cocos2d::Texture2D::PixelFormat::NONE;
+	bool planar = false;
+	int chromaWidth = 0;    // size of the U and V planes of a planar frame
+	int chromaHeight = 0;
+	long long decodeMicros = 0; // time spent in CCVideoDecoder::decodeFrame
+	std::vector<unsigned char> data;
+
+	const unsigned char * planeY() const { return data.data(); }
+	const unsigned char * planeU() const { return data.data() + width * height; }
+	const unsigned char * planeV() const { return planeU() + chromaWidth * chromaHeight; }
+};
+
+class CCVideoDecoder
+{
+public:
+
+	static const uint32_t FRAME_FLAG_KEYFRAME = 0x1;
+
+	struct FrameEntry
+	{
+		uint32_t offset;
+		uint32_t size;
+		uint32_t flags;
+	};
+
+	CCVideoDecoder();
+	~CCVideoDecoder();
+
+	// Parses the header and the frame table. Paths are resolved like CCVideoStream::fullPathForFilename,
+	// so a clip can also be an entry of a zip archive ("pack.zip#intro.ccv").
+	bool open(const std::string& path);
+	// Same with a stream of the caller, e.g. CCVideoStream::createWithData. The decoder owns it, even on failure.
+	bool open(CCVideoStream * stream);
+	void close();
+	bool isOpen() const { return _stream != nullptr; }
+
+	// Reads and decodes the frame at index. Not thread safe, call it from one thread at a time.
+	bool decodeFrame(int index, CCVideoFrame& frame);
+
+	// Frame shown at the given time, clamped to the clip.
+	int getFrameIndex(double seconds) const;
+	// Closest keyframe at or before index, from the keyframe index built by open(). 0 if none is flagged.
+	int findKeyframe(int index) const;
+	bool isKeyframe(int index) const { return index >= 0 && index < (int)_frames.size() && (_frames[index].flags & FRAME_FLAG_KEYFRAME); }
+
+	// When enabled (the default) 4:2:0 JPEG frames are returned as planar YUV straight out of libjpeg,
+	// skipping the CPU color conversion and halving the texture upload. Other frames are always packed RGB(A).
+	void setOutputYUV(bool outputYUV) { _outputYUV = outputYUV; }
+	bool isOutputYUV() const { return _outputYUV; }
+
+	CCVideoCodec getCodec() const { return _codec; }
+	int getWidth() const { return _width; }
+	int getHeight() const { return _height; }
+	int getFrameCount() const { return (int)_frames.size(); }
+	double getFrameDuration() const { return _frameDuration; }
+	double getDuration() const { return _frameDuration * _frames.size(); }
+
+private:
+
+	bool readHeader();
+	bool readPacket(int index);
+	bool decodeImage(CCVideoFrame& frame);
+	bool decodeJpegYUV(CCVideoFrame& frame);
+
+	std::unique_ptr<CCVideoStream> _stream; // only the frame table and one payload are read into memory
+	CCVideoCodec _codec;
+	int _width;
+	int _height;
+	double _frameDuration;
+	bool _outputYUV;
+	std::vector<FrameEntry> _frames;
+	std::vector<int> _keyframes; // sorted indices of the keyframes
+	std::vector<unsigned char> _packet; // compressed payload, reused between frames
+};
+
+#endif /*_CC_VIDEO_DECODER_*/
@@ -0,0 +1,125 @@
+#ifndef _CC_VIDEO_FRAME_QUEUE_
+#define _CC_VIDEO_FRAME_QUEUE_
+
+#include "CCVideoDecoder.h"
+
+#include <atomic>
+#include <vector>
+
+// Bounded single-producer/single-consumer ring of decoded frames.
+// The decode thread fills slots in place (frame buffers are reused, nothing is allocated
+// once the ring is warm) and the cocos thread presents them, neither side ever takes a lock.
+class CCVideoFrameQueue
+{
+public:
+
+	explicit CCVideoFrameQueue(size_t capacity)
+	: _slots(capacity + 1) // one slot stays empty to tell a full ring from an empty one
+	, _head(0)
+	, _tail(0)
+	{
+	}
+
+	// Producer side. Returns the slot to decode into, or nullptr if the ring is full.
+	CCVideoFrame * beginWrite()
+	{
+		size_t tail = _tail.load(std::memory_order_relaxed);
+		if (next(tail) == _head.load(std::memory_order_acquire))
+		{
+			return nullptr;
+		}
+		return &_slots[tail];
+	}
+
+	// Producer side. Publishes the slot returned by beginWrite.
+	void commitWrite()
+	{
+		size_t tail = _tail.load(std::memory_order_relaxed);
+		_tail.store(next(tail), std::memory_order_release);
+	}
+
+	// Consumer side. Returns the oldest frame, or nullptr if the ring is empty.
+	CCVideoFrame * front()
+	{
+		size_t head = _head.load(std::memory_order_relaxed);
+		if (head == _tail.load(std::memory_order_acquire))
+		{
+			return nullptr;
+		}
+		return &_slots[head];
+	}
+
+	// Consumer side. Hands the oldest slot back to the producer.
+	void pop()
+	{
+		size_t head = _head.load(std::memory_order_relaxed);
+		_head.store(next(head), std::memory_order_release);
+	}
+
+	// Consumer side. Returns the frame queued after front(), or nullptr if there is none yet.
+	CCVideoFrame * second()
+	{
+		size_t head = _head.load(std::memory_order_relaxed);
+		size_t tail = _tail.load(std::memory_order_acquire);
+		if (head == tail || next(head) == tail)
+		{
+			return nullptr;
+		}
+		return &_slots[next(head)];
+	}
+
+	bool empty() const
+	{
+		return _head.load(std::memory_order_relaxed) == _tail.load(std::memory_order_acquire);
+	}
+
+	size_t capacity() const { return _slots.size() - 1; }
+
+	// The calls below are only valid while neither side is running, e.g. after the decode thread was joined.
+	void clear()
+	{
+		_head.store(0, std::memory_order_relaxed);
+		_tail.store(0, std::memory_order_relaxed);
+	}
+
+	// Empties the ring and sets its capacity, frame buffers are kept for reuse.
+	void reset(size_t capacity)
+	{
+		clear();
+		_slots.resize(capacity + 1);
+	}
+
+	// Empties the ring and frees the frame buffers.
+	void releaseMemory()
+	{
+		clear();
+		for (auto& slot : _slots)
+		{
+			std::vector<unsigned char>().swap(slot.data);
+		}
+	}
+
+	// Bytes allocated for frame buffers.
+	size_t getMemoryUsage() const
+	{
+		size_t bytes = 0;
+		for (const auto& slot : _slots)
+		{
+			bytes += slot.data.capacity();
+		}
+		return bytes;
+	}
+
+private:
+
+	size_t next(size_t index) const
+	{
+		return (index + 1) % _slots.size();
+	}
+
+	std::vector<CCVideoFrame> _slots;
+	std::atomic<size_t> _head; // next slot to present, written by the consumer
+	std::atomic<size_t> _tail; // next slot to decode into, written by the producer
+};
+
+#endif /*_CC_VIDEO_FRAME_QUEUE_*/
@@ -1,4 +1,7 @@
 #include "CCVideoManager.h"
+#if CC_VIDEO_TEXTURE_BACKEND
+#include "CCVideoDecodePool.h"
+#endif
 #include "cocos2d.h"
 
 USING_NS_CC;
@@ -21,18 +24,316 @@ CCVideoManager::CCVideoManager() {}
 
 void CCVideoManager::DestroyInstance()
 {
-	
+	delete m_instance;
 	m_instance = nullptr;
 }
 
 CCVideoManager::~CCVideoManager()
 {
-	
+#if CC_VIDEO_TEXTURE_BACKEND
+	StopAll();
+	CCVideoDecodePool::destroyInstance();
+#else
 	_pPlayer = nullptr;
+#endif
+}
+
+
+#if CC_VIDEO_TEXTURE_BACKEND
+
+static const std::string ATTACH_SCHEDULE_KEY = "CCVideoManager::AttachToRunningScene";
+
+int CCVideoManager::PlayVideo(std::string path, bool looping)
+{
+	//the clip is opened in the background too, so the caller's frame doesn't hitch.
+	int handle = PreloadVideo(path, 1);
+	SetLooping(handle, looping);
+	PlayPreloaded(handle);
+	return handle;
+}
+
+int CCVideoManager::PreloadVideo(std::string path, int prebufferFrames)
+{
+	auto player = CCVideoPlayer::createAsync(path, prebufferFrames, nullptr);
+	if (player == nullptr)
+	{
+		return 0;
+	}
+	int handle = _nextHandle++;
+	player->retain();
+	player->setStateCallback([handle](CCVideoPlayer *, CCVideoPlayer::State state) {
+		//the manager may have been destroyed while the clip was loading.
+		if (m_instance)
+		{
+			m_instance->OnPlayerStateChanged(handle, state);
+		}
+	});
+	_instances[handle] = VideoInstance{ player, nullptr, false };
+	return handle;
+}
+
+bool CCVideoManager::PlayPreloaded(int handle)
+{
+	auto it = _instances.find(handle);
+	if (it == _instances.end() || it->second.started)
+	{
+		return false;
+	}
+	it->second.started = true;
+	it->second.player->play(); //deferred by the player until the load is done.
+	AttachToRunningScene();
+	return true;
+}
+
+bool CCVideoManager::IsPreloaded(int handle) const
+{
+	auto it = _instances.find(handle);
+	return it != _instances.end() && !it->second.started && it->second.player->getState() == CCVideoPlayer::State::Ready;
+}
+
+void CCVideoManager::CancelPreload(int handle)
+{
+	auto it = _instances.find(handle);
+	if (it != _instances.end() && !it->second.started)
+	{
+		RemoveInstance(handle);
+	}
+}
+
+void CCVideoManager::PurgePreloaded()
+{
+	std::vector<int> handles;
+	for (const auto& entry : _instances)
+	{
+		if (!entry.second.started)
+		{
+			handles.push_back(entry.first);
+		}
+	}
+	for (int handle : handles)
+	{
+		RemoveInstance(handle);
+	}
+}
+
+void CCVideoManager::SetPreloadMemoryBudget(size_t bytes)
+{
+	_preloadMemoryBudget = bytes;
+	EvictPreloaded();
+}
+
+size_t CCVideoManager::GetPreloadedMemory() const
+{
+	size_t bytes = 0;
+	for (const auto& entry : _instances)
+	{
+		//frames of a clip still loading are being written by the IO thread, they are counted once it is done.
+		if (!entry.second.started && entry.second.player->getState() == CCVideoPlayer::State::Ready)
+		{
+			bytes += entry.second.player->getBufferedMemory();
+		}
+	}
+	return bytes;
+}
+
+void CCVideoManager::EvictPreloaded()
+{
+	if (_preloadMemoryBudget == 0)
+	{
+		return;
+	}
+	size_t bytes = GetPreloadedMemory();
+	std::vector<int> evicted;
+	for (const auto& entry : _instances)
+	{
+		if (bytes <= _preloadMemoryBudget)
+		{
+			break;
+		}
+		if (!entry.second.started && entry.second.player->getState() == CCVideoPlayer::State::Ready)
+		{
+			CCLOG("CCVideoManager: evicting preloaded clip %d", entry.first);
+			bytes -= entry.second.player->getBufferedMemory();
+			evicted.push_back(entry.first);
+		}
+	}
+	for (int handle : evicted)
+	{
+		RemoveInstance(handle);
+	}
+}
+
+void CCVideoManager::SetStateCallback(int handle, const StateCallback& callback)
+{
+	auto it = _instances.find(handle);
+	if (it != _instances.end())
+	{
+		it->second.callback = callback;
+	}
+}
+
+void CCVideoManager::SetLooping(int handle, bool looping)
+{
+	if (auto player = GetPlayer(handle))
+	{
+		player->setLooping(looping);
+	}
+}
+
+void CCVideoManager::PauseVideo(int handle)
+{
+	if (auto player = GetPlayer(handle))
+	{
+		player->pause();
+	}
+}
+
+void CCVideoManager::ResumeVideo(int handle)
+{
+	auto it = _instances.find(handle);
+	if (it != _instances.end() && it->second.started && it->second.player->getState() == CCVideoPlayer::State::Paused)
+	{
+		it->second.player->play();
+	}
+}
+
+bool CCVideoManager::SeekVideo(int handle, double seconds, bool toKeyframe)
+{
+	auto player = GetPlayer(handle);
+	return player && player->seek(seconds, toKeyframe);
+}
+
+void CCVideoManager::SyncToAudio(int handle, int audioID, double offset)
+{
+	if (auto player = GetPlayer(handle))
+	{
+		player->setMasterClock(audioID >= 0 ? CCVideoAudioClock::create(audioID, offset) : nullptr);
+	}
+}
+
+void CCVideoManager::StopVideo(int handle)
+{
+	RemoveInstance(handle);
+}
+
+void CCVideoManager::StopAll()
+{
+	while (!_instances.empty())
+	{
+		RemoveInstance(_instances.begin()->first);
+	}
+}
+
+CCVideoPlayer * CCVideoManager::GetPlayer(int handle) const
+{
+	auto it = _instances.find(handle);
+	return it != _instances.end() ? it->second.player : nullptr;
+}
+
+void CCVideoManager::AttachToRunningScene()
+{
+	auto director = Director::getInstance();
+	auto scheduler = director->getScheduler();
+	auto scene = director->getRunningScene();
+	if (scene == nullptr)
+	{
+		//PlayVideo is usually called while the first scene is built, wait until the director runs it.
+		if (!scheduler->isScheduled(ATTACH_SCHEDULE_KEY, this))
+		{
+			scheduler->schedule([this](float) { AttachToRunningScene(); }, this, 0, false, ATTACH_SCHEDULE_KEY);
+		}
+		return;
+	}
+	scheduler->unschedule(ATTACH_SCHEDULE_KEY, this);
+
+	Size visibleSize = director->getVisibleSize();
+	Vec2 origin = director->getVisibleOrigin();
+	for (const auto& entry : _instances)
+	{
+		//the sprite is sized from the clip, OnPlayerStateChanged attaches it once the clip is loaded.
+		CCVideoPlayer * player = entry.second.player;
+		Sprite * sprite = player->getSprite();
+		if (!entry.second.started || player->getState() == CCVideoPlayer::State::Loading || sprite->getParent())
+		{
+			continue;
+		}
+
+		//fit the video into the visible area, keeping its aspect ratio. Later clips are drawn on top.
+		Size videoSize = player->getVideoSize();
+		sprite->setScale(std::min(visibleSize.width / videoSize.width, visibleSize.height / videoSize.height));
+		sprite->setPosition(Vec2(origin.x + visibleSize.width / 2, origin.y + visibleSize.height / 2));
+		scene->addChild(sprite, INT_MAX);
+	}
+}
+
+void CCVideoManager::OnPlayerStateChanged(int handle, CCVideoPlayer::State state)
+{
+	auto it = _instances.find(handle);
+	if (it == _instances.end())
+	{
+		return;
+	}
+	//copied, the callback may stop the instance.
+	StateCallback callback = it->second.callback;
+	bool started = it->second.started;
+
+	switch (state)
+	{
+	case CCVideoPlayer::State::Ready:
+		if (started)
+		{
+			AttachToRunningScene(); //a clip started while loading, the player starts it right after this.
+		}
+		else
+		{
+			EvictPreloaded();
+		}
+		break;
+	case CCVideoPlayer::State::Finished:
+	case CCVideoPlayer::State::Closed:
+		RemoveInstance(handle);
+		return; //RemoveInstance reports the final state.
+	default:
+		break;
+	}
+
+	if (callback)
+	{
+		callback(handle, state);
+	}
+}
+
+void CCVideoManager::RemoveInstance(int handle)
+{
+	auto it = _instances.find(handle);
+	if (it == _instances.end())
+	{
+		return;
+	}
+	VideoInstance instance = it->second;
+	_instances.erase(it);
+
+	CCVideoPlayer * player = instance.player;
+	CCVideoPlayer::State finalState = player->getState() == CCVideoPlayer::State::Finished ? CCVideoPlayer::State::Finished : CCVideoPlayer::State::Closed;
+	player->setStateCallback(nullptr);
+	player->getSprite()->removeFromParent();
+	//a pending load holds its own reference, it ends early and frees the player when it is done.
+	player->stop();
+	//the player may be running its own update, so it is released at the end of the frame.
+	player->autorelease();
+
+	if (_instances.empty())
+	{
+		Director::getInstance()->getScheduler()->unschedule(ATTACH_SCHEDULE_KEY, this);
+	}
+	if (instance.callback)
+	{
+		instance.callback(handle, finalState);
+	}
 }
 
 
-#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
 
 LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
@@ -3,7 +3,92 @@
 
 #include "CCMediaPlayer.h"
 
-#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+// The texture backend decodes CCV clips (see CCVideoDecoder.h) and draws them with a Sprite inside the scene.
+// It is the only backend on platforms without Media Foundation, Win32 can opt in by defining CC_VIDEO_TEXTURE_BACKEND=1.
+#ifndef CC_VIDEO_TEXTURE_BACKEND
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+#define CC_VIDEO_TEXTURE_BACKEND 0
+#else
+#define CC_VIDEO_TEXTURE_BACKEND 1
+#endif
+#endif
+
+#if CC_VIDEO_TEXTURE_BACKEND
+
+#include "CCVideoPlayer.h"
+
+#include <functional>
+#include <map>
+
+// Any number of clips can play at once, each one is an instance identified by the handle
+// returned by PlayVideo or PreloadVideo. Frames of all instances are decoded by the shared
+// CCVideoDecodePool workers.
+class CCVideoManager
+{
+
+public:
+
+	typedef std::function<void(int handle, CCVideoPlayer::State state)> StateCallback;
+
+private:
+
+	struct VideoInstance
+	{
+		CCVideoPlayer * player; //retained by the manager
+		StateCallback callback;
+		bool started; //PlayPreloaded was called, a preload that isn't started can be evicted.
+	};
+
+	std::map<int, VideoInstance> _instances; //handles grow, so the map is ordered oldest first.
+	int _nextHandle = 1;
+	size_t _preloadMemoryBudget = 0; //bytes of prebuffered frames kept around, 0 means unlimited.
+	static CCVideoManager * m_instance; //the singleton instance we will use for this class.
+	CCVideoManager();//default constructor is private to prevent access
+	CCVideoManager(CCVideoManager const &); // copy constructor is also private.
+	CCVideoManager & operator = (const CCVideoManager&); // so as the assignment operator is also private
+
+	void AttachToRunningScene(); // adds the started videos on top of the running scene.
+	void OnPlayerStateChanged(int handle, CCVideoPlayer::State state);
+	void RemoveInstance(int handle); // removes the video from the view and releases its player.
+	void EvictPreloaded(); // drops the oldest preloaded clips until the budget is met.
+
+public:
+
+	static void DestroyInstance();
+
+	static CCVideoManager * Instance(); // this is what we will be calling when create a CVideoManager object.
+
+	//plays a clip on top of the running scene, it is removed once it finishes. Returns its handle, 0 if the file is missing.
+	int PlayVideo(std::string path, bool looping = false);
+
+	static const int DEFAULT_PREBUFFER_FRAMES = 8;
+
+	//opens the clip and decodes its first frames in the background, returns a handle for PlayPreloaded or 0 if the file is missing.
+	int PreloadVideo(std::string path, int prebufferFrames = DEFAULT_PREBUFFER_FRAMES);
+	//plays a preloaded clip, it starts on the next frame if it is loaded, as soon as it is otherwise.
+	bool PlayPreloaded(int handle);
+	bool IsPreloaded(int handle) const; //true once the clip is loaded and ready to play.
+	void CancelPreload(int handle); //stops the load or frees the prebuffered frames.
+	void PurgePreloaded(); //cancels every preload that wasn't started, call it on memory warnings.
+	void SetPreloadMemoryBudget(size_t bytes); //oldest preloads are evicted when the prebuffered frames use more than that.
+	size_t GetPreloadedMemory() const;
+
+	//per instance control, unknown handles are ignored.
+	void SetStateCallback(int handle, const StateCallback& callback); //called on the cocos thread, Finished and Closed are the last calls.
+	void SetLooping(int handle, bool looping);
+	void PauseVideo(int handle);
+	void ResumeVideo(int handle);
+	bool SeekVideo(int handle, double seconds, bool toKeyframe = false); //see CCVideoPlayer::seek.
+	//paces the video by the position of an AudioEngine sound, e.g. its soundtrack started with play2d. INVALID_AUDIO_ID unlinks it.
+	void SyncToAudio(int handle, int audioID, double offset = 0.0);
+	void StopVideo(int handle); //removes the instance, its callback gets Closed.
+	void StopAll();
+	CCVideoPlayer * GetPlayer(int handle) const; //e.g. to move the sprite, nullptr for unknown handles.
+
+	~CCVideoManager();
+};
+
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
 
 
 #define IDD_MFPLAYBACK_DIALOG           102
@@ -0,0 +1,564 @@
+#include "CCVideoPlayer.h"
+#include "CCVideoDecodePool.h"
+
+#include <chrono>
+
+USING_NS_CC;
+
+// Uploads one plane, (re)creating the texture when the frame layout changed. Returns true if the texture was created.
+static bool uploadTexture(Texture2D *& texture, const unsigned char * data, ssize_t dataLen, Texture2D::PixelFormat format, int width, int height)
+{
+	if (texture && texture->getPixelsWide() == width && texture->getPixelsHigh() == height && texture->getPixelFormat() == format)
+	{
+		// rows are tightly packed, RGB888 and I8 rows are not always 4 byte aligned.
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		texture->updateWithData(data, 0, 0, width, height);
+		return false;
+	}
+
+	CC_SAFE_RELEASE(texture);
+	texture = new (std::nothrow) Texture2D();
+	if (texture && texture->initWithData(data, dataLen, format, width, height, Size((float)width, (float)height)))
+	{
+		return true;
+	}
+	CC_SAFE_RELEASE_NULL(texture);
+	return false;
+}
+
+//-------------------------------CCVideoPlayer----------------------------------------------//
+const size_t CCVideoPlayer::MAX_QUEUED_FRAMES;
+
+CCVideoPlayer * CCVideoPlayer::create(const std::string& path)
+{
+	CCVideoPlayer * player = new (std::nothrow) CCVideoPlayer();
+	if (player && player->init(path))
+	{
+		player->autorelease();
+		return player;
+	}
+	CC_SAFE_DELETE(player);
+	return nullptr;
+}
+
+CCVideoPlayer * CCVideoPlayer::createWithData(Data data)
+{
+	CCVideoPlayer * player = new (std::nothrow) CCVideoPlayer();
+	if (player && player->initWithStream(CCVideoStream::createWithData(std::move(data))))
+	{
+		player->autorelease();
+		return player;
+	}
+	CC_SAFE_DELETE(player);
+	return nullptr;
+}
+
+CCVideoPlayer * CCVideoPlayer::createAsync(const std::string& path, int prebufferFrames, const LoadedCallback& callback)
+{
+	// FileUtils isn't thread safe, the stream is opened here and the IO thread only reads the clip from it.
+	std::string fullPath = CCVideoStream::fullPathForFilename(path);
+	if (fullPath.empty())
+	{
+		CCLOG("CCVideoPlayer: can't find %s", path.c_str());
+		return nullptr;
+	}
+	CCVideoStream * stream = CCVideoStream::open(fullPath);
+	if (stream == nullptr)
+	{
+		CCLOG("CCVideoPlayer: can't open %s", fullPath.c_str());
+		return nullptr;
+	}
+
+	CCVideoPlayer * player = new (std::nothrow) CCVideoPlayer();
+	if (player == nullptr)
+	{
+		delete stream;
+		return nullptr;
+	}
+	player->autorelease();
+	player->initSprite();
+	player->setState(State::Loading);
+
+	// the pending task keeps the player alive, it is released once the loaded callback ran.
+	player->retain();
+	AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO,
+		[player, callback](void *) {
+			player->onLoaded(callback);
+			player->release();
+		},
+		nullptr,
+		[player, stream, prebufferFrames]() { player->prebuffer(stream, prebufferFrames); });
+	return player;
+}
+
+CCVideoPlayer::CCVideoPlayer()
+: _duration(0.0)
+, _state(State::Closed)
+, _looping(false)
+, _decoding(false)
+, _frameQueue(MAX_QUEUED_FRAMES)
+, _stopRequested(false)
+, _endOfStream(false)
+, _nextDecodeIndex(0)
+, _ptsOffset(0.0)
+, _loadFailed(false)
+, _playRequested(false)
+, _playbackTime(0.0)
+, _clockStarted(false)
+, _texture(nullptr)
+, _textureU(nullptr)
+, _textureV(nullptr)
+, _textureGeneration(0)
+, _planar(false)
+, _sprite(nullptr)
+, _masterClock(nullptr)
+{
+}
+
+CCVideoPlayer::~CCVideoPlayer()
+{
+	stopDecoding();
+	Director::getInstance()->getScheduler()->unscheduleUpdate(this);
+	CC_SAFE_RELEASE(_sprite);
+	CC_SAFE_RELEASE(_texture);
+	CC_SAFE_RELEASE(_textureU);
+	CC_SAFE_RELEASE(_textureV);
+	CC_SAFE_RELEASE(_masterClock);
+}
+
+void CCVideoPlayer::setMasterClock(CCVideoClock * clock)
+{
+	CC_SAFE_RETAIN(clock);
+	CC_SAFE_RELEASE(_masterClock);
+	_masterClock = clock;
+}
+
+bool CCVideoPlayer::init(const std::string& path)
+{
+	if (!_decoder.open(path))
+	{
+		return false;
+	}
+	_videoSize = Size((float)_decoder.getWidth(), (float)_decoder.getHeight());
+	_duration = _decoder.getDuration();
+	initSprite();
+	setState(State::Ready);
+	return true;
+}
+
+bool CCVideoPlayer::initWithStream(CCVideoStream * stream)
+{
+	if (!_decoder.open(stream))
+	{
+		return false;
+	}
+	_videoSize = Size((float)_decoder.getWidth(), (float)_decoder.getHeight());
+	_duration = _decoder.getDuration();
+	initSprite();
+	setState(State::Ready);
+	return true;
+}
+
+void CCVideoPlayer::setState(State state)
+{
+	if (_state == state)
+	{
+		return;
+	}
+	_state = state;
+	if (_stateCallback)
+	{
+		// the callback may replace or clear itself (CCVideoManager does when a clip ends), so a copy is called.
+		StateCallback callback = _stateCallback;
+		callback(this, state);
+	}
+}
+
+void CCVideoPlayer::initSprite()
+{
+	_sprite = Sprite::create();
+	_sprite->retain();
+	_sprite->setVisible(false); // nothing to show until the first frame is uploaded
+}
+
+void CCVideoPlayer::prebuffer(CCVideoStream * stream, int frames)
+{
+	if (_stopRequested)
+	{
+		delete stream;
+		_loadFailed = true;
+		return;
+	}
+	if (!_decoder.open(stream))
+	{
+		CCLOG("CCVideoPlayer: not a valid CCV clip");
+		_loadFailed = true;
+		return;
+	}
+
+	// the ring grows to hold the whole prebuffer, playback then starts with a full queue.
+	_frameQueue.reset(std::max(MAX_QUEUED_FRAMES, (size_t)std::max(frames, 0)));
+	for (int i = 0; i < frames && !_stopRequested; ++i)
+	{
+		if (decodeNextFrame() != DecodeResult::Decoded)
+		{
+			break;
+		}
+	}
+}
+
+void CCVideoPlayer::onLoaded(const LoadedCallback& callback)
+{
+	bool loaded = !_loadFailed && !_stopRequested;
+	if (loaded)
+	{
+		_videoSize = Size((float)_decoder.getWidth(), (float)_decoder.getHeight());
+		_duration = _decoder.getDuration();
+	}
+	else
+	{
+		_decoder.close();
+		_frameQueue.releaseMemory();
+	}
+	setState(loaded ? State::Ready : State::Closed);
+
+	if (callback)
+	{
+		callback(this, loaded);
+	}
+	if (_playRequested && _state == State::Ready)
+	{
+		_playRequested = false;
+		play();
+	}
+}
+
+void CCVideoPlayer::cancelLoading()
+{
+	if (_state == State::Loading)
+	{
+		_stopRequested = true;
+		_playRequested = false;
+	}
+}
+
+void CCVideoPlayer::play()
+{
+	switch (_state)
+	{
+	case State::Loading:
+		_playRequested = true;
+		break;
+	case State::Ready:
+		startDecoding();
+		Director::getInstance()->getScheduler()->scheduleUpdate(this, 0, false);
+		setState(State::Playing);
+		break;
+	case State::Paused:
+		setState(State::Playing);
+		break;
+	case State::Finished:
+		stop();
+		play();
+		break;
+	default:
+		break;
+	}
+}
+
+void CCVideoPlayer::pause()
+{
+	if (_state == State::Playing)
+	{
+		setState(State::Paused);
+	}
+}
+
+void CCVideoPlayer::stop()
+{
+	if (_state == State::Loading)
+	{
+		cancelLoading();
+		return;
+	}
+	if (_state == State::Closed)
+	{
+		return;
+	}
+	stopDecoding();
+	Director::getInstance()->getScheduler()->unscheduleUpdate(this);
+	_nextDecodeIndex = 0;
+	_ptsOffset = 0.0;
+	_endOfStream = false;
+	_playbackTime = 0.0;
+	_clockStarted = false;
+	setState(State::Ready);
+}
+
+bool CCVideoPlayer::seek(double seconds, bool toKeyframe)
+{
+	if (_state == State::Loading || _state == State::Closed)
+	{
+		return false;
+	}
+	if (_state == State::Finished)
+	{
+		stop();
+	}
+
+	bool decoding = _decoding;
+	stopDecoding();
+
+	int index = _decoder.getFrameIndex(seconds);
+	if (toKeyframe)
+	{
+		index = _decoder.findKeyframe(index);
+	}
+	_nextDecodeIndex = index;
+	_ptsOffset = 0.0;
+	_endOfStream = false;
+	if (_masterClock)
+	{
+		_masterClock->seek(index * _decoder.getFrameDuration());
+	}
+
+	// no worker runs now, the target frame is decoded here so it is on screen before this returns.
+	if (decodeNextFrame() == DecodeResult::Decoded && !_frameQueue.empty())
+	{
+		CCVideoFrame * frame = _frameQueue.front();
+		presentFrame(*frame);
+		_playbackTime = frame->pts;
+		_clockStarted = true;
+		_frameQueue.pop();
+	}
+	else
+	{
+		_playbackTime = index * _decoder.getFrameDuration();
+		_clockStarted = false;
+	}
+
+	if (decoding)
+	{
+		startDecoding();
+	}
+	return true;
+}
+
+void CCVideoPlayer::startDecoding()
+{
+	// a short prebuffered clip may already be fully decoded.
+	_stopRequested = false;
+	if (!_endOfStream)
+	{
+		CCVideoDecodePool::getInstance()->addJob(this, [this]() { return decodeNextFrame() == DecodeResult::Decoded; });
+		_decoding = true;
+	}
+}
+
+void CCVideoPlayer::stopDecoding()
+{
+	_stopRequested = true;
+	if (_decoding)
+	{
+		CCVideoDecodePool::getInstance()->removeJob(this);
+		_decoding = false;
+	}
+	_frameQueue.clear();
+}
+
+CCVideoPlayer::DecodeResult CCVideoPlayer::decodeNextFrame()
+{
+	CCVideoFrame * slot = _frameQueue.beginWrite();
+	if (slot == nullptr)
+	{
+		return DecodeResult::QueueFull;
+	}
+
+	if (_nextDecodeIndex >= _decoder.getFrameCount())
+	{
+		if (!_looping)
+		{
+			_endOfStream = true;
+			return DecodeResult::EndOfStream;
+		}
+		_nextDecodeIndex = 0;
+		_ptsOffset += _decoder.getDuration();
+	}
+
+	// a broken frame is skipped, the previous one stays on screen.
+	auto start = std::chrono::steady_clock::now();
+	if (_decoder.decodeFrame(_nextDecodeIndex++, *slot))
+	{
+		slot->decodeMicros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+		slot->pts += _ptsOffset;
+		_frameQueue.commitWrite();
+	}
+	return DecodeResult::Decoded;
+}
+
+void CCVideoPlayer::update(float dt)
+{
+	if (_state != State::Playing)
+	{
+		return;
+	}
+
+	// the master clock is asked every update, it may extrapolate from dt.
+	double masterTime = 0.0;
+	bool mastered = _masterClock && _masterClock->getTime(dt, masterTime);
+
+	// read before looking at the ring, every frame queued before the flag was set is visible then.
+	bool endOfStream = _endOfStream;
+	CCVideoFrame * frame = _frameQueue.front();
+
+	if (mastered)
+	{
+		// frames before the clock are dropped below, frames after it wait (the current one is shown again).
+		if (frame == nullptr && !_clockStarted)
+		{
+			if (endOfStream)
+			{
+				finishPlayback();
+			}
+			return;
+		}
+		_clockStarted = true;
+		_playbackTime = masterTime;
+	}
+	// The clock starts with the first decoded frame so a slow open doesn't skip the beginning.
+	else if (!_clockStarted)
+	{
+		if (frame == nullptr)
+		{
+			if (endOfStream)
+			{
+				finishPlayback();
+			}
+			return;
+		}
+		_clockStarted = true;
+		_playbackTime = frame->pts;
+	}
+	else
+	{
+		_playbackTime += dt;
+	}
+
+	// A frame is due when its timestamp falls before the middle of the display interval that starts now.
+	double presentLimit = _playbackTime + dt * 0.5;
+
+	// Frames whose successor is already due will never be seen, drop them rather than uploading them.
+	CCVideoFrame * following = nullptr;
+	while (frame && frame->pts <= presentLimit && (following = _frameQueue.second()) && following->pts <= presentLimit)
+	{
+		_frameQueue.pop();
+		++_frameStats.dropped;
+		frame = following;
+	}
+
+	if (frame && frame->pts <= presentLimit)
+	{
+		if (frame->pts > _playbackTime)
+		{
+			++_frameStats.early;
+		}
+		else if (_playbackTime - frame->pts > _decoder.getFrameDuration())
+		{
+			++_frameStats.late;
+		}
+		if (_frameTimingCallback)
+		{
+			auto start = std::chrono::steady_clock::now();
+			presentFrame(*frame);
+			long long uploadMicros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+			_frameTimingCallback(CCVideoFrameTiming{ frame->index, frame->pts, _playbackTime, frame->decodeMicros, uploadMicros });
+		}
+		else
+		{
+			presentFrame(*frame);
+		}
+		++_frameStats.presented;
+		_frameQueue.pop();
+	}
+
+	if (endOfStream && _frameQueue.empty() && _playbackTime >= _decoder.getDuration())
+	{
+		finishPlayback();
+	}
+}
+
+void CCVideoPlayer::finishPlayback()
+{
+	stopDecoding(); // the job would only poll the finished clip
+	Director::getInstance()->getScheduler()->unscheduleUpdate(this);
+	setState(State::Finished);
+	if (_finishedCallback)
+	{
+		_finishedCallback(this);
+	}
+}
+
+void CCVideoPlayer::presentFrame(const CCVideoFrame& frame)
+{
+	bool created = uploadTexture(_texture, frame.planeY(), frame.planar ? frame.width * frame.height : frame.data.size(), frame.format, frame.width, frame.height);
+	if (frame.planar)
+	{
+		ssize_t chromaSize = frame.chromaWidth * frame.chromaHeight;
+		created |= uploadTexture(_textureU, frame.planeU(), chromaSize, frame.format, frame.chromaWidth, frame.chromaHeight);
+		created |= uploadTexture(_textureV, frame.planeV(), chromaSize, frame.format, frame.chromaWidth, frame.chromaHeight);
+	}
+	if (!_texture || (frame.planar && (!_textureU || !_textureV)))
+	{
+		return;
+	}
+
+	if (created)
+	{
+		_planar = frame.planar;
+		_visibleSize = Size((float)frame.visibleWidth, (float)frame.visibleHeight);
+		++_textureGeneration;
+		applyTextures(_sprite);
+		_sprite->setVisible(true);
+	}
+}
+
+bool CCVideoPlayer::applyTextures(Sprite * sprite) const
+{
+	if (_textureGeneration == 0)
+	{
+		return false;
+	}
+
+	sprite->setTexture(_texture);
+	sprite->setTextureRect(Rect(Vec2::ZERO, _visibleSize));
+
+	// A shader the game set on the sprite (e.g. a mask or a colour grade over the video) is kept, the default
+	// ones are only swapped when the frames change between packed and planar.
+	GLProgramCache * cache = GLProgramCache::getInstance();
+	GLProgram * yuvProgram = cache->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_YUV_NO_MVP);
+	GLProgram * rgbProgram = cache->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
+	GLProgramState * state = sprite->getGLProgramState();
+	GLProgram * program = state ? state->getGLProgram() : nullptr;
+	if (program == nullptr || program == yuvProgram || program == rgbProgram)
+	{
+		if (_planar && program != yuvProgram)
+		{
+			// a state of its own, the chroma textures differ for every player.
+			state = GLProgramState::create(yuvProgram);
+			sprite->setGLProgramState(state);
+		}
+		else if (!_planar && program != rgbProgram)
+		{
+			state = GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
+			sprite->setGLProgramState(state);
+		}
+	}
+
+	// only the samplers are bound again, a custom planar shader declares the same ones as the default.
+	if (_planar && state->getGLProgram()->getUniform("u_textureU") && state->getGLProgram()->getUniform("u_textureV"))
+	{
+		state->setUniformTexture("u_textureU", _textureU);
+		state->setUniformTexture("u_textureV", _textureV);
+	}
+	return true;
+}
@@ -0,0 +1,177 @@
+#ifndef _CC_VIDEO_PLAYER_
+#define _CC_VIDEO_PLAYER_
+
+#include "cocos2d.h"
+#include "CCVideoClock.h"
+#include "CCVideoDecoder.h"
+#include "CCVideoFrameQueue.h"
+
+#include <atomic>
+#include <functional>
+
+// Presentation counters, reset by CCVideoPlayer::resetFrameStats.
+struct CCVideoFrameStats
+{
+	unsigned int presented = 0; // frames uploaded into the texture
+	unsigned int dropped = 0;   // frames skipped because a newer frame was already due
+	unsigned int late = 0;      // frames presented more than one frame duration after their timestamp
+	unsigned int early = 0;     // frames presented up to half a display tick ahead of their timestamp
+};
+
+// Cost of one presented frame, reported through CCVideoPlayer::setFrameTimingCallback.
+struct CCVideoFrameTiming
+{
+	int index;               // position of the frame in the clip
+	double pts;              // its timestamp
+	double clock;            // playback clock when it was presented
+	long long decodeMicros;  // decode time on the worker
+	long long uploadMicros;  // texture upload time on the cocos thread
+};
+
+// Platform neutral video player. Frames are decoded by the CCVideoDecodePool workers and uploaded into a
+// Texture2D on the cocos thread, the texture is drawn by a regular Sprite so the video is
+// rendered inside the scene like any other node.
+// Decoded frames wait in a lock-free ring and are paced by their timestamps: when the game
+// runs behind, late frames are dropped instead of stalling the render loop.
+class CCVideoPlayer : public cocos2d::Ref
+{
+public:
+
+	enum class State
+	{
+		Closed = 0,  // No clip.
+		Loading,     // Clip is being opened and prebuffered in the background.
+		Ready,       // Clip is open, ready to play.
+		Playing,     // Frames are being presented.
+		Paused,      // Presentation is paused, decoding keeps the queue full.
+		Finished     // Last frame was presented.
+	};
+
+	typedef std::function<void(CCVideoPlayer*)> FinishedCallback;
+	typedef std::function<void(CCVideoPlayer*, bool)> LoadedCallback; // second argument is false if the clip couldn't be opened
+	typedef std::function<void(CCVideoPlayer*, State)> StateCallback;  // called with the new state on every change
+	typedef std::function<void(const CCVideoFrameTiming&)> FrameTimingCallback;
+
+	// The path may name an entry of a zip archive, "pack.zip#intro.ccv", see CCVideoStream.
+	static CCVideoPlayer * create(const std::string& path);
+	// Plays a clip held in memory, move the Data in to avoid a copy.
+	static CCVideoPlayer * createWithData(cocos2d::Data data);
+
+	// Opens the clip and decodes its first prebufferFrames frames on the AsyncTaskPool IO thread,
+	// so play() shows the first frame on the next update. The callback is called on the cocos thread.
+	// play() may be called while loading, playback then starts as soon as the clip is ready.
+	static CCVideoPlayer * createAsync(const std::string& path, int prebufferFrames, const LoadedCallback& callback);
+
+	// Stops a background load, the loaded callback still fires (with false).
+	void cancelLoading();
+
+	// Bytes held by decoded frames. Only call it while no decoding runs (Ready, Finished or Closed).
+	size_t getBufferedMemory() const { return _frameQueue.getMemoryUsage(); }
+
+	void play();
+	void pause();
+	void stop();
+
+	// Jumps to the frame shown at the given time and presents it right away, so it also works
+	// while paused (e.g. scrubbing). With toKeyframe the target snaps back to the closest keyframe.
+	// Playback continues from there in the current state, returns false while loading or closed.
+	bool seek(double seconds, bool toKeyframe = false);
+
+	void setLooping(bool looping) { _looping = looping; }
+	bool isLooping() const { return _looping; }
+	void setFinishedCallback(const FinishedCallback& callback) { _finishedCallback = callback; }
+	void setStateCallback(const StateCallback& callback) { _stateCallback = callback; }
+
+	State getState() const { return _state; }
+	// Zero while loading.
+	double getDuration() const { return _duration; }
+	double getCurrentTime() const { return _playbackTime; }
+	cocos2d::Size getVideoSize() const { return _videoSize; }
+
+	const CCVideoFrameStats& getFrameStats() const { return _frameStats; }
+	void resetFrameStats() { _frameStats = CCVideoFrameStats(); }
+	// Called for every presented frame, meant for profiling and benchmarks.
+	void setFrameTimingCallback(const FrameTimingCallback& callback) { _frameTimingCallback = callback; }
+
+	// Presents frames against the given clock (e.g. a CCVideoAudioClock following the soundtrack)
+	// instead of the frame delta. nullptr goes back to the frame delta. The clock is retained.
+	void setMasterClock(CCVideoClock * clock);
+	CCVideoClock * getMasterClock() const { return _masterClock; }
+
+	// The sprite displaying the video, add it to the scene graph wherever the video should appear.
+	// CCVideoSprite is the node to use when the video should be composed like any other sprite.
+	cocos2d::Sprite * getSprite() const { return _sprite; }
+
+	// Incremented whenever the frame textures are (re)created, other sprites showing the video re-apply them then.
+	unsigned int getTextureGeneration() const { return _textureGeneration; }
+	// Points the sprite at the frame textures. The default shader matching the frames is installed unless the sprite
+	// has one of its own, planar frames then need u_textureU and u_textureV samplers in it. False until the first
+	// frame was presented.
+	bool applyTextures(cocos2d::Sprite * sprite) const;
+
+	// Scheduled every frame while playing.
+	void update(float dt);
+
+CC_CONSTRUCTOR_ACCESS:
+	CCVideoPlayer();
+	virtual ~CCVideoPlayer();
+
+	bool init(const std::string& path);
+	bool initWithStream(CCVideoStream * stream); // takes the stream
+
+protected:
+
+	static const size_t MAX_QUEUED_FRAMES = 4;
+
+	enum class DecodeResult
+	{
+		Decoded,     // a frame was queued (or a broken frame skipped)
+		QueueFull,
+		EndOfStream
+	};
+
+	void setState(State state);
+	void initSprite();
+	void prebuffer(CCVideoStream * stream, int frames); // runs on the IO thread, takes the stream
+	void onLoaded(const LoadedCallback& callback);
+	void startDecoding();
+	void stopDecoding();
+	DecodeResult decodeNextFrame(); // producer side of the ring, run by one decode worker at a time
+	void presentFrame(const CCVideoFrame& frame);
+	void finishPlayback();
+
+	CCVideoDecoder _decoder;
+	// copied from the decoder on the cocos thread once it is open, the IO thread writes the decoder while loading
+	cocos2d::Size _videoSize;
+	double _duration;
+	State _state;
+	std::atomic<bool> _looping; // read by the decode thread when it reaches the last frame
+	FinishedCallback _finishedCallback;
+	StateCallback _stateCallback;
+
+	// frames decoded ahead of presentation
+	bool _decoding;                 // registered with the decode pool
+	CCVideoFrameQueue _frameQueue;
+	std::atomic<bool> _stopRequested;
+	std::atomic<bool> _endOfStream; // set once the last frame was queued
+	int _nextDecodeIndex;           // producer side only, decoding resumes there after a prebuffer
+	double _ptsOffset;              // added to the timestamps of looped frames
+	bool _loadFailed;
+	bool _playRequested;            // play() was called while loading
+
+	double _playbackTime;
+	bool _clockStarted;
+	CCVideoFrameStats _frameStats;
+	FrameTimingCallback _frameTimingCallback;
+
+	cocos2d::Texture2D * _texture;  // packed RGB(A) frame, or the Y plane of a planar frame
+	cocos2d::Texture2D * _textureU; // chroma planes of a planar frame
+	cocos2d::Texture2D * _textureV;
+	unsigned int _textureGeneration;
+	bool _planar;
+	cocos2d::Size _visibleSize;     // picture inside the textures
+	cocos2d::Sprite * _sprite;
+	CCVideoClock * _masterClock;
+};
+
+#endif /*_CC_VIDEO_PLAYER_*/
@@ -0,0 +1,107 @@
+#include "CCVideoSprite.h"
+
+USING_NS_CC;
+
+//-------------------------------CCVideoSprite----------------------------------------------//
+CCVideoSprite * CCVideoSprite::create(const std::string& path)
+{
+	return createWithPlayer(CCVideoPlayer::create(path));
+}
+
+CCVideoSprite * CCVideoSprite::createAsync(const std::string& path, int prebufferFrames)
+{
+	return createWithPlayer(CCVideoPlayer::createAsync(path, prebufferFrames, nullptr));
+}
+
+CCVideoSprite * CCVideoSprite::createWithPlayer(CCVideoPlayer * player)
+{
+	CCVideoSprite * sprite = new (std::nothrow) CCVideoSprite();
+	if (sprite && sprite->initWithPlayer(player))
+	{
+		sprite->autorelease();
+		return sprite;
+	}
+	CC_SAFE_DELETE(sprite);
+	return nullptr;
+}
+
+CCVideoSprite::CCVideoSprite()
+: _player(nullptr)
+, _textureGeneration(0)
+, _autoPlay(true)
+, _pausedByExit(false)
+{
+}
+
+CCVideoSprite::~CCVideoSprite()
+{
+	if (_player)
+	{
+		_player->stop();
+		_player->release();
+	}
+}
+
+bool CCVideoSprite::initWithPlayer(CCVideoPlayer * player)
+{
+	if (player == nullptr || !Sprite::init())
+	{
+		return false;
+	}
+	_player = player;
+	_player->retain();
+
+	// sized from the clip up front so it can be laid out before the first frame.
+	if (_player->getState() != CCVideoPlayer::State::Loading)
+	{
+		setTextureRect(Rect(Vec2::ZERO, _player->getVideoSize()));
+	}
+	return true;
+}
+
+void CCVideoSprite::onEnter()
+{
+	Sprite::onEnter();
+	// a clip the game paused itself stays paused.
+	CCVideoPlayer::State state = _player->getState();
+	if (_pausedByExit || (_autoPlay && (state == CCVideoPlayer::State::Ready || state == CCVideoPlayer::State::Loading)))
+	{
+		_player->play();
+	}
+	_pausedByExit = false;
+}
+
+void CCVideoSprite::onExit()
+{
+	if (_player->getState() == CCVideoPlayer::State::Playing)
+	{
+		_player->pause();
+		_pausedByExit = true;
+	}
+	Sprite::onExit();
+}
+
+void CCVideoSprite::syncTextures()
+{
+	unsigned int generation = _player->getTextureGeneration();
+	if (generation != _textureGeneration && _player->applyTextures(this))
+	{
+		_textureGeneration = generation;
+	}
+}
+
+void CCVideoSprite::visit(Renderer * renderer, const Mat4& parentTransform, uint32_t parentFlags)
+{
+	// before the transform is computed, a new texture rect changes the content size.
+	syncTextures();
+	Sprite::visit(renderer, parentTransform, parentFlags);
+}
+
+void CCVideoSprite::draw(Renderer * renderer, const Mat4& transform, uint32_t flags)
+{
+	// nothing to show until the first frame was uploaded.
+	if (_textureGeneration != 0)
+	{
+		Sprite::draw(renderer, transform, flags);
+	}
+}
@@ -0,0 +1,50 @@
+#ifndef _CC_VIDEO_SPRITE_
+#define _CC_VIDEO_SPRITE_
+
+#include "cocos2d.h"
+#include "CCVideoPlayer.h"
+
+// A Sprite showing the frames of a CCVideoPlayer it owns.
+// It is a regular node of the scene graph: z-order, actions (fades, moves), transitions, ClippingNode
+// masks, NodeGrid effects, custom shaders and RenderTexture captures all apply to it, and its quad is
+// submitted through the sprite TrianglesCommand like any other sprite. A custom shader set with
+// setGLProgramState is kept across frames; for YUV clips it samples u_textureU and u_textureV along
+// with the Y plane in CC_Texture0, see ccShader_PositionTextureYUV.frag.
+// Playback follows the node: it starts when the sprite enters the running scene (unless autoplay is
+// off) and pauses while the sprite is out of it.
+class CCVideoSprite : public cocos2d::Sprite
+{
+public:
+
+	static CCVideoSprite * create(const std::string& path);
+	// Opens the clip in the background, the sprite stays empty until the first frame.
+	static CCVideoSprite * createAsync(const std::string& path, int prebufferFrames = 8);
+	static CCVideoSprite * createWithPlayer(CCVideoPlayer * player);
+
+	CCVideoPlayer * getPlayer() const { return _player; }
+
+	void setAutoPlay(bool autoPlay) { _autoPlay = autoPlay; }
+	bool isAutoPlay() const { return _autoPlay; }
+
+	virtual void onEnter() override;
+	virtual void onExit() override;
+	virtual void visit(cocos2d::Renderer * renderer, const cocos2d::Mat4& parentTransform, uint32_t parentFlags) override;
+	virtual void draw(cocos2d::Renderer * renderer, const cocos2d::Mat4& transform, uint32_t flags) override;
+
+CC_CONSTRUCTOR_ACCESS:
+	CCVideoSprite();
+	virtual ~CCVideoSprite();
+
+	bool initWithPlayer(CCVideoPlayer * player);
+
+protected:
+
+	void syncTextures(); // follows the player when it recreated its textures
+
+	CCVideoPlayer * _player;
+	unsigned int _textureGeneration; // generation of the player textures this sprite shows
+	bool _autoPlay;
+	bool _pausedByExit;
+};
+
+#endif /*_CC_VIDEO_SPRITE_*/
@@ -0,0 +1,312 @@
+#include "CCVideoStream.h"
+#include "unzip/unzip.h"
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+#include "platform/android/CCFileUtils-android.h"
+#include <android/asset_manager.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <vector>
+
+USING_NS_CC;
+
+static const char ZIP_ENTRY_SEPARATOR = '#';
+
+namespace
+{
+	// fseek and ftell take a long, which is 32 bits on Windows and clips can be larger than 2 GB.
+	int seekFile(FILE * file, uint64_t offset, int origin)
+	{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+		return _fseeki64(file, (__int64)offset, origin);
+#else
+		return fseeko(file, (off_t)offset, origin);
+#endif
+	}
+
+	int64_t tellFile(FILE * file)
+	{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+		return _ftelli64(file);
+#else
+		return ftello(file);
+#endif
+	}
+
+	// The separator of "pack.zip#clips/intro.ccv", a '#' only counts when it follows a .zip archive
+	// so plain file names may contain one.
+	size_t findZipEntrySeparator(const std::string& path)
+	{
+		static const std::string ZIP_EXTENSION = ".zip";
+		for (size_t separator = path.find(ZIP_ENTRY_SEPARATOR); separator != std::string::npos; separator = path.find(ZIP_ENTRY_SEPARATOR, separator + 1))
+		{
+			if (separator >= ZIP_EXTENSION.size()
+				&& std::equal(ZIP_EXTENSION.begin(), ZIP_EXTENSION.end(), path.begin() + (separator - ZIP_EXTENSION.size()),
+					[](char a, char b) { return a == ::tolower((unsigned char)b); }))
+			{
+				return separator;
+			}
+		}
+		return std::string::npos;
+	}
+
+	// Clips on the file system, e.g. downloaded or in the app bundle on desktop and iOS.
+	class FileStream : public CCVideoStream
+	{
+	public:
+
+		static FileStream * open(const std::string& fullPath)
+		{
+			FILE * file = fopen(fullPath.c_str(), "rb");
+			if (file == nullptr)
+			{
+				return nullptr;
+			}
+			seekFile(file, 0, SEEK_END);
+			int64_t size = tellFile(file);
+			return new FileStream(file, size > 0 ? (uint64_t)size : 0);
+		}
+
+		virtual ~FileStream()
+		{
+			fclose(_file);
+		}
+
+		virtual bool read(uint64_t offset, void * buffer, size_t size) override
+		{
+			return seekFile(_file, offset, SEEK_SET) == 0 && fread(buffer, 1, size, _file) == size;
+		}
+
+		virtual uint64_t getSize() const override { return _size; }
+
+	private:
+
+		FileStream(FILE * file, uint64_t size) : _file(file), _size(size) {}
+
+		FILE * _file;
+		uint64_t _size;
+	};
+
+	// Clips held by a Data, nothing is copied on read.
+	class MemoryStream : public CCVideoStream
+	{
+	public:
+
+		explicit MemoryStream(Data&& data) : _data(std::move(data)) {}
+
+		virtual bool read(uint64_t offset, void * buffer, size_t size) override
+		{
+			if (offset + size > (uint64_t)_data.getSize())
+			{
+				return false;
+			}
+			memcpy(buffer, _data.getBytes() + offset, size);
+			return true;
+		}
+
+		virtual uint64_t getSize() const override { return (uint64_t)_data.getSize(); }
+
+	private:
+
+		Data _data;
+	};
+
+	// Entry of a zip archive. A stored entry (zip -0, frames are already compressed so nothing is lost)
+	// is read straight from the archive file. A deflated entry can only be inflated front to back: reads
+	// skip forward in the stream and a read behind the current position restarts it from the beginning.
+	class ZipEntryStream : public CCVideoStream
+	{
+	public:
+
+		static CCVideoStream * open(const std::string& zipPath, const std::string& entry)
+		{
+			unzFile zip = unzOpen(zipPath.c_str());
+			if (zip == nullptr)
+			{
+				return nullptr;
+			}
+
+			unz_file_info info;
+			if (unzLocateFile(zip, entry.c_str(), 1) != UNZ_OK
+				|| unzGetCurrentFileInfo(zip, &info, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK
+				|| unzOpenCurrentFile(zip) != UNZ_OK)
+			{
+				CCLOG("CCVideoStream: %s not found in %s", entry.c_str(), zipPath.c_str());
+				unzClose(zip);
+				return nullptr;
+			}
+
+			if (info.compression_method == 0)
+			{
+				// the position of the entry's data in the archive, the archive is then read like a plain file.
+				uint64_t dataOffset = unzGetCurrentFileZStreamPos64(zip);
+				uint64_t size = info.uncompressed_size;
+				unzCloseCurrentFile(zip);
+				unzClose(zip);
+
+				FILE * file = fopen(zipPath.c_str(), "rb");
+				return file ? new ZipEntryStream(file, dataOffset, size) : nullptr;
+			}
+
+			CCLOG("CCVideoStream: %s is deflated in %s, store it (zip -0) for fast seeking", entry.c_str(), zipPath.c_str());
+			return new ZipEntryStream(zip, info.uncompressed_size);
+		}
+
+		virtual ~ZipEntryStream()
+		{
+			if (_zip)
+			{
+				unzCloseCurrentFile(_zip);
+				unzClose(_zip);
+			}
+			if (_file)
+			{
+				fclose(_file);
+			}
+		}
+
+		virtual bool read(uint64_t offset, void * buffer, size_t size) override
+		{
+			if (offset + size > _size)
+			{
+				return false;
+			}
+			if (_file)
+			{
+				return seekFile(_file, _dataOffset + offset, SEEK_SET) == 0 && fread(buffer, 1, size, _file) == size;
+			}
+			return readDeflated(offset, (unsigned char *)buffer, size);
+		}
+
+		virtual uint64_t getSize() const override { return _size; }
+
+	private:
+
+		static const size_t SKIP_CHUNK = 16 * 1024;
+
+		ZipEntryStream(FILE * file, uint64_t dataOffset, uint64_t size)
+		: _zip(nullptr), _file(file), _dataOffset(dataOffset), _size(size), _position(0)
+		{
+		}
+
+		ZipEntryStream(unzFile zip, uint64_t size)
+		: _zip(zip), _file(nullptr), _dataOffset(0), _size(size), _position(0)
+		{
+		}
+
+		bool readDeflated(uint64_t offset, unsigned char * buffer, size_t size)
+		{
+			if (offset < _position)
+			{
+				unzCloseCurrentFile(_zip);
+				if (unzOpenCurrentFile(_zip) != UNZ_OK)
+				{
+					return false;
+				}
+				_position = 0;
+			}
+			while (_position < offset)
+			{
+				unsigned char skip[SKIP_CHUNK];
+				unsigned int chunk = (unsigned int)std::min<uint64_t>(SKIP_CHUNK, offset - _position);
+				int count = unzReadCurrentFile(_zip, skip, chunk);
+				if (count <= 0)
+				{
+					return false;
+				}
+				_position += count;
+			}
+			while (size > 0)
+			{
+				int count = unzReadCurrentFile(_zip, buffer, (unsigned int)size);
+				if (count <= 0)
+				{
+					return false;
+				}
+				buffer += count;
+				size -= count;
+				_position += count;
+			}
+			return true;
+		}
+
+		unzFile _zip;        // deflated entry, open on the entry
+		FILE * _file;        // stored entry, the archive itself
+		uint64_t _dataOffset;
+		uint64_t _size;
+		uint64_t _position;  // inflate position of a deflated entry
+	};
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+	// Clips inside the APK. Assets that aren't compressed in the APK (aapt keeps .ccv uncompressed
+	// when listed in noCompress) are memory mapped by the asset manager and read in place.
+	class AssetStream : public CCVideoStream
+	{
+	public:
+
+		static AssetStream * open(const std::string& assetPath)
+		{
+			AAsset * asset = AAssetManager_open(FileUtilsAndroid::getAssetManager(), assetPath.c_str(), AASSET_MODE_RANDOM);
+			return asset ? new AssetStream(asset) : nullptr;
+		}
+
+		virtual ~AssetStream()
+		{
+			AAsset_close(_asset);
+		}
+
+		virtual bool read(uint64_t offset, void * buffer, size_t size) override
+		{
+			return AAsset_seek64(_asset, (off64_t)offset, SEEK_SET) == (off64_t)offset && AAsset_read(_asset, buffer, size) == (int)size;
+		}
+
+		virtual uint64_t getSize() const override { return (uint64_t)AAsset_getLength64(_asset); }
+
+	private:
+
+		explicit AssetStream(AAsset * asset) : _asset(asset) {}
+
+		AAsset * _asset;
+	};
+#endif
+}
+
+//-------------------------------CCVideoStream----------------------------------------------//
+std::string CCVideoStream::fullPathForFilename(const std::string& path)
+{
+	size_t separator = findZipEntrySeparator(path);
+	if (separator == std::string::npos)
+	{
+		return FileUtils::getInstance()->fullPathForFilename(path);
+	}
+
+	std::string zipPath = FileUtils::getInstance()->fullPathForFilename(path.substr(0, separator));
+	return zipPath.empty() ? zipPath : zipPath + path.substr(separator);
+}
+
+CCVideoStream * CCVideoStream::open(const std::string& fullPath)
+{
+	size_t separator = findZipEntrySeparator(fullPath);
+	if (separator != std::string::npos)
+	{
+		return ZipEntryStream::open(fullPath.substr(0, separator), fullPath.substr(separator + 1));
+	}
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+	// FileUtils prefixes the files of the APK with "assets/", they can't be opened with fopen.
+	static const std::string ASSETS_PREFIX = "assets/";
+	if (fullPath.compare(0, ASSETS_PREFIX.size(), ASSETS_PREFIX) == 0)
+	{
+		return AssetStream::open(fullPath.substr(ASSETS_PREFIX.size()));
+	}
+#endif
+	return FileStream::open(fullPath);
+}
+
+CCVideoStream * CCVideoStream::createWithData(Data data)
+{
+	return data.isNull() ? nullptr : new MemoryStream(std::move(data));
+}
@@ -0,0 +1,35 @@
+#ifndef _CC_VIDEO_STREAM_
+#define _CC_VIDEO_STREAM_
+
+#include "cocos2d.h"
+
+#include <cstdint>
+#include <string>
+
+// Random access byte source a CCVideoDecoder reads its clip from.
+// Only the frame table and the payload of the frame being decoded are ever held in memory,
+// so clips stream from wherever they live instead of being loaded or extracted first.
+class CCVideoStream
+{
+public:
+
+	virtual ~CCVideoStream() {}
+
+	// Reads size bytes at offset, returns false on a short read.
+	virtual bool read(uint64_t offset, void * buffer, size_t size) = 0;
+	virtual uint64_t getSize() const = 0;
+
+	// Resolves a clip path through FileUtils, call it on the cocos thread. The result can be passed to
+	// open() from any thread. Paths of the form "pack.zip#clips/intro.ccv" name an entry of a zip archive,
+	// only the archive part is resolved. A '#' that doesn't follow ".zip" is part of a plain file name.
+	static std::string fullPathForFilename(const std::string& path);
+
+	// Opens a path returned by fullPathForFilename: a plain file, an APK asset on Android, or a zip entry.
+	// Returns nullptr if it can't be opened.
+	static CCVideoStream * open(const std::string& fullPath);
+
+	// Serves the clip from memory, e.g. a pack decrypted by the game. Move the Data in to avoid a copy.
+	static CCVideoStream * createWithData(cocos2d::Data data);
+};
+
+#endif /*_CC_VIDEO_STREAM_*/
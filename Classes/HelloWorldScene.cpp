@@ -73,7 +73,11 @@ bool HelloWorld::init()
     this->addChild(sprite, 0);
     
 	//playing the video file
+#if CC_VIDEO_TEXTURE_BACKEND
+	CCVideoManager::Instance()->PlayVideo("testpattern.ccv");
+#else
 	CCVideoManager::Instance()->PlayVideo("showreelv4.mov");
+#endif
 
     return true;
 }
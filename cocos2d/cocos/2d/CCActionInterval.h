@@ -115,6 +115,8 @@ protected:
 
 protected:
     bool sendUpdateEventToScript(float dt, Action *actionObject);
+
+    friend class ActionManager;
 };
 
 /** @class Sequence
@@ -624,6 +626,7 @@ protected:
     Vec3 _startPosition;
     Vec3 _previousPosition;
 
+    friend class ActionManager;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MoveBy);
 };
@@ -1033,6 +1036,7 @@ protected:
     float _deltaY;
     float _deltaZ;
 
+    friend class ActionManager;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ScaleTo);
 };
@@ -1172,6 +1176,7 @@ protected:
     GLubyte _fromOpacity;
     friend class FadeOut;
     friend class FadeIn;
+    friend class ActionManager;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FadeTo);
 };
@@ -27,8 +27,13 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "2d/CCActionManager.h"
+
+#include <float.h>
+#include <typeinfo>
+
 #include "2d/CCNode.h"
 #include "2d/CCAction.h"
+#include "2d/CCActionInterval.h"
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/ccCArray.h"
@@ -43,6 +48,7 @@ typedef struct _hashElement
     struct _ccArray     *actions;
     Node                *target;
     int                 actionIndex;
+    int                 batchedCount;   // actions stepped by the batches
     Action              *currentAction;
     bool                currentActionSalvaged;
     bool                paused;
@@ -52,7 +58,9 @@ typedef struct _hashElement
 ActionManager::ActionManager()
 : _targets(nullptr),
   _currentTarget(nullptr),
-  _currentTargetSalvaged(false)
+  _currentTargetSalvaged(false),
+  _steppingTweens(false),
+  _deadTweens(false)
 {
 
 }
@@ -98,6 +106,11 @@ void ActionManager::removeActionAtIndex(ssize_t index, tHashElement *element)
         element->currentActionSalvaged = true;
     }
 
+    if (action->_batchIndex >= 0)
+    {
+        unbatchAction(action, element);
+    }
+
     ccArrayRemoveObjectAtIndex(element->actions, index, true);
 
     // update actionIndex in case we are in tick. looping over the actions
@@ -128,6 +141,7 @@ void ActionManager::pauseTarget(Node *target)
     if (element)
     {
         element->paused = true;
+        pauseBatchedActions(element, true);
     }
 }
 
@@ -138,6 +152,7 @@ void ActionManager::resumeTarget(Node *target)
     if (element)
     {
         element->paused = false;
+        pauseBatchedActions(element, false);
     }
 }
 
@@ -150,6 +165,7 @@ Vector<Node*> ActionManager::pauseAllRunningActions()
         if (! element->paused) 
         {
             element->paused = true;
+            pauseBatchedActions(element, true);
             idsWithActions.pushBack(element->target);
         }
     }    
@@ -190,6 +206,11 @@ void ActionManager::addAction(Action *action, Node *target, bool paused)
      ccArrayAppendObject(element->actions, action);
  
      action->startWithTarget(target);
+
+    if (getTweenKind(action) != TweenKind::NONE)
+    {
+        batchAction(action, element);
+    }
 }
 
 // remove
@@ -222,6 +243,14 @@ void ActionManager::removeAllActionsFromTarget(Node *target)
             element->currentActionSalvaged = true;
         }
 
+        for (int i = 0; element->batchedCount > 0 && i < element->actions->num; ++i)
+        {
+            Action *action = (Action*)element->actions->arr[i];
+            if (action->_batchIndex >= 0)
+            {
+                unbatchAction(action, element);
+            }
+        }
         ccArrayRemoveAllObjects(element->actions);
         if (_currentTarget == element)
         {
@@ -404,14 +433,15 @@ void ActionManager::update(float dt)
         _currentTarget = elt;
         _currentTargetSalvaged = false;
 
-        if (! _currentTarget->paused)
+        // a target whose actions are all batched has nothing to step here
+        if (! _currentTarget->paused && _currentTarget->batchedCount < _currentTarget->actions->num)
         {
             // The 'actions' MutableArray may change while inside this loop.
             for (_currentTarget->actionIndex = 0; _currentTarget->actionIndex < _currentTarget->actions->num;
                 _currentTarget->actionIndex++)
             {
                 _currentTarget->currentAction = (Action*)_currentTarget->actions->arr[_currentTarget->actionIndex];
-                if (_currentTarget->currentAction == nullptr)
+                if (_currentTarget->currentAction == nullptr || _currentTarget->currentAction->_batchIndex >= 0)
                 {
                     continue;
                 }
@@ -454,6 +484,313 @@ void ActionManager::update(float dt)
 
     // issue #635
     _currentTarget = nullptr;
+
+    stepBatchedActions(dt);
+}
+
+// batched actions
+
+ActionManager::TweenKind ActionManager::getTweenKind(const Action *action)
+{
+#if CC_ENABLE_ACTION_BATCHING
+#if CC_ENABLE_SCRIPT_BINDING
+    // JS actions forward their updates to the script from step()
+    if (action->_scriptType == kScriptTypeJavascript)
+    {
+        return TweenKind::NONE;
+    }
+#endif
+    // only the exact types, a subclass may override update()
+    const std::type_info &type = typeid(*action);
+    if (type == typeid(MoveTo) || type == typeid(MoveBy))
+    {
+        return TweenKind::MOVE;
+    }
+    if (type == typeid(ScaleTo) || type == typeid(ScaleBy))
+    {
+        return TweenKind::SCALE;
+    }
+    if (type == typeid(FadeTo) || type == typeid(FadeIn) || type == typeid(FadeOut))
+    {
+        return TweenKind::FADE;
+    }
+#else
+    CC_UNUSED_PARAM(action);
+#endif
+    return TweenKind::NONE;
+}
+
+float ActionManager::advanceTween(Tween &tween, float dt)
+{
+    if (tween.firstTick)
+    {
+        tween.firstTick = false;
+        tween.elapsed = 0;
+    }
+    else
+    {
+        tween.elapsed += dt;
+    }
+
+    // kept in the action, getElapsed() and isDone() stay valid
+    tween.action->_elapsed = tween.elapsed;
+    tween.action->_firstTick = false;
+
+    return MAX(0, MIN(1, tween.elapsed / MAX(tween.duration, FLT_EPSILON)));
+}
+
+void ActionManager::batchAction(Action *action, tHashElement *element)
+{
+    ActionInterval *interval = static_cast<ActionInterval*>(action);
+    Tween *tween = nullptr;
+
+    switch (getTweenKind(action))
+    {
+        case TweenKind::MOVE:
+        {
+            MoveBy *move = static_cast<MoveBy*>(action);
+            _moveTweens.push_back(MoveTween());
+            MoveTween &moveTween = _moveTweens.back();
+            moveTween.delta = move->_positionDelta;
+            moveTween.start = move->_startPosition;
+            moveTween.previous = move->_previousPosition;
+            action->_batchIndex = (int)_moveTweens.size() - 1;
+            tween = &moveTween;
+            break;
+        }
+        case TweenKind::SCALE:
+        {
+            ScaleTo *scale = static_cast<ScaleTo*>(action);
+            _scaleTweens.push_back(ScaleTween());
+            ScaleTween &scaleTween = _scaleTweens.back();
+            scaleTween.start.set(scale->_startScaleX, scale->_startScaleY, scale->_startScaleZ);
+            scaleTween.delta.set(scale->_deltaX, scale->_deltaY, scale->_deltaZ);
+            action->_batchIndex = (int)_scaleTweens.size() - 1;
+            tween = &scaleTween;
+            break;
+        }
+        case TweenKind::FADE:
+        {
+            FadeTo *fade = static_cast<FadeTo*>(action);
+            _fadeTweens.push_back(FadeTween());
+            FadeTween &fadeTween = _fadeTweens.back();
+            fadeTween.from = fade->_fromOpacity;
+            fadeTween.to = fade->_toOpacity;
+            action->_batchIndex = (int)_fadeTweens.size() - 1;
+            tween = &fadeTween;
+            break;
+        }
+        default:
+            return;
+    }
+
+    tween->action = interval;
+    tween->target = element->target;
+    tween->elapsed = interval->_elapsed;
+    tween->duration = interval->_duration;
+    tween->firstTick = interval->_firstTick;
+    tween->paused = element->paused;
+    element->batchedCount++;
+}
+
+void ActionManager::unbatchAction(Action *action, tHashElement *element)
+{
+    int index = action->_batchIndex;
+
+    switch (getTweenKind(action))
+    {
+        case TweenKind::MOVE:
+        {
+            // the stacked start position is the only state that changes while the action runs
+            MoveBy *move = static_cast<MoveBy*>(action);
+            move->_startPosition = _moveTweens[index].start;
+            move->_previousPosition = _moveTweens[index].previous;
+            removeTween(_moveTweens, index);
+            break;
+        }
+        case TweenKind::SCALE:
+            removeTween(_scaleTweens, index);
+            break;
+        case TweenKind::FADE:
+            removeTween(_fadeTweens, index);
+            break;
+        default:
+            break;
+    }
+
+    action->_batchIndex = -1;
+    element->batchedCount--;
+}
+
+template <typename T>
+void ActionManager::removeTween(std::vector<T> &tweens, int index)
+{
+    if (_steppingTweens)
+    {
+        // the batch may be looping over this slot, it is compacted after the step
+        tweens[index].action = nullptr;
+        _deadTweens = true;
+        return;
+    }
+
+    if (index != (int)tweens.size() - 1)
+    {
+        tweens[index] = tweens.back();
+        tweens[index].action->_batchIndex = index;
+    }
+    tweens.pop_back();
+}
+
+template <typename T>
+void ActionManager::compactTweens(std::vector<T> &tweens)
+{
+    size_t alive = 0;
+    for (size_t i = 0; i < tweens.size(); ++i)
+    {
+        if (tweens[i].action != nullptr)
+        {
+            if (alive != i)
+            {
+                tweens[alive] = tweens[i];
+                tweens[alive].action->_batchIndex = (int)alive;
+            }
+            alive++;
+        }
+    }
+    tweens.resize(alive);
+}
+
+void ActionManager::pauseBatchedActions(tHashElement *element, bool paused)
+{
+    for (int i = 0; element->batchedCount > 0 && i < element->actions->num; ++i)
+    {
+        Action *action = (Action*)element->actions->arr[i];
+        int index = action->_batchIndex;
+        if (index < 0)
+        {
+            continue;
+        }
+
+        switch (getTweenKind(action))
+        {
+            case TweenKind::MOVE:
+                _moveTweens[index].paused = paused;
+                break;
+            case TweenKind::SCALE:
+                _scaleTweens[index].paused = paused;
+                break;
+            case TweenKind::FADE:
+                _fadeTweens[index].paused = paused;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void ActionManager::stepBatchedActions(float dt)
+{
+    // The node setters are virtual and may stop or run actions: tweens are indexed instead of
+    // referenced since running an action can grow the arrays, and removed ones are only marked.
+    // Tweens added while stepping get their first tick next frame.
+    _steppingTweens = true;
+
+    size_t count = _moveTweens.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        MoveTween &tween = _moveTweens[i];
+        if (tween.action == nullptr || tween.paused)
+        {
+            continue;
+        }
+
+        ActionInterval *action = tween.action;
+        float time = advanceTween(tween, dt);
+        Node *target = tween.target;
+#if CC_ENABLE_STACKABLE_ACTIONS
+        tween.start += target->getPosition3D() - tween.previous;
+        Vec3 position = tween.start + tween.delta * time;
+        tween.previous = position;
+#else
+        Vec3 position = tween.start + tween.delta * time;
+#endif // CC_ENABLE_STACKABLE_ACTIONS
+        bool done = tween.elapsed >= tween.duration;
+
+        target->setPosition3D(position);
+
+        if (done && _moveTweens[i].action == action)
+        {
+            _finishedTweens.pushBack(action);
+        }
+    }
+
+    count = _scaleTweens.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        ScaleTween &tween = _scaleTweens[i];
+        if (tween.action == nullptr || tween.paused)
+        {
+            continue;
+        }
+
+        ActionInterval *action = tween.action;
+        float time = advanceTween(tween, dt);
+        Node *target = tween.target;
+        Vec3 scale = tween.start + tween.delta * time;
+        bool done = tween.elapsed >= tween.duration;
+
+        target->setScaleX(scale.x);
+        target->setScaleY(scale.y);
+        target->setScaleZ(scale.z);
+
+        if (done && _scaleTweens[i].action == action)
+        {
+            _finishedTweens.pushBack(action);
+        }
+    }
+
+    count = _fadeTweens.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        FadeTween &tween = _fadeTweens[i];
+        if (tween.action == nullptr || tween.paused)
+        {
+            continue;
+        }
+
+        ActionInterval *action = tween.action;
+        float time = advanceTween(tween, dt);
+        Node *target = tween.target;
+        GLubyte opacity = (GLubyte)(tween.from + (tween.to - tween.from) * time);
+        bool done = tween.elapsed >= tween.duration;
+
+        target->setOpacity(opacity);
+
+        if (done && _fadeTweens[i].action == action)
+        {
+            _finishedTweens.pushBack(action);
+        }
+    }
+
+    _steppingTweens = false;
+    if (_deadTweens)
+    {
+        compactTweens(_moveTweens);
+        compactTweens(_scaleTweens);
+        compactTweens(_fadeTweens);
+        _deadTweens = false;
+    }
+
+    // _finishedTweens retains them, stopping one may remove the others
+    for (const auto &action : _finishedTweens)
+    {
+        if (action->_batchIndex >= 0)
+        {
+            action->stop();
+            removeAction(action);
+        }
+    }
+    _finishedTweens.clear();
 }
 
 NS_CC_END
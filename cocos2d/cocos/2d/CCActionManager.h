@@ -29,13 +29,21 @@ THE SOFTWARE.
 #ifndef __ACTION_CCACTION_MANAGER_H__
 #define __ACTION_CCACTION_MANAGER_H__
 
+#include <vector>
+
 #include "2d/CCAction.h"
 #include "base/CCVector.h"
 #include "base/CCRef.h"
+#include "math/Vec3.h"
+#include "platform/CCGL.h"
 
 NS_CC_BEGIN
 
 class Action;
+class ActionInterval;
+class MoveBy;
+class ScaleTo;
+class FadeTo;
 
 struct _hashElement;
 
@@ -52,6 +60,13 @@ struct _hashElement;
  Examples:
     - When you want to run an action where the target is different from a Node. 
     - When you want to pause / resume the actions.
+
+ When CC_ENABLE_ACTION_BATCHING is enabled (it isn't by default),
+ MoveBy, MoveTo, ScaleBy, ScaleTo, FadeTo, FadeIn and FadeOut actions added directly (not wrapped in a Sequence,
+ an ease or a Speed) keep their state in plain structs, one contiguous array per kind, and are stepped in a single
+ loop per array instead of through a virtual Action::step() call per action. They are still regular actions for
+ the rest of the API: they can be queried, stopped, paused and resumed like any other, but they are stepped after
+ the other actions of the frame.
  
  @since v0.8
  */
@@ -181,10 +196,71 @@ protected:
     void deleteHashElement(struct _hashElement *element);
     void actionAllocWithHashElement(struct _hashElement *element);
 
+    /** Kind of batch an action is stepped by. */
+    enum class TweenKind
+    {
+        NONE,
+        MOVE,
+        SCALE,
+        FADE
+    };
+
+    /** Clock of a batched action, what ActionInterval::step() keeps in the action. */
+    struct Tween
+    {
+        ActionInterval *action; // nullptr once removed while the batches are stepped
+        Node *target;
+        float elapsed;
+        float duration;
+        bool firstTick;
+        bool paused;
+    };
+
+    /** MoveBy and MoveTo. */
+    struct MoveTween : public Tween
+    {
+        Vec3 delta;
+        Vec3 start;
+        Vec3 previous;
+    };
+
+    /** ScaleTo and ScaleBy. */
+    struct ScaleTween : public Tween
+    {
+        Vec3 start;
+        Vec3 delta;
+    };
+
+    /** FadeTo, FadeIn and FadeOut. */
+    struct FadeTween : public Tween
+    {
+        GLubyte from;
+        GLubyte to;
+    };
+
+    static TweenKind getTweenKind(const Action *action);
+    /** Advances the clock of a tween like ActionInterval::step(), returns the time passed to update(). */
+    static float advanceTween(Tween &tween, float dt);
+
+    void batchAction(Action *action, struct _hashElement *element);
+    void unbatchAction(Action *action, struct _hashElement *element);
+    void pauseBatchedActions(struct _hashElement *element, bool paused);
+    void stepBatchedActions(float dt);
+    template <typename T> void removeTween(std::vector<T> &tweens, int index);
+    template <typename T> void compactTweens(std::vector<T> &tweens);
+
 protected:
     struct _hashElement    *_targets;
     struct _hashElement    *_currentTarget;
     bool            _currentTargetSalvaged;
+
+    std::vector<MoveTween> _moveTweens;
+    std::vector<ScaleTween> _scaleTweens;
+    std::vector<FadeTween> _fadeTweens;
+    /** Batched actions that finished this frame, stopped and removed once all the batches are stepped. */
+    Vector<Action*> _finishedTweens;
+    bool _steppingTweens;
+    bool _deadTweens;
 };
 
 // end of actions group
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include <algorithm>
 #include <string>
 #include <regex>
+#include <typeinfo>
 
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
@@ -44,6 +45,8 @@ THE SOFTWARE.
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCMaterial.h"
+#include "renderer/CCRenderer.h"
+#include "renderer/CCRenderWorkers.h"
 #include "math/TransformUtils.h"
 #include "deprecated/CCString.h"
 
@@ -88,6 +91,11 @@ Node::Node()
 , _inverseDirty(true)
 , _useAdditionalTransform(false)
 , _transformUpdated(true)
+, _parallelVisit(false)
+, _transformPreparedFrame(UINT_MAX)
+, _subtreeCulling(false)
+, _subtreeBoundsDirty(true)
+, _subtreeBoundsInfinite(false)
 // children (lazy allocs)
 // lazy alloc
 , _localZOrder(0)
@@ -241,6 +249,7 @@ void Node::setSkewX(float skewX)
     
     _skewX = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 float Node::getSkewY() const
@@ -255,6 +264,7 @@ void Node::setSkewY(float skewY)
     
     _skewY = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 void Node::setLocalZOrder(int z)
@@ -265,10 +275,13 @@ void Node::setLocalZOrder(int z)
     _localZOrder = z;
     if (_parent)
     {
+        // marks the event listeners of the subtree dirty
         _parent->reorderChild(this, z);
     }
-
-    _eventDispatcher->setDirtyForNode(this);
+    else
+    {
+        _eventDispatcher->setDirtyForNode(this);
+    }
 }
 
 /// zOrder setter : private method
@@ -302,6 +315,7 @@ void Node::setRotation(float rotation)
     
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
     
     updateRotationQuat();
 }
@@ -319,6 +333,7 @@ void Node::setRotation3D(const Vec3& rotation)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -370,6 +385,7 @@ void Node::setRotationQuat(const Quaternion& quat)
     _rotationQuat = quat;
     updateRotation3D();
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 Quaternion Node::getRotationQuat() const
@@ -384,6 +400,7 @@ void Node::setRotationSkewX(float rotationX)
     
     _rotationZ_X = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
     
     updateRotationQuat();
 }
@@ -400,6 +417,7 @@ void Node::setRotationSkewY(float rotationY)
     
     _rotationZ_Y = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
     
     updateRotationQuat();
 }
@@ -419,6 +437,7 @@ void Node::setScale(float scale)
     
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 /// scaleX getter
@@ -436,6 +455,7 @@ void Node::setScale(float scaleX,float scaleY)
     _scaleX = scaleX;
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 /// scaleX setter
@@ -446,6 +466,7 @@ void Node::setScaleX(float scaleX)
     
     _scaleX = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 /// scaleY getter
@@ -462,6 +483,7 @@ void Node::setScaleZ(float scaleZ)
     
     _scaleZ = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 /// scaleY getter
@@ -478,6 +500,7 @@ void Node::setScaleY(float scaleY)
     
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 
@@ -508,6 +531,7 @@ void Node::setPosition(float x, float y)
     _position.y = y;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
     _usingNormalizedPosition = false;
 }
 
@@ -553,6 +577,7 @@ void Node::setPositionZ(float positionZ)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 
     _positionZ = positionZ;
 }
@@ -573,6 +598,7 @@ void Node::setNormalizedPosition(const Vec2& position)
     _usingNormalizedPosition = true;
     _normalizedPositionDirty = true;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 ssize_t Node::getChildrenCount() const
@@ -594,6 +620,7 @@ void Node::setVisible(bool visible)
         _visible = visible;
         if(_visible)
             _transformUpdated = _transformDirty = _inverseDirty = true;
+        invalidateSubtreeBounds();
     }
 }
 
@@ -615,6 +642,7 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        invalidateSubtreeBounds();
     }
 }
 
@@ -632,6 +660,7 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        invalidateSubtreeBounds();
     }
 }
 
@@ -646,6 +675,7 @@ void Node::setParent(Node * parent)
 {
     _parent = parent;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 /// isRelativeAnchorPoint getter
@@ -660,6 +690,7 @@ void Node::ignoreAnchorPointForPosition(bool newValue)
     {
         _ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        invalidateSubtreeBounds();
     }
 }
 
@@ -1078,6 +1109,7 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
     }
     
     _children.clear();
+    invalidateSubtreeBounds();
 }
 
 void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
@@ -1102,6 +1134,7 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
     child->setParent(nullptr);
 
     _children.erase(childIndex);
+    invalidateSubtreeBounds();
 }
 
 
@@ -1109,6 +1142,7 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
 void Node::insertChild(Node* child, int z)
 {
     _transformUpdated = true;
+    invalidateSubtreeBounds();
     _reorderChildDirty = true;
     _children.pushBack(child);
     child->_localZOrder = z;
@@ -1120,6 +1154,7 @@ void Node::reorderChild(Node *child, int zOrder)
     _reorderChildDirty = true;
     child->setOrderOfArrival(s_globalOrderOfArrival++);
     child->_localZOrder = zOrder;
+    _eventDispatcher->setDirtyForNode(child);
 }
 
 void Node::sortAllChildren()
@@ -1150,7 +1185,7 @@ void Node::visit()
     visit(renderer, parentTransform, true);
 }
 
-uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
+void Node::updateNormalizedPosition(uint32_t parentFlags)
 {
     if(_usingNormalizedPosition)
     {
@@ -1164,6 +1199,11 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
             _normalizedPositionDirty = false;
         }
     }
+}
+
+uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
+{
+    updateNormalizedPosition(parentFlags);
 
     //remove this two line given that isVisitableByVisitingCamera should not affect the calculation of transform given that we are visiting scene
     //without involving view and projection matrix.
@@ -1177,7 +1217,16 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     
 
     if(flags & FLAGS_DIRTY_MASK)
-        _modelViewTransform = this->transform(parentTransform);
+    {
+        // the render workers may have computed it this frame, it is only reused when neither this node
+        // nor its parent changed since then. Otherwise the prepared subtree below is stale as well.
+        unsigned int frame = _director->getTotalFrames();
+        if (_transformPreparedFrame != frame || _transformDirty || _parent == nullptr || _parent->_transformPreparedFrame != frame)
+        {
+            _modelViewTransform = this->transform(parentTransform);
+            _transformPreparedFrame = UINT_MAX;
+        }
+    }
     
     _transformUpdated = false;
     _contentSizeDirty = false;
@@ -1185,6 +1234,110 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     return flags;
 }
 
+void Node::prepareTransforms(const Mat4& parentTransform, uint32_t parentFlags, unsigned int frame)
+{
+    // same as visit(): the flags are left for processParentFlags() to compute them again.
+    // A node that isn't thread safe and its subtree are left to visit().
+    if (!_visible || !isTransformThreadSafe())
+    {
+        return;
+    }
+
+    updateNormalizedPosition(parentFlags);
+
+    uint32_t flags = parentFlags;
+    flags |= (_transformUpdated ? FLAGS_TRANSFORM_DIRTY : 0);
+    flags |= (_contentSizeDirty ? FLAGS_CONTENT_SIZE_DIRTY : 0);
+
+    if(flags & FLAGS_DIRTY_MASK)
+        _modelViewTransform = this->transform(parentTransform);
+    _transformPreparedFrame = frame;
+
+    for (const auto& child : _children)
+        child->prepareTransforms(_modelViewTransform, flags, frame);
+}
+
+void Node::prepareChildrenTransforms(Renderer* renderer, uint32_t flags)
+{
+    auto workers = renderer->getWorkers();
+    // a subtree prepared by an ancestor is already up to date
+    unsigned int frame = _director->getTotalFrames();
+    if (workers == nullptr || _children.size() < 2 || _transformPreparedFrame == frame)
+        return;
+
+    workers->parallelFor(_children.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            _children.at(i)->prepareTransforms(_modelViewTransform, flags, frame);
+    });
+    // the children check it to know that the matrix they were prepared from is still current
+    _transformPreparedFrame = frame;
+}
+
+bool Node::isTransformThreadSafe() const
+{
+    return typeid(*this) == typeid(Node);
+}
+
+void Node::invalidateSubtreeBounds()
+{
+    // a clean node only has clean descendants, so a dirty one only has dirty ancestors
+    for (Node* node = this; node && !node->_subtreeBoundsDirty; node = node->_parent)
+        node->_subtreeBoundsDirty = true;
+}
+
+const Rect& Node::getSubtreeBounds()
+{
+    if (!_subtreeBoundsDirty)
+        return _subtreeBounds;
+
+    // in this node's space first, the content size of labels and widgets is computed on demand
+    Rect bounds;
+    bool infinite = false;
+    const Size& size = getContentSize();
+    if (size.width > 0 && size.height > 0)
+        bounds.size = size;
+    else if (_children.empty())
+        infinite = true;
+
+    for (const auto& child : _children)
+    {
+        // hidden children are computed too, they can't be left dirty under a clean node
+        const Rect& childBounds = child->getSubtreeBounds();
+        if (!child->_visible)
+            continue;
+        // its position follows this node's content size during visit(), the cache would be outdated
+        if (child->_usingNormalizedPosition || child->_subtreeBoundsInfinite)
+        {
+            infinite = true;
+            continue;
+        }
+        if (childBounds.size.width > 0 && childBounds.size.height > 0)
+            bounds = bounds.size.equals(Size::ZERO) ? childBounds : bounds.unionWithRect(childBounds);
+    }
+
+    _subtreeBoundsInfinite = infinite;
+    _subtreeBounds = bounds.size.equals(Size::ZERO) ? Rect::ZERO : RectApplyTransform(bounds, getNodeToParentTransform());
+    _subtreeBoundsDirty = false;
+    return _subtreeBounds;
+}
+
+bool Node::isChildCulled(Renderer* renderer, Node* child, uint32_t flags)
+{
+    if (!_subtreeCulling || !child->_visible)
+        return false;
+
+    const Rect& bounds = child->getSubtreeBounds();
+    if (child->_subtreeBoundsInfinite || child->_usingNormalizedPosition)
+        return false;
+    if (!bounds.size.equals(Size::ZERO) && renderer->checkVisibility(_modelViewTransform, bounds))
+        return false;
+
+    // skipped by visit(), the transform must be computed again when it is back on screen
+    if (flags & FLAGS_DIRTY_MASK)
+        child->_transformUpdated = true;
+    return true;
+}
+
 bool Node::isVisitableByVisitingCamera() const
 {
     auto camera = Camera::getVisitingCamera();
@@ -1215,13 +1368,18 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     if(!_children.empty())
     {
         sortAllChildren();
+        if (_parallelVisit)
+            prepareChildrenTransforms(renderer, flags);
         // draw children zOrder < 0
         for( ; i < _children.size(); i++ )
         {
             auto node = _children.at(i);
 
             if (node && node->_localZOrder < 0)
-                node->visit(renderer, _modelViewTransform, flags);
+            {
+                if (!isChildCulled(renderer, node, flags))
+                    node->visit(renderer, _modelViewTransform, flags);
+            }
             else
                 break;
         }
@@ -1230,7 +1388,10 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
             this->draw(renderer, _modelViewTransform, flags);
 
         for(auto it=_children.cbegin()+i; it != _children.cend(); ++it)
-            (*it)->visit(renderer, _modelViewTransform, flags);
+        {
+            if (!isChildCulled(renderer, *it, flags))
+                (*it)->visit(renderer, _modelViewTransform, flags);
+        }
     }
     else if (visibleByCamera)
     {
@@ -1744,6 +1905,7 @@ void Node::setNodeToParentTransform(const Mat4& transform)
     _transform = transform;
     _transformDirty = false;
     _transformUpdated = true;
+    invalidateSubtreeBounds();
 }
 
 void Node::setAdditionalTransform(const AffineTransform& additionalTransform)
@@ -1765,6 +1927,7 @@ void Node::setAdditionalTransform(Mat4* additionalTransform)
         _useAdditionalTransform = true;
     }
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    invalidateSubtreeBounds();
 }
 
 
@@ -1153,6 +1153,44 @@ public:
     virtual void visit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags);
     virtual void visit() final;
 
+    /**
+     * Sets whether the transforms of the children subtrees are updated in parallel, on the worker threads
+     * of the renderer (see Renderer::setWorkerThreadCount), before they are visited.
+     * Use it on nodes with many independent children, e.g. a layer of thousands of sprites or particles.
+     * The subtrees must not override visit() with another transform than their parent's model view.
+     * Only the nodes for which isTransformThreadSafe() returns true are updated on the workers, the others and
+     * their subtrees are updated by visit() as usual. A node moved after the update, e.g. by the visit of a
+     * sibling, is updated again by visit().
+     *
+     * @param parallelVisit Whether the children subtrees are updated in parallel, false by default.
+     */
+    void setParallelVisit(bool parallelVisit) { _parallelVisit = parallelVisit; }
+    /** Returns whether the transforms of the children subtrees are updated in parallel. */
+    bool isParallelVisit() const { return _parallelVisit; }
+
+    /**
+     * Returns whether the transform of this node may be computed on a render worker, see setParallelVisit().
+     * getNodeToParentTransform() can be overridden with code that isn't thread safe, so only plain Node and
+     * Sprite instances return true. A subclass which keeps Node::getNodeToParentTransform() may override it to
+     * return true.
+     */
+    virtual bool isTransformThreadSafe() const;
+
+    /**
+     * Sets whether visit() skips the children subtrees that are entirely off-screen, e.g. on the content of
+     * a large scrolling map or the inner container of a long ListView.
+     * The bounds of each subtree are cached in its parent's space and only computed again when a node below
+     * moves, resizes, or is added, removed, shown or hidden, so scrolling this node costs nothing.
+     * Every node of the subtrees must draw within its content size. A node without content size is treated
+     * as a container: it is never culled on its own, but a parent only sees the bounds of its children.
+     * Only the default camera culls, like Sprite does.
+     *
+     * @param subtreeCulling Whether the off-screen children subtrees are skipped, false by default.
+     */
+    void setSubtreeCulling(bool subtreeCulling) { _subtreeCulling = subtreeCulling; }
+    /** Returns whether the off-screen children subtrees are skipped. */
+    bool isSubtreeCulling() const { return _subtreeCulling; }
+
 
     /** Returns the Scene that contains the Node.
      It returns `nullptr` if the node doesn't belong to any Scene.
@@ -1736,6 +1774,17 @@ protected:
 
     Mat4 transform(const Mat4 &parentTransform);
     uint32_t processParentFlags(const Mat4& parentTransform, uint32_t parentFlags);
+    void updateNormalizedPosition(uint32_t parentFlags);
+    // computes the model view transforms of this subtree ahead of visit(), from a worker thread
+    void prepareTransforms(const Mat4& parentTransform, uint32_t parentFlags, unsigned int frame);
+    void prepareChildrenTransforms(Renderer* renderer, uint32_t flags);
+
+    /// marks the cached bounds of this node and its ancestors to be computed again
+    void invalidateSubtreeBounds();
+    /// bounds of this node and its visible descendants in the parent's space, infinite if unknown
+    const Rect& getSubtreeBounds();
+    /// whether a child subtree is off-screen and can be skipped by visit(), see setSubtreeCulling
+    bool isChildCulled(Renderer* renderer, Node* child, uint32_t flags);
 
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
@@ -1797,6 +1846,12 @@ protected:
     mutable Mat4 _additionalTransform; ///< transform
     bool _useAdditionalTransform;   ///< The flag to check whether the additional transform is dirty
     bool _transformUpdated;         ///< Whether or not the Transform object was updated since the last frame
+    bool _parallelVisit;            ///< Whether the children transforms are updated on the render workers
+    unsigned int _transformPreparedFrame; ///< Frame in which _modelViewTransform was prepared for the render workers
+    bool _subtreeCulling;           ///< Whether the off-screen children subtrees are skipped by visit()
+    bool _subtreeBoundsDirty;       ///< Whether _subtreeBounds must be computed again, clean implies clean children
+    Rect _subtreeBounds;            ///< Bounds of this subtree in the parent's space, null when it draws nothing
+    bool _subtreeBoundsInfinite;    ///< Whether the subtree can't be bounded, it is then never culled
 
     int _localZOrder;               ///< Local order (relative to its siblings) used to sort the node
     float _globalZOrder;            ///< Global order used to sort the node
@@ -1871,6 +1926,9 @@ public:
     friend class PhysicsBody;
 #endif
 
+    // reads the transform cached by visit() to skip listeners away from a touch
+    friend class EventDispatcher;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
 };
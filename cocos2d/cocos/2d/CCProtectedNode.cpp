@@ -277,7 +277,10 @@ void ProtectedNode::visit(Renderer* renderer, const Mat4 &parentTransform, uint3
         auto node = _children.at(i);
         
         if ( node && node->getLocalZOrder() < 0 )
-            node->visit(renderer, _modelViewTransform, flags);
+        {
+            if (!isChildCulled(renderer, node, flags))
+                node->visit(renderer, _modelViewTransform, flags);
+        }
         else
             break;
     }
@@ -305,7 +308,10 @@ void ProtectedNode::visit(Renderer* renderer, const Mat4 &parentTransform, uint3
         (*it)->visit(renderer, _modelViewTransform, flags);
     
     for(auto it=_children.cbegin()+i; it != _children.cend(); ++it)
-        (*it)->visit(renderer, _modelViewTransform, flags);
+    {
+        if (!isChildCulled(renderer, *it, flags))
+            (*it)->visit(renderer, _modelViewTransform, flags);
+    }
     
     // FIX ME: Why need to set _orderOfArrival to 0??
     // Please refer to https://github.com/cocos2d/cocos2d-x/pull/6920
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "2d/CCSprite.h"
 
 #include <algorithm>
+#include <typeinfo>
 
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCAnimationCache.h"
@@ -36,6 +37,7 @@ THE SOFTWARE.
 #include "renderer/CCTextureCache.h"
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCRenderArena.h"
 #include "base/CCDirector.h"
 #include "2d/CCCamera.h"
 
@@ -625,6 +627,12 @@ void Sprite::updateTransform(void)
     Node::updateTransform();
 }
 
+bool Sprite::isTransformThreadSafe() const
+{
+    // Sprite keeps Node::getNodeToParentTransform(), a subclass may not
+    return typeid(*this) == typeid(Sprite);
+}
+
 // draw
 
 void Sprite::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
@@ -644,8 +652,10 @@ void Sprite::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     if(_insideBounds)
 #endif
     {
+        // the member keeps the material id between frames, a copy is queued so the sprite can be drawn
+        // several times in a frame, e.g. by two cameras or into a RenderTexture
         _trianglesCommand.init(_globalZOrder, _texture->getName(), getGLProgramState(), _blendFunc, _polyInfo.triangles, transform, flags);
-        renderer->addCommand(&_trianglesCommand);
+        renderer->addCommand(renderer->getFrameArena()->create<TrianglesCommand>(_trianglesCommand));
         
 #if CC_SPRITE_DEBUG_DRAW
         _debugDrawNode->clear();
@@ -132,6 +132,8 @@ Mesh::Mesh()
 , _visibleChanged(nullptr)
 , _blendDirty(true)
 , _force2DQueue(false)
+, _instanceTransforms(nullptr)
+, _instanceCount(0)
 , _texFile("")
 {
     
@@ -399,6 +401,7 @@ void Mesh::draw(Renderer* renderer, float globalZOrder, const Mat4& transform, u
         _material->getStateBlock()->setDepthWrite(true);
 
 
+    _meshCommand.setInstanceTransforms(_instanceTransforms, _instanceCount);
     _meshCommand.setSkipBatching(isTransparent);
     _meshCommand.setTransparent(isTransparent);
     _meshCommand.set3D(!_force2DQueue);
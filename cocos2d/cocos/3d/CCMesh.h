@@ -225,6 +225,12 @@ public:
      */
     void setForce2DQueue(bool force2D) { _force2DQueue = force2D; }
 
+    /**
+     * draws the mesh once per transform, see MeshCommand::setInstanceTransforms
+     * @note the transforms are not copied, they must stay valid until the frame is drawn
+     */
+    void setInstanceTransforms(const Mat4* transforms, ssize_t count) { _instanceTransforms = transforms; _instanceCount = count; }
+
     std::string getTextureFileName(){ return _texFile; }
 
 CC_CONSTRUCTOR_ACCESS:
@@ -242,6 +248,8 @@ protected:
     bool                _visible; // is the submesh visible
     bool                _isTransparent; // is this mesh transparent, it is a property of material in fact
     bool                _force2DQueue; // add this mesh to 2D render queue
+    const Mat4*         _instanceTransforms; // draw once per transform, weak ref
+    ssize_t             _instanceCount;
     
     std::string         _name;
     MeshCommand         _meshCommand;
@@ -755,7 +755,8 @@ void Sprite3D::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
 #if CC_USE_CULLING
     // camera clipping
-    if(_children.size() == 0 && Camera::getVisitingCamera() && !Camera::getVisitingCamera()->isVisibleInFrustum(&getAABB()))
+    // the AABB doesn't cover the instances
+    if(_children.size() == 0 && _instanceTransforms.empty() && Camera::getVisitingCamera() && !Camera::getVisitingCamera()->isVisibleInFrustum(&getAABB()))
         return;
 #endif
     
@@ -786,6 +787,7 @@ void Sprite3D::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     
     for (auto mesh: _meshes)
     {
+        mesh->setInstanceTransforms(_instanceTransforms.empty() ? nullptr : _instanceTransforms.data(), (ssize_t)_instanceTransforms.size());
         mesh->draw(renderer,
                    _globalZOrder,
                    transform,
@@ -158,6 +158,15 @@ public:
      */
     void setForceDepthWrite(bool value) { _forceDepthWrite = value; }
     bool isForceDepthWrite() const { return _forceDepthWrite;};
+
+    /**
+     * Draws the sprite once per transform, each one applied before the transform of the sprite, e.g. the
+     * trees of a forest or the members of a crowd. With a program reading the a_instanceTransform attribute
+     * (GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED) each mesh is drawn by one instanced draw call where
+     * supported, any other program draws the meshes once per transform. An empty list draws the sprite once.
+     */
+    void setInstanceTransforms(const std::vector<Mat4>& transforms) { _instanceTransforms = transforms; }
+    const std::vector<Mat4>& getInstanceTransforms() const { return _instanceTransforms; }
     
     /**
      * Returns 2d bounding-box
@@ -264,6 +273,7 @@ protected:
     unsigned int                 _lightMask;
     bool                         _shaderUsingLight; // is current shader using light ?
     bool                         _forceDepthWrite; // Always write to depth buffer
+    std::vector<Mat4>            _instanceTransforms; // draw once per transform when not empty
     bool                         _usingAutogeneratedGLProgram;
     
     struct AsyncLoadParam
@@ -109,6 +109,7 @@ math/Vec4.cpp \
 base/CCNinePatchImageParser.cpp \
 base/CCStencilStateManager.cpp \
 base/CCAsyncTaskPool.cpp \
+base/CCJobSystem.cpp \
 base/CCAutoreleasePool.cpp \
 base/CCConfiguration.cpp \
 base/CCConsole.cpp \
@@ -175,8 +176,12 @@ renderer/CCPass.cpp \
 renderer/CCPrimitive.cpp \
 renderer/CCPrimitiveCommand.cpp \
 renderer/CCQuadCommand.cpp \
+renderer/CCInstancedQuadCommand.cpp \
 renderer/CCRenderCommand.cpp \
 renderer/CCRenderState.cpp \
+renderer/CCRenderArena.cpp \
+renderer/CCRenderWorkers.cpp \
+renderer/CCStreamingBuffer.cpp \
 renderer/CCRenderer.cpp \
 renderer/CCTechnique.cpp \
 renderer/CCTexture2D.cpp \
@@ -25,10 +25,10 @@
 #include "platform/CCPlatformConfig.h"
 
 #include "audio/include/AudioEngine.h"
-#include <condition_variable>
-#include <queue>
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
+#include "base/CCJobSystem.h"
+#include <algorithm>
 
 #if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
 #include "android/AudioEngine-inl.h"
@@ -63,90 +63,21 @@ AudioEngine::ProfileHelper* AudioEngine::_defaultProfileHelper = nullptr;
 std::unordered_map<int, AudioEngine::AudioInfo> AudioEngine::_audioIDInfoMap;
 AudioEngineImpl* AudioEngine::_audioEngineImpl = nullptr;
 
-AudioEngine::AudioEngineThreadPool* AudioEngine::s_threadPool = nullptr;
+// decoding tasks run on the JobSystem, end() waits for them before the caches go away
+static std::vector<JobSystem::JobHandle> s_tasks;
 
-class AudioEngine::AudioEngineThreadPool
+void AudioEngine::end()
 {
-public:
-    AudioEngineThreadPool(bool detach, int threads = 4)
-        : _detach(detach)
-        , _stop(false)
-    {
-        for (int index = 0; index < threads; ++index)
-        {
-            _workers.emplace_back(std::thread(std::bind(&AudioEngineThreadPool::threadFunc, this)));
-            if (_detach)
-            {
-                _workers[index].detach();
-            }
-        }
-    }
-
-    void addTask(const std::function<void()> &task){
-        std::unique_lock<std::mutex> lk(_queueMutex);
-        _taskQueue.emplace(task);
-        _taskCondition.notify_one();
-    }
-
-    ~AudioEngineThreadPool()
+    // end() usually runs after Director::reset(), which stopped the JobSystem: nothing is left to wait for then.
+    auto jobSystem = JobSystem::getInstanceIfStarted();
+    if (jobSystem)
     {
+        for (auto& task : s_tasks)
         {
-            std::unique_lock<std::mutex> lk(_queueMutex);
-            _stop = true;
-            _taskCondition.notify_all();
-        }
-
-        if (!_detach)
-        {
-            for (auto&& worker : _workers) {
-                worker.join();
-            }
-        }
-    }
-
-private:
-    void threadFunc()
-    {
-        while (true) {
-            std::function<void()> task = nullptr;
-            {
-                std::unique_lock<std::mutex> lk(_queueMutex);
-                if (_stop)
-                {
-                    break;
-                }
-                if (!_taskQueue.empty())
-                {
-                    task = std::move(_taskQueue.front());
-                    _taskQueue.pop();
-                }
-                else
-                {
-                    _taskCondition.wait(lk);
-                    continue;
-                }
-            }
-
-            task();
+            jobSystem->wait(task);
         }
     }
-
-    std::vector<std::thread>  _workers;
-    std::queue< std::function<void()> > _taskQueue;
-
-    std::mutex _queueMutex;
-    std::condition_variable _taskCondition;
-    bool _detach;
-    bool _stop;
-};
-
-void AudioEngine::end()
-{
-    if (s_threadPool)
-    {
-        delete s_threadPool;
-        s_threadPool = nullptr;
-    }
+    s_tasks.clear();
 
     delete _audioEngineImpl;
     _audioEngineImpl = nullptr;
@@ -167,18 +98,6 @@ bool AudioEngine::lazyInit()
         }
     }
 
-#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
-    if (_audioEngineImpl && s_threadPool == nullptr)
-    {
-        s_threadPool = new (std::nothrow) AudioEngineThreadPool(true);
-    }
-#elif CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID
-    if (_audioEngineImpl && s_threadPool == nullptr)
-    {
-        s_threadPool = new (std::nothrow) AudioEngineThreadPool(false);
-    }
-#endif
-
     return true;
 }
 
@@ -533,8 +452,9 @@ void AudioEngine::addTask(const std::function<void()>& task)
 {
     lazyInit();
 
-    if (_audioEngineImpl && s_threadPool)
+    if (_audioEngineImpl)
     {
-        s_threadPool->addTask(task);
+        s_tasks.erase(std::remove_if(s_tasks.begin(), s_tasks.end(), JobSystem::isDone), s_tasks.end());
+        s_tasks.push_back(JobSystem::getInstance()->schedule(task, nullptr, JobSystem::Priority::HIGH));
     }
 }
@@ -345,9 +345,6 @@ protected:
     static ProfileHelper* _defaultProfileHelper;
     
     static AudioEngineImpl* _audioEngineImpl;
-
-    class AudioEngineThreadPool;
-    static AudioEngineThreadPool* s_threadPool;
     
     friend class AudioEngineImpl;
 };
@@ -46,6 +46,10 @@ void AsyncTaskPool::destoryInstance()
 
 AsyncTaskPool::AsyncTaskPool()
 {
+    for (auto& stopCount : _stopCounts)
+    {
+        stopCount = std::make_shared<std::atomic<unsigned int>>(0);
+    }
 }
 
 AsyncTaskPool::~AsyncTaskPool()
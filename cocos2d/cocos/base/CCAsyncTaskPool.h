@@ -28,15 +28,14 @@ THE SOFTWARE.
 #include "platform/CCPlatformMacros.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
-#include <vector>
-#include <queue>
-#include <memory>
-#include <thread>
-#include <mutex>
+#include "base/CCJobSystem.h"
+#include <atomic>
 #include <condition_variable>
-#include <future>
+#include <memory>
 #include <functional>
-#include <stdexcept>
+#include <mutex>
+#include <queue>
+#include <thread>
 
 /**
 * @addtogroup base
@@ -48,6 +47,10 @@ NS_CC_BEGIN
 /**
  * @class AsyncTaskPool
  * @brief This class allows to perform background operations without having to manipulate threads.
+ *
+ * IO and other tasks run on the workers of the JobSystem: tasks of the same type may run in parallel and no longer
+ * run in the order they were enqueued. Network tasks block on I/O, so they keep a thread of their own and run one
+ * after the other in FIFO order, without holding up the CPU workers.
  * @js NA
  */
 class CC_DLL AsyncTaskPool
@@ -75,6 +78,8 @@ public:
     
     /**
      * Stop tasks.
+     * The tasks of this type which didn't start yet are dropped, and so are their callbacks. IO and other tasks
+     * don't run in FIFO order, so which of them already started doesn't follow the order they were enqueued in.
      *
      * @param type Task type you want to stop.
      */
@@ -83,7 +88,8 @@ public:
     /**
      * Enqueue a asynchronous task.
      *
-     * @param type task type is io task, network task or others, each type of task has a thread to deal with it.
+     * @param type task type is io task, network task or others. Io and other tasks run on the JobSystem workers, in no
+     * particular order and possibly in parallel; network tasks run one by one, in FIFO order, on a thread of their own.
      * @param callback callback when the task is finished. The callback is called in the main thread instead of task thread.
      * @param callbackParam parameter used by the callback.
      * @param f task can be lambda function.
@@ -98,7 +104,7 @@ CC_CONSTRUCTOR_ACCESS:
     
 protected:
     
-    // thread tasks internally used
+    // the thread running the network tasks, which would starve the JobSystem workers while they wait for the network
     class ThreadTasks {
         struct AsyncTaskCallBack
         {
@@ -129,7 +135,10 @@ protected:
                                           }
                                           
                                           task();
-                                          Director::getInstance()->getScheduler()->performFunctionInCocosThread([&, callback]{ callback.callback(callback.callbackParam); });
+                                          if (callback.callback)
+                                          {
+                                              Director::getInstance()->getScheduler()->performFunctionInCocosThread([callback]{ callback.callback(callback.callbackParam); });
+                                          }
                                       }
                                   }
                                   );
@@ -156,11 +165,8 @@ protected:
             while (_taskCallBacks.size())
                 _taskCallBacks.pop();
         }
-        template<class F>
-        void enqueue(const TaskCallBack& callback, void* callbackParam, F&& f)
+        void enqueue(const TaskCallBack& callback, void* callbackParam, const std::function<void()>& task)
         {
-            auto task = f;//std::bind(std::forward<F>(f), std::forward<Args>(args)...);
-            
             {
                 std::unique_lock<std::mutex> lock(_queueMutex);
                 
@@ -174,7 +180,7 @@ protected:
                 AsyncTaskCallBack taskCallBack;
                 taskCallBack.callback = callback;
                 taskCallBack.callbackParam = callbackParam;
-                _tasks.emplace([task](){ task(); });
+                _tasks.emplace(task);
                 _taskCallBacks.emplace(taskCallBack);
             }
             _condition.notify_one();
@@ -193,24 +199,51 @@ protected:
         bool _stop;
     };
     
-    //tasks
-    ThreadTasks _threadTasks[int(TaskType::TASK_MAX_TYPE)];
+    ThreadTasks _networkTasks;
+
+    // bumped by stopTasks, the JobSystem tasks enqueued before are skipped. Shared with the jobs, which may outlive the pool.
+    std::shared_ptr<std::atomic<unsigned int>> _stopCounts[int(TaskType::TASK_MAX_TYPE)];
     
     static AsyncTaskPool* s_asyncTaskPool;
 };
 
 inline void AsyncTaskPool::stopTasks(TaskType type)
 {
-    auto& threadTask = _threadTasks[(int)type];
-    threadTask.clear();
+    if (type == TaskType::TASK_NETWORK)
+    {
+        _networkTasks.clear();
+        return;
+    }
+    ++*_stopCounts[(int)type];
 }
 
 template<class F>
 inline void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, const TaskCallBack& callback, void* callbackParam, F&& f)
 {
-    auto& threadTask = _threadTasks[(int)type];
+    std::function<void()> task(std::forward<F>(f));
+    if (type == TaskType::TASK_NETWORK)
+    {
+        _networkTasks.enqueue(callback, callbackParam, task);
+        return;
+    }
+
+    auto stopCount = _stopCounts[(int)type];
+    unsigned int enqueuedCount = *stopCount;
+    auto ran = std::make_shared<bool>(false);
     
-    threadTask.enqueue(callback, callbackParam, f);
+    JobSystem::getInstance()->schedule([task, stopCount, enqueuedCount, ran]() {
+            if (*stopCount == enqueuedCount)
+            {
+                task();
+                *ran = true;
+            }
+        },
+        [callback, callbackParam, ran]() {
+            if (*ran && callback)
+            {
+                callback(callbackParam);
+            }
+        });
 }
 
 
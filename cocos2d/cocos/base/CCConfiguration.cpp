@@ -49,6 +49,8 @@ Configuration::Configuration()
 , _supportsBGRA8888(false)
 , _supportsDiscardFramebuffer(false)
 , _supportsShareableVAO(false)
+, _supportsMapBufferRange(false)
+, _supportsInstancing(false)
 , _maxSamplesAllowed(0)
 , _maxTextureUnits(0)
 , _glExtensions(nullptr)
@@ -150,6 +152,16 @@ void Configuration::gatherGPUInfo()
     _supportsShareableVAO = checkForGLExtension("vertex_array_object");
 	_valueDict["gl.supports_vertex_array_object"] = Value(_supportsShareableVAO);
 
+    _supportsMapBufferRange = checkForGLExtension("map_buffer_range");
+    _valueDict["gl.supports_map_buffer_range"] = Value(_supportsMapBufferRange);
+
+    _supportsInstancing = checkForGLExtension("instanced_arrays");
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    // the entry points are loaded at run time
+    _supportsInstancing = _supportsInstancing && glDrawElementsInstanced && glVertexAttribDivisor;
+#endif
+    _valueDict["gl.supports_instancing"] = Value(_supportsInstancing);
+
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -250,6 +262,16 @@ bool Configuration::supportsDiscardFramebuffer() const
 	return _supportsDiscardFramebuffer;
 }
 
+bool Configuration::supportsMapBufferRange() const
+{
+    return _supportsMapBufferRange;
+}
+
+bool Configuration::supportsInstancing() const
+{
+    return _supportsInstancing;
+}
+
 bool Configuration::supportsShareableVAO() const
 {
 #if CC_TEXTURE_ATLAS_USE_VAO
@@ -145,6 +145,18 @@ public:
      * @since v2.0.0
      */
 	bool supportsShareableVAO() const;
+
+    /** Whether or not glMapBufferRange is supported (GL_ARB_map_buffer_range, GL_EXT_map_buffer_range).
+     *
+     * @return Is true if supports glMapBufferRange.
+     */
+    bool supportsMapBufferRange() const;
+
+    /** Whether or not instanced drawing is supported (GL_ARB_instanced_arrays, GL_EXT_instanced_arrays, GL_ANGLE_instanced_arrays).
+     *
+     * @return Is true if supports glDrawElementsInstanced and glVertexAttribDivisor.
+     */
+    bool supportsInstancing() const;
     
     /** Max support directional light in shader, for Sprite3D.
      *
@@ -232,6 +244,8 @@ protected:
     bool            _supportsBGRA8888;
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
+    bool            _supportsMapBufferRange;
+    bool            _supportsInstancing;
     GLint           _maxSamplesAllowed;
     GLint           _maxTextureUnits;
     char *          _glExtensions;
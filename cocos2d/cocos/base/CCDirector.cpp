@@ -60,6 +60,7 @@ THE SOFTWARE.
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCJobSystem.h"
 #include "platform/CCApplication.h"
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -293,6 +294,7 @@ void Director::drawScene()
 #endif
         //clear draw stats
         _renderer->clearDrawStats();
+        GL::resetStateStats();
         
         //render the scene
         _runningScene->render(_renderer);
@@ -950,6 +952,9 @@ void Director::reset()
     CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
     CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
     
+    // the running jobs finish before FileUtils and the caches they use go away, the queued ones are dropped
+    JobSystem::destroyInstance();
+    
     // purge bitmap cache
     FontFNT::purgeCachedData();
     
@@ -201,7 +201,6 @@ void EventDispatcher::EventListenerVector::clear()
 EventDispatcher::EventDispatcher()
 : _inDispatch(0)
 , _isEnabled(false)
-, _nodePriorityIndex(0)
 {
     _toAddedListeners.reserve(50);
     _toRemovedListeners.reserve(50);
@@ -221,73 +220,78 @@ EventDispatcher::~EventDispatcher()
     removeAllEventListeners();
 }
 
-void EventDispatcher::visitTarget(Node* node, bool isRootNode)
+void EventDispatcher::updateNodeOrder(Node* node, NodeOrder& order)
 {
-    node->sortAllChildren();
-    
-    int i = 0;
-    auto& children = node->getChildren();
-    
-    auto childrenCount = children.size();
-    
-    if(childrenCount > 0)
+    // Built from the node up and reversed. The node itself is 0, between its children with a negative
+    // local Z order (2 * z + 1 < 0) and the others (2 * z + 1 > 0), like Node::visit() draws them.
+    order.globalZOrder = node->getGlobalZOrder();
+    order.path.clear();
+    order.path.push_back(0);
+
+    Node* root = node;
+    for (Node* parent = node->getParent(); parent != nullptr; parent = parent->getParent())
     {
-        Node* child = nullptr;
-        // visit children zOrder < 0
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            
-            if ( child && child->getLocalZOrder() < 0 )
-                visitTarget(child, false);
-            else
-                break;
-        }
-        
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
-        
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            if (child)
-                visitTarget(child, false);
-        }
+        order.path.push_back(root->getOrderOfArrival());
+        order.path.push_back(2LL * root->getLocalZOrder() + 1);
+        root = parent;
     }
-    else
+    std::reverse(order.path.begin(), order.path.end());
+    order.root = root;
+}
+
+bool EventDispatcher::isDrawnAfter(const NodeOrder& order1, const NodeOrder& order2, Node* root)
+{
+    // nodes out of the running scene come last
+    bool inScene1 = (order1.root == root);
+    bool inScene2 = (order2.root == root);
+    if (inScene1 != inScene2 || !inScene1)
     {
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
+        return inScene1 && !inScene2;
     }
-    
-    if (isRootNode)
+
+    if (order1.globalZOrder != order2.globalZOrder)
     {
-        std::vector<float> globalZOrders;
-        globalZOrders.reserve(_globalZOrderNodeMap.size());
-        
-        for (const auto& e : _globalZOrderNodeMap)
-        {
-            globalZOrders.push_back(e.first);
-        }
-        
-        std::sort(globalZOrders.begin(), globalZOrders.end(), [](const float a, const float b){
-            return a < b;
-        });
-        
-        for (const auto& globalZ : globalZOrders)
+        return order1.globalZOrder > order2.globalZOrder;
+    }
+    return order2.path < order1.path;
+}
+
+bool EventDispatcher::isPointOutsideNode(const Vec2& worldPoint, Node* node)
+{
+    const Size& size = node->getContentSize();
+    if (size.width <= 0 || size.height <= 0)
+    {
+        return false;
+    }
+
+    // The transform cached by the last visit() is only used if nothing moved since, else the
+    // listener gets the touch as usual. visit() composes the transform of the scene twice.
+    Node* root = node;
+    for (Node* n = node; n != nullptr; n = n->_parent)
+    {
+        if (n->_transformUpdated || n->_contentSizeDirty || n->_normalizedPositionDirty)
         {
-            for (const auto& n : _globalZOrderNodeMap[globalZ])
-            {
-                _nodePriorityMap[n] = ++_nodePriorityIndex;
-            }
+            return false;
         }
-        
-        _globalZOrderNodeMap.clear();
+        root = n;
+    }
+    if (!root->getNodeToParentTransform().isIdentity())
+    {
+        return false;
     }
+
+    const Mat4& transform = node->_modelViewTransform;
+    if (transform.m[2] != 0 || transform.m[6] != 0 || transform.m[14] != 0
+        || transform.m[3] != 0 || transform.m[7] != 0 || transform.m[11] != 0 || transform.m[15] != 1)
+    {
+        return false;
+    }
+
+    // a margin for the rounding of the ray intersection of the hit tests
+    static const float MARGIN = 1.0f;
+    Rect bounds = RectApplyTransform(Rect(0, 0, size.width, size.height), transform);
+    return worldPoint.x < bounds.getMinX() - MARGIN || worldPoint.x > bounds.getMaxX() + MARGIN
+        || worldPoint.y < bounds.getMinY() - MARGIN || worldPoint.y > bounds.getMaxY() + MARGIN;
 }
 
 void EventDispatcher::pauseEventListenersForTarget(Node* target, bool recursive/* = false */)
@@ -356,7 +360,7 @@ void EventDispatcher::removeEventListenersForTarget(Node* target, bool recursive
 {
     // Ensure the node is removed from these immediately also.
     // Don't want any dangling pointers or the possibility of dealing with deleted objects..
-    _nodePriorityMap.erase(target);
+    _nodeOrderMap.erase(target);
     _dirtyNodes.erase(target);
 
     auto listenerIter = _nodeListenersMap.find(target);
@@ -435,6 +439,7 @@ void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener*
         if (listeners->empty())
         {
             _nodeListenersMap.erase(found);
+            _nodeOrderMap.erase(node);
             delete listeners;
         }
     }
@@ -545,8 +550,8 @@ void EventDispatcher::debugCheckNodeHasNoEventListenersOnDestruction(Node* node)
         }
     }
     
-    // Check the node priority map
-    for (const auto & keyValuePair : _nodePriorityMap)
+    // Check the node order map
+    for (const auto & keyValuePair : _nodeOrderMap)
     {
         CCASSERT(keyValuePair.first != node,
                  "Node should have no event listeners registered for it upon destruction!");
@@ -967,12 +972,40 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
         {
             bool isSwallowed = false;
 
+            // where the touch hits the z = 0 plane, for the listeners culled by the bounds of their node
+            const Camera* worldPointCamera = nullptr;
+            bool hasWorldPoint = false;
+            Vec2 worldPoint;
+
             auto onTouchEvent = [&](EventListener* l) -> bool { // Return true to break
                 EventListenerTouchOneByOne* listener = static_cast<EventListenerTouchOneByOne*>(l);
                 
                 // Skip if the listener was removed.
                 if (!listener->_isRegistered)
                     return false;
+                
+                // Skip without calling onTouchBegan if the touch begins away from the node.
+                if (listener->_touchBoundsCulling && listener->_node != nullptr
+                    && event->getEventCode() == EventTouch::EventCode::BEGAN && Camera::getVisitingCamera() != nullptr)
+                {
+                    const Camera* camera = Camera::getVisitingCamera();
+                    if (camera != worldPointCamera)
+                    {
+                        const Vec2& location = (*touchesIter)->getLocation();
+                        Vec3 nearPoint = camera->unprojectGL(Vec3(location.x, location.y, -1));
+                        Vec3 farPoint = camera->unprojectGL(Vec3(location.x, location.y, 1));
+                        float dz = farPoint.z - nearPoint.z;
+                        hasWorldPoint = fabsf(dz) > FLT_EPSILON;
+                        if (hasWorldPoint)
+                        {
+                            float t = -nearPoint.z / dz;
+                            worldPoint.set(nearPoint.x + (farPoint.x - nearPoint.x) * t, nearPoint.y + (farPoint.y - nearPoint.y) * t);
+                        }
+                        worldPointCamera = camera;
+                    }
+                    if (hasWorldPoint && isPointOutsideNode(worldPoint, listener->_node))
+                        return false;
+                }
              
                 event->setCurrentTarget(listener->_node);
                 
@@ -1257,6 +1290,8 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
                     setDirty(l->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
                 }
             }
+            // computed again by the next sort
+            _nodeOrderMap.erase(node);
         }
         
         _dirtyNodes.clear();
@@ -1309,22 +1344,42 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
     if (sceneGraphListeners == nullptr)
         return;
 
-    // Reset priority index
-    _nodePriorityIndex = 0;
-    _nodePriorityMap.clear();
+    // Only the nodes marked dirty since the last sort compute their order again, instead of visiting the whole scene.
+    static const NodeOrder REMOVED_NODE_ORDER = { nullptr, 0, {} };
+    std::vector<std::pair<const NodeOrder*, EventListener*>> orderedListeners;
+    orderedListeners.reserve(sceneGraphListeners->size());
+    for (auto& l : *sceneGraphListeners)
+    {
+        Node* node = l->getAssociatedNode();
+        if (node == nullptr)
+        {
+            orderedListeners.push_back(std::make_pair(&REMOVED_NODE_ORDER, l));
+            continue;
+        }
+
+        auto iter = _nodeOrderMap.find(node);
+        if (iter == _nodeOrderMap.end())
+        {
+            iter = _nodeOrderMap.insert(std::make_pair(node, NodeOrder())).first;
+            updateNodeOrder(node, iter->second);
+        }
+        orderedListeners.push_back(std::make_pair(&iter->second, l));
+    }
 
-    visitTarget(rootNode, true);
-    
     // After sort: priority < 0, > 0
-    std::sort(sceneGraphListeners->begin(), sceneGraphListeners->end(), [this](const EventListener* l1, const EventListener* l2) {
-        return _nodePriorityMap[l1->getAssociatedNode()] > _nodePriorityMap[l2->getAssociatedNode()];
+    std::sort(orderedListeners.begin(), orderedListeners.end(), [rootNode](const std::pair<const NodeOrder*, EventListener*>& l1, const std::pair<const NodeOrder*, EventListener*>& l2) {
+        return isDrawnAfter(*l1.first, *l2.first, rootNode);
     });
+    for (size_t i = 0; i < orderedListeners.size(); ++i)
+    {
+        (*sceneGraphListeners)[i] = orderedListeners[i].second;
+    }
     
 #if DUMP_LISTENER_ITEM_PRIORITY_INFO
     log("-----------------------------------");
-    for (auto& l : *sceneGraphListeners)
+    for (auto& l : orderedListeners)
     {
-        log("listener priority: node ([%s]%p), priority (%d)", typeid(*l->_node).name(), l->_node, _nodePriorityMap[l->_node]);
+        log("listener priority: node ([%s]%p), global z (%f), depth (%d)", l.second->_node ? typeid(*l.second->_node).name() : "", l.second->_node, l.first->globalZOrder, (int)l.first->path.size() / 2);
     }
 #endif
 }
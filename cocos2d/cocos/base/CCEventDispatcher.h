@@ -32,6 +32,7 @@
 #include <set>
 
 #include "platform/CCPlatformMacros.h"
+#include "math/Vec2.h"
 #include "base/CCEventListener.h"
 #include "base/CCEvent.h"
 #include "platform/CCStdC.h"
@@ -298,8 +299,25 @@ protected:
     /** Sets the dirty flag for a specified listener ID */
     void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
     
-    /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
-    void visitTarget(Node* node, bool isRootNode);
+    /** Draw order of a node in the scene graph: its global Z order first, then its path from the root.
+     *  Each level of the path is the local Z order and order of arrival of the node in its parent, so the paths of
+     *  two nodes compare like their positions in Node::visit(). Only computed again for the nodes marked dirty.
+     */
+    struct NodeOrder
+    {
+        Node* root;
+        float globalZOrder;
+        std::vector<long long> path;
+    };
+
+    /** Computes the draw order of a node, it's called before sorting event listener with scene graph priority */
+    void updateNodeOrder(Node* node, NodeOrder& order);
+
+    /** Whether a node is drawn after another one in the scene graph of root, its listeners get the events first */
+    static bool isDrawnAfter(const NodeOrder& order1, const NodeOrder& order2, Node* root);
+
+    /** Whether a touch at worldPoint, on the z = 0 plane, certainly misses the content box of node as drawn in the last frame */
+    static bool isPointOutsideNode(const Vec2& worldPoint, Node* node);
 
     /** Remove all listeners in _toRemoveListeners list and cleanup */
     void cleanToRemovedListeners();
@@ -313,11 +331,8 @@ protected:
     /** The map of node and event listeners */
     std::unordered_map<Node*, std::vector<EventListener*>*> _nodeListenersMap;
     
-    /** The map of node and its event priority */
-    std::unordered_map<Node*, int> _nodePriorityMap;
-    
-    /** key: Global Z Order, value: Sorted Nodes */
-    std::unordered_map<float, std::vector<Node*>> _globalZOrderNodeMap;
+    /** The map of node and its draw order */
+    std::unordered_map<Node*, NodeOrder> _nodeOrderMap;
     
     /** The listeners to be added after dispatching event */
     std::vector<EventListener*> _toAddedListeners;
@@ -334,8 +349,6 @@ protected:
     /** Whether to enable dispatching event */
     bool _isEnabled;
     
-    int _nodePriorityIndex;
-    
     std::set<std::string> _internalCustomListenerIDs;
 };
 
@@ -67,6 +67,22 @@ public:
      * @return True if needs to swall touches.
      */
     bool isSwallowTouches();
+
+    /** Whether or not touches that begin outside the content box of the node are skipped.
+     * When enabled, EventDispatcher doesn't call onTouchBegan for a touch that begins outside the bounding box of
+     * the associated node, as drawn in the last frame. Only enable it if onTouchBegan never claims such touches.
+     * It only applies to the listeners added with scene graph priority, on nodes lying in the z = 0 plane.
+     *
+     * @param enabled True to skip the touches outside of the node.
+     * @since v3.10
+     */
+    void setTouchBoundsCulling(bool enabled);
+    /** Are touches outside the content box of the node skipped or not.
+     *
+     * @return True if touches outside of the node are skipped.
+     * @since v3.10
+     */
+    bool isTouchBoundsCulling() const;
     
     /// Overrides
     virtual EventListenerTouchOneByOne* clone() override;
@@ -90,6 +106,7 @@ CC_CONSTRUCTOR_ACCESS:
 private:
     std::vector<Touch*> _claimedTouches;
     bool _needSwallow;
+    bool _touchBoundsCulling;
     
     friend class EventDispatcher;
 };
@@ -0,0 +1,302 @@
+/****************************************************************************
+ Copyright (c) 2016 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCJobSystem.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+
+NS_CC_BEGIN
+
+JobSystem* JobSystem::s_jobSystem = nullptr;
+
+JobSystem::Job::Job(const std::function<void()>& work, const std::function<void()>& completion, Priority priority)
+: _work(work)
+, _completion(completion)
+, _priority(priority)
+, _pendingCount(1)
+, _done(false)
+{
+}
+
+JobSystem* JobSystem::getInstance()
+{
+    if (s_jobSystem == nullptr)
+    {
+        s_jobSystem = new (std::nothrow) JobSystem();
+    }
+    return s_jobSystem;
+}
+
+JobSystem* JobSystem::getInstanceIfStarted()
+{
+    return s_jobSystem;
+}
+
+void JobSystem::destroyInstance()
+{
+    delete s_jobSystem;
+    s_jobSystem = nullptr;
+}
+
+JobSystem::JobSystem()
+: _nextWorker(0)
+, _queuedCount(0)
+, _waitingCount(0)
+, _quit(false)
+{
+    // one worker per spare core, but at least two: jobs reading files spend most of their time blocked
+    unsigned int cores = std::thread::hardware_concurrency();
+    unsigned int count = cores > 3 ? cores - 1 : 2;
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        _workers.push_back(new Worker());
+    }
+
+    // the workers look themselves up in _workers, they wait on _sleepMutex until all threads are stored
+    std::lock_guard<std::mutex> lock(_sleepMutex);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        _workers[i]->thread = std::thread(&JobSystem::workerLoop, this, (int)i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _quit = true;
+    }
+    _sleepCondition.notify_all();
+
+    // the queued jobs are released with the queues
+    for (auto worker : _workers)
+    {
+        worker->thread.join();
+    }
+    for (auto worker : _workers)
+    {
+        delete worker;
+    }
+}
+
+JobSystem::JobHandle JobSystem::schedule(const std::function<void()>& work,
+                                         const std::function<void()>& completion,
+                                         Priority priority,
+                                         const std::vector<JobHandle>& dependencies)
+{
+    JobHandle job = std::make_shared<Job>(work, completion, priority);
+
+    for (const auto& dependency : dependencies)
+    {
+        if (dependency)
+        {
+            std::lock_guard<std::mutex> lock(dependency->_continuationMutex);
+            if (!dependency->_done)
+            {
+                dependency->_continuations.push_back(job);
+                ++job->_pendingCount;
+            }
+        }
+    }
+
+    // drops the count held while scheduling, queues the job if no dependency is left
+    release(job);
+    return job;
+}
+
+JobSystem::JobHandle JobSystem::then(const JobHandle& job, const std::function<void()>& work, Priority priority)
+{
+    return schedule(work, nullptr, priority, std::vector<JobHandle>(1, job));
+}
+
+bool JobSystem::isDone(const JobHandle& job)
+{
+    return job == nullptr || job->_done;
+}
+
+void JobSystem::wait(const JobHandle& job)
+{
+    if (isDone(job))
+    {
+        return;
+    }
+
+    int index = getCurrentWorkerIndex();
+    ++_waitingCount;
+    while (!job->_done)
+    {
+        JobHandle other = pop(index);
+        if (other)
+        {
+            run(other);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _doneCondition.wait(lock, [this, &job]{ return job->_done || _queuedCount > 0; });
+    }
+    --_waitingCount;
+}
+
+void JobSystem::workerLoop(int index)
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+
+    // the queues aren't drained on quit, the jobs left in them are dropped
+    while (!_quit)
+    {
+        JobHandle job = pop(index);
+        if (job)
+        {
+            run(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepCondition.wait(lock, [this]{ return _quit || _queuedCount > 0; });
+    }
+}
+
+void JobSystem::push(const JobHandle& job)
+{
+    // a worker keeps the jobs it spawns, other threads spread theirs
+    int index = getCurrentWorkerIndex();
+    if (index < 0)
+    {
+        index = (int)(_nextWorker++ % _workers.size());
+    }
+
+    Worker* worker = _workers[index];
+    {
+        std::lock_guard<std::mutex> lock(worker->queueMutex);
+        worker->queues[(int)job->_priority].push_back(job);
+    }
+
+    ++_queuedCount;
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _sleepCondition.notify_one();
+    if (_waitingCount > 0)
+    {
+        _doneCondition.notify_all();
+    }
+}
+
+JobSystem::JobHandle JobSystem::pop(int index)
+{
+    if (_queuedCount <= 0)
+    {
+        return nullptr;
+    }
+
+    int count = (int)_workers.size();
+    for (int priority = 0; priority < (int)Priority::COUNT; ++priority)
+    {
+        // the own queue in submission order first, then the newest job of another worker
+        for (int i = 0; i < count; ++i)
+        {
+            bool own = (i == 0 && index >= 0);
+            Worker* worker = _workers[(index + i + count) % count];
+            auto& queue = worker->queues[priority];
+
+            std::lock_guard<std::mutex> lock(worker->queueMutex);
+            if (!queue.empty())
+            {
+                JobHandle job;
+                if (own)
+                {
+                    job = std::move(queue.front());
+                    queue.pop_front();
+                }
+                else
+                {
+                    job = std::move(queue.back());
+                    queue.pop_back();
+                }
+                --_queuedCount;
+                return job;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::run(const JobHandle& job)
+{
+    if (job->_work)
+    {
+        job->_work();
+    }
+
+    std::vector<JobHandle> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job->_continuationMutex);
+        job->_done = true;
+        continuations.swap(job->_continuations);
+    }
+    for (const auto& continuation : continuations)
+    {
+        release(continuation);
+    }
+
+    if (job->_completion)
+    {
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread(job->_completion);
+    }
+
+    if (_waitingCount > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+        }
+        _doneCondition.notify_all();
+    }
+}
+
+void JobSystem::release(const JobHandle& job)
+{
+    if (--job->_pendingCount == 0)
+    {
+        push(job);
+    }
+}
+
+int JobSystem::getCurrentWorkerIndex() const
+{
+    auto id = std::this_thread::get_id();
+    for (size_t i = 0; i < _workers.size(); ++i)
+    {
+        if (_workers[i]->thread.get_id() == id)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+NS_CC_END
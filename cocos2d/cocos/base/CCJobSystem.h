@@ -0,0 +1,174 @@
+/****************************************************************************
+ Copyright (c) 2016 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __BASE_CCJOBSYSTEM_H__
+#define __BASE_CCJOBSYSTEM_H__
+
+#include "platform/CCPlatformMacros.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * @class JobSystem
+ * @brief Engine wide pool of worker threads running background jobs.
+ *
+ * There is one worker per spare core. Every worker owns a queue per priority; it runs its own jobs
+ * in submission order and, when it runs dry, steals the most recently queued jobs of the other workers,
+ * so a burst of work spreads over all cores instead of waiting on one thread.
+ * A job can depend on other jobs, it is queued once all of them ran. Its completion callback is
+ * called on the cocos thread, like the callbacks of AsyncTaskPool.
+ *
+ * Jobs must not block on network I/O for long: use a thread of its own for that.
+ * @js NA
+ * @lua NA
+ * @since v3.10
+ */
+class CC_DLL JobSystem
+{
+public:
+    /** Workers pick the jobs of a higher priority first. */
+    enum class Priority
+    {
+        HIGH,
+        NORMAL,
+        LOW,
+        COUNT,
+    };
+
+    class Job;
+    /** Keeps a scheduled job alive, use it to wait for it or as a dependency of other jobs. */
+    typedef std::shared_ptr<Job> JobHandle;
+
+    /** Returns the shared job system, the workers are started on first use. */
+    static JobSystem* getInstance();
+
+    /** Returns the shared job system, or nullptr if it isn't started, e.g. once destroyInstance() ran. */
+    static JobSystem* getInstanceIfStarted();
+
+    /**
+     * Stops the workers. Running jobs are waited for, jobs which are still queued are dropped: they never run,
+     * neither do their completion callbacks, and they must not be waited for.
+     */
+    static void destroyInstance();
+
+    /**
+     * Schedules a job.
+     *
+     * @param work Function run on a worker thread.
+     * @param completion Function called on the cocos thread after work ran, may be nullptr.
+     * @param priority Priority of the job.
+     * @param dependencies Jobs which must have run before this one is started.
+     * @return The handle of the job.
+     */
+    JobHandle schedule(const std::function<void()>& work,
+                       const std::function<void()>& completion = nullptr,
+                       Priority priority = Priority::NORMAL,
+                       const std::vector<JobHandle>& dependencies = std::vector<JobHandle>());
+
+    /** Schedules work as a continuation of job, it is started once job ran. */
+    JobHandle then(const JobHandle& job, const std::function<void()>& work, Priority priority = Priority::NORMAL);
+
+    /**
+     * Blocks until the job ran; its completion callback is not waited for.
+     * The calling thread runs queued jobs meanwhile, so it can be called from a job.
+     */
+    void wait(const JobHandle& job);
+
+    /** Whether the job ran. */
+    static bool isDone(const JobHandle& job);
+
+    /** Number of worker threads. */
+    unsigned int getWorkerCount() const { return (unsigned int)_workers.size(); }
+
+    /** A scheduled unit of work. */
+    class CC_DLL Job
+    {
+    public:
+        Job(const std::function<void()>& work, const std::function<void()>& completion, Priority priority);
+
+    private:
+        friend class JobSystem;
+
+        std::function<void()> _work;
+        std::function<void()> _completion;
+        Priority _priority;
+        // dependencies which didn't run yet, plus one while the job is being scheduled
+        std::atomic<int> _pendingCount;
+        std::atomic<bool> _done;
+        // jobs to release once this one ran, guarded by _continuationMutex
+        std::mutex _continuationMutex;
+        std::vector<JobHandle> _continuations;
+    };
+
+CC_CONSTRUCTOR_ACCESS:
+    JobSystem();
+    ~JobSystem();
+
+protected:
+    struct Worker
+    {
+        std::thread thread;
+        std::mutex queueMutex;
+        std::deque<JobHandle> queues[(int)Priority::COUNT];
+    };
+
+    void workerLoop(int index);
+    // queues a job whose dependencies all ran
+    void push(const JobHandle& job);
+    // pops a job of the worker at index, or steals one from another worker
+    JobHandle pop(int index);
+    void run(const JobHandle& job);
+    void release(const JobHandle& job);
+    int getCurrentWorkerIndex() const;
+
+    std::vector<Worker*> _workers;
+    std::atomic<unsigned int> _nextWorker;
+    // queued jobs over all workers, guarded by _sleepMutex for the sleeping workers
+    std::atomic<int> _queuedCount;
+    std::atomic<int> _waitingCount;
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+    std::condition_variable _doneCondition;
+    // set under _sleepMutex, read by the workers between two jobs
+    std::atomic<bool> _quit;
+
+    static JobSystem* s_jobSystem;
+};
+
+NS_CC_END
+// end group
+/// @}
+#endif // __BASE_CCJOBSYSTEM_H__
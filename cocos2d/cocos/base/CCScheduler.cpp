@@ -28,45 +28,53 @@ THE SOFTWARE.
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
-#include "base/utlist.h"
-#include "base/ccCArray.h"
 #include "base/CCScriptSupport.h"
 
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+
 NS_CC_BEGIN
 
 // data structures
 
-// A list double-linked list used for "updates with priority"
-typedef struct _listEntry
-{
-    struct _listEntry   *prev, *next;
-    ccSchedulerFunc     callback;
-    void                *target;
-    int                 priority;
-    bool                paused;
-    bool                markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
-} tListEntry;
-
-typedef struct _hashUpdateEntry
+// A custom selector. They are allocated in blocks owned by the scheduler and linked in one of its timer
+// lists: the starting timers, the every frame timers or a slot of the timer wheel.
+struct Scheduler::TimerEntry
 {
-    tListEntry          **list;        // Which list does it belong to ?
-    tListEntry          *entry;        // entry in the list
+    TimerEntry          *prev, *next;
+    TimerEntry          **list;         // head of the list it is linked in, nullptr if none
+    TargetEntry         *owner;
     void                *target;
     ccSchedulerFunc     callback;
-    UT_hash_handle      hh;
-} tHashUpdateEntry;
-
-// Hash Element used for "selectors with interval"
-typedef struct _hashSelectorEntry
+    SEL_SCHEDULE        selector;       // selector timers have no key
+    std::string         key;
+    double              due;            // time of the next trigger, or of the previous one for every frame timers
+    double              remaining;      // due - time, while its target is paused
+    float               interval;
+    float               delay;
+    unsigned int        repeat;         //0 = once, 1 is 2 x executed
+    unsigned int        timesExecuted;
+    bool                runForever;
+    bool                useDelay;
+    bool                started;
+    bool                firing;         // its callback is running, whoever runs it frees it
+    bool                removed;
+};
+
+namespace
 {
-    ccArray             *timers;
-    void                *target;
-    int                 timerIndex;
-    Timer               *currentTimer;
-    bool                currentTimerSalvaged;
-    bool                paused;
-    UT_hash_handle      hh;
-} tHashTimerEntry;
+    // resolution of the timer wheel, an update visits the slots of the ticks elapsed since the previous one
+    const double TIMER_TICKS_PER_SECOND = 240.0;
+    const int TIMER_BLOCK_SIZE = 256;
+    // the update arrays aren't compacted for fewer removals, see compactUpdatesIfNeeded
+    const size_t MIN_DEAD_UPDATES_TO_COMPACT = 64;
+
+    inline long long timerTick(double time)
+    {
+        return (long long)(time * TIMER_TICKS_PER_SECOND);
+    }
+}
 
 // implementation Timer
 
@@ -243,265 +251,672 @@ const int Scheduler::PRIORITY_SYSTEM = INT_MIN;
 // Minimum priority level for user scheduling.
 const int Scheduler::PRIORITY_NON_SYSTEM_MIN = PRIORITY_SYSTEM + 1;
 
+Scheduler::TargetEntry::TargetEntry()
+: target(nullptr)
+, updateList(-1)
+, updateIndex(0)
+, timersPaused(false)
+{
+}
+
 Scheduler::Scheduler(void)
 : _timeScale(1.0f)
-, _updatesNegList(nullptr)
-, _updates0List(nullptr)
-, _updatesPosList(nullptr)
-, _hashForUpdates(nullptr)
-, _hashForTimers(nullptr)
-, _currentTarget(nullptr)
-, _currentTargetSalvaged(false)
+, _deadUpdateCount(0)
+, _time(0.0)
+, _wheelTick(0)
+, _startingTimers(nullptr)
+, _everyFrameTimers(nullptr)
+, _timerCursor(nullptr)
+, _freeTimers(nullptr)
 , _updateHashLocked(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
+, _functionsToPerform(nullptr)
+, _pendingFunctions(nullptr)
+, _pendingFunctionsTail(nullptr)
+, _performTimeBudget(0)
+, _performDestroyed(nullptr)
 {
-    // I don't expect to have more than 30 functions to all per frame
-    _functionsToPerform.reserve(30);
+    memset(_timerWheel, 0, sizeof(_timerWheel));
 }
 
 Scheduler::~Scheduler(void)
 {
+    // destroyed by one of the functions runFunctionsToPerform() calls, it stops there
+    if (_performDestroyed)
+    {
+        *_performDestroyed = true;
+    }
+
     unscheduleAll();
+
+    // functions never run are dropped
+    auto deleteEntries = [](PerformEntry *entry) {
+        while (entry)
+        {
+            PerformEntry *next = entry->next;
+            delete entry;
+            entry = next;
+        }
+    };
+    deleteEntries(_functionsToPerform.exchange(nullptr));
+    deleteEntries(_pendingFunctions);
+
+    for (auto block : _timerBlocks)
+    {
+        delete [] block;
+    }
 }
 
-void Scheduler::removeHashElement(_hashSelectorEntry *element)
+Scheduler::TargetEntry& Scheduler::getTargetEntry(void *target)
 {
-    ccArrayFree(element->timers);
-    HASH_DEL(_hashForTimers, element);
-    free(element);
+    TargetEntry& entry = _targets[target];
+    entry.target = target;
+    return entry;
 }
 
-void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
+void Scheduler::releaseTargetEntry(TargetEntry& entry)
 {
-    this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
+    if (entry.timers.empty() && entry.updateList < 0)
+    {
+        _targets.erase(entry.target);
+    }
 }
 
-void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string& key)
+Scheduler::TimerEntry* Scheduler::allocTimer()
 {
-    CCASSERT(target, "Argument target must be non-nullptr");
-    CCASSERT(!key.empty(), "key should not be empty!");
+    if (_freeTimers == nullptr)
+    {
+        TimerEntry *block = new TimerEntry[TIMER_BLOCK_SIZE];
+        _timerBlocks.push_back(block);
+        for (int i = TIMER_BLOCK_SIZE - 1; i >= 0; --i)
+        {
+            block[i].next = _freeTimers;
+            _freeTimers = &block[i];
+        }
+    }
+
+    TimerEntry *timer = _freeTimers;
+    _freeTimers = timer->next;
+    return timer;
+}
 
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+void Scheduler::freeTimer(TimerEntry *timer)
+{
+    // releases what the callback captured
+    timer->callback = nullptr;
+    timer->key.clear();
+    timer->owner = nullptr;
+    timer->list = nullptr;
+    timer->next = _freeTimers;
+    _freeTimers = timer;
+}
 
-    if (! element)
+void Scheduler::pushTimer(TimerEntry **list, TimerEntry *timer)
+{
+    // appended, so the timers due at once run in the order they were scheduled, like the Timers of a target did.
+    // The prev of the head is the tail.
+    TimerEntry *head = *list;
+    timer->next = nullptr;
+    if (head)
     {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
-        element->target = target;
+        timer->prev = head->prev;
+        head->prev->next = timer;
+        head->prev = timer;
+    }
+    else
+    {
+        timer->prev = timer;
+        *list = timer;
+    }
+    timer->list = list;
+}
 
-        HASH_ADD_PTR(_hashForTimers, target, element);
+void Scheduler::unlinkTimer(TimerEntry *timer)
+{
+    // the list being run goes on with the next timer
+    if (timer == _timerCursor)
+    {
+        _timerCursor = timer->next;
+    }
 
-        // Is this the 1st element ? Then set the pause level to all the selectors of this target
-        element->paused = paused;
+    TimerEntry *head = *timer->list;
+    if (timer == head)
+    {
+        *timer->list = timer->next;
+        if (timer->next)
+        {
+            timer->next->prev = timer->prev;
+        }
+    }
+    else
+    {
+        timer->prev->next = timer->next;
+        if (timer->next)
+        {
+            timer->next->prev = timer->prev;
+        }
+        else
+        {
+            head->prev = timer->prev;
+        }
+    }
+    timer->prev = timer->next = nullptr;
+    timer->list = nullptr;
+}
+
+void Scheduler::linkTimer(TimerEntry *timer)
+{
+    if (!timer->started)
+    {
+        pushTimer(&_startingTimers, timer);
+    }
+    else if (timer->useDelay || timer->interval > 0)
+    {
+        insertIntoWheel(timer);
     }
     else
     {
-        CCASSERT(element->paused == paused, "element's paused should be paused!");
+        pushTimer(&_everyFrameTimers, timer);
     }
+}
+
+void Scheduler::insertIntoWheel(TimerEntry *timer)
+{
+    // overdue timers go to the current slot. Level n holds the timers due in less than 64^(n+1) ticks,
+    // they move down a level when the slot they are in comes up.
+    long long tick = std::max(timerTick(timer->due), _wheelTick);
+    long long delta = tick - _wheelTick;
 
-    if (element->timers == nullptr)
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (1LL << (TIMER_WHEEL_BITS * (level + 1))))
     {
-        element->timers = ccArrayNew(10);
+        ++level;
     }
-    else 
+
+    // beyond the range of the wheel, it waits in the farthest slot and is placed again from there
+    const long long range = 1LL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS);
+    if (delta >= range)
     {
-        for (int i = 0; i < element->timers->num; ++i)
-        {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
+        tick = _wheelTick + range - 1;
+    }
 
-            if (timer && key == timer->getKey())
+    int slot = (int)((tick >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1));
+    pushTimer(&_timerWheel[level][slot], timer);
+}
+
+void Scheduler::cascadeTimers(int level)
+{
+    TimerEntry **slot = &_timerWheel[level][(_wheelTick >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1)];
+    while (*slot)
+    {
+        TimerEntry *timer = *slot;
+        unlinkTimer(timer);
+        insertIntoWheel(timer);
+    }
+}
+
+bool Scheduler::triggerTimer(TimerEntry *timer, float dt)
+{
+    if (timer->selector)
+    {
+        (static_cast<Ref*>(timer->target)->*timer->selector)(dt);
+    }
+    else if (timer->callback)
+    {
+        timer->callback(dt);
+    }
+    timer->timesExecuted += 1;
+
+    if (!timer->removed && !timer->runForever && timer->timesExecuted > timer->repeat)
+    {
+        unscheduleTimer(timer);
+    }
+
+    if (timer->removed)
+    {
+        freeTimer(timer);
+        return false;
+    }
+    return true;
+}
+
+// Triggers a timer of the wheel which is due the way Timer::update does, and links it back unless it ended.
+void Scheduler::runDueTimer(TimerEntry *timer)
+{
+    timer->firing = true;
+
+    // deal with delay
+    if (timer->useDelay)
+    {
+        timer->useDelay = false;
+        if (!triggerTimer(timer, timer->delay))
+        {
+            return;
+        }
+        // like Timer::update, an every frame timer is triggered again with what is left of the tick
+        if (timer->interval <= 0)
+        {
+            if (!triggerTimer(timer, (float)(_time - timer->due)))
             {
-                CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
-                timer->setInterval(interval);
                 return;
-            }        
+            }
+            timer->due = _time;
+        }
+        else
+        {
+            timer->due += timer->interval;
+        }
+    }
+
+    while (timer->interval > 0 && timer->due <= _time)
+    {
+        if (!triggerTimer(timer, timer->interval))
+        {
+            return;
         }
-        ccArrayEnsureExtraCapacity(element->timers, 1);
+        timer->due += timer->interval;
     }
 
-    TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
-    timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
-    timer->release();
+    timer->firing = false;
+    if (timer->owner->timersPaused)
+    {
+        timer->remaining = timer->due - _time;
+    }
+    else
+    {
+        linkTimer(timer);
+    }
 }
 
-void Scheduler::unschedule(const std::string &key, void *target)
+void Scheduler::runWheelSlot(TimerEntry **slot)
 {
-    // explicit handle nil arguments when removing an object
-    if (target == nullptr || key.empty())
+    _timerCursor = *slot;
+    while (_timerCursor)
+    {
+        TimerEntry *timer = _timerCursor;
+        _timerCursor = timer->next;
+
+        if (timer->due <= _time)
+        {
+            unlinkTimer(timer);
+            runDueTimer(timer);
+        }
+    }
+}
+
+void Scheduler::runEveryFrameTimers()
+{
+    // the timers run are moved back one by one, the ones a callback links meanwhile wait for the next frame
+    TimerEntry *running = _everyFrameTimers;
+    _everyFrameTimers = nullptr;
+    for (TimerEntry *timer = running; timer; timer = timer->next)
+    {
+        timer->list = &running;
+    }
+
+    while (running)
+    {
+        TimerEntry *timer = running;
+        unlinkTimer(timer);
+        pushTimer(&_everyFrameTimers, timer);
+
+        // the time since the previous trigger, a tick unless the timer had an interval before
+        float dt = (float)(_time - timer->due);
+        timer->due = _time;
+        timer->firing = true;
+        if (!triggerTimer(timer, dt))
+        {
+            continue;
+        }
+        timer->firing = false;
+
+        // it was given an interval or its target was paused while it ran
+        if (timer->interval > 0 || timer->owner->timersPaused)
+        {
+            unlinkTimer(timer);
+            timer->due = _time + timer->interval;
+            if (timer->owner->timersPaused)
+            {
+                timer->remaining = timer->due - _time;
+            }
+            else
+            {
+                linkTimer(timer);
+            }
+        }
+    }
+}
+
+Scheduler::TimerEntry* Scheduler::addTimer(TargetEntry& owner, float interval, unsigned int repeat, float delay, bool paused)
+{
+    if (owner.timers.empty())
+    {
+        // Is this the 1st element ? Then set the pause level to all the selectors of this target
+        owner.timersPaused = paused;
+    }
+
+    TimerEntry *timer = allocTimer();
+    timer->prev = timer->next = nullptr;
+    timer->list = nullptr;
+    timer->owner = &owner;
+    timer->target = owner.target;
+    timer->selector = nullptr;
+    timer->due = 0.0;
+    timer->remaining = 0.0;
+    timer->interval = interval;
+    timer->delay = delay;
+    timer->repeat = repeat;
+    timer->timesExecuted = 0;
+    timer->runForever = (repeat == CC_REPEAT_FOREVER);
+    timer->useDelay = (delay > 0.0f);
+    timer->started = false;
+    timer->firing = false;
+    timer->removed = false;
+    owner.timers.push_back(timer);
+
+    if (!paused)
+    {
+        linkTimer(timer);
+    }
+    return timer;
+}
+
+void Scheduler::setTimerInterval(TimerEntry *timer, float interval)
+{
+    CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->interval, interval);
+
+    float previous = timer->interval;
+    timer->interval = interval;
+
+    // a running timer picks it up, one which didn't start or waits for its delay doesn't depend on it yet
+    if (timer->firing || !timer->started || timer->useDelay)
     {
         return;
     }
 
-    //CCASSERT(target);
-    //CCASSERT(selector);
+    // the interval counts from the previous trigger
+    double due = (timer->list ? timer->due : _time + timer->remaining);
+    due = (previous > 0 ? due - previous : due) + interval;
+    if (timer->list)
+    {
+        unlinkTimer(timer);
+        timer->due = due;
+        linkTimer(timer);
+    }
+    else
+    {
+        timer->remaining = due - _time;
+    }
+}
+
+void Scheduler::unscheduleTimer(TimerEntry *timer)
+{
+    TargetEntry& owner = *timer->owner;
+    owner.timers.erase(std::find(owner.timers.begin(), owner.timers.end(), timer));
+    discardTimer(timer);
+    releaseTargetEntry(owner);
+}
 
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+void Scheduler::discardTimer(TimerEntry *timer)
+{
+    if (timer->list)
+    {
+        unlinkTimer(timer);
+    }
+    timer->removed = true;
 
-    if (element)
+    // a timer can unschedule itself, the one running it frees it once its callback returned
+    if (!timer->firing)
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        freeTimer(timer);
+    }
+}
+
+void Scheduler::pauseTimers(TargetEntry& owner)
+{
+    owner.timersPaused = true;
+    for (auto timer : owner.timers)
+    {
+        // a running timer is parked by the one running it
+        if (timer->list && !timer->firing)
         {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
+            timer->remaining = timer->due - _time;
+            unlinkTimer(timer);
+        }
+    }
+}
 
-            if (timer && key == timer->getKey())
-            {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
+void Scheduler::resumeTimers(TargetEntry& owner)
+{
+    owner.timersPaused = false;
+    for (auto timer : owner.timers)
+    {
+        if (!timer->list && !timer->firing)
+        {
+            timer->due = _time + timer->remaining;
+            linkTimer(timer);
+        }
+    }
+}
 
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
+void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
+{
+    this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
+}
 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
+void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string& key)
+{
+    CCASSERT(target, "Argument target must be non-nullptr");
+    CCASSERT(!key.empty(), "key should not be empty!");
 
-                if (element->timers->num == 0)
-                {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
-                }
+    TargetEntry& owner = getTargetEntry(target);
+    CCASSERT(owner.timers.empty() || owner.timersPaused == paused, "element's paused should be paused!");
+
+    for (auto timer : owner.timers)
+    {
+        if (!timer->selector && key == timer->key)
+        {
+            setTimerInterval(timer, interval);
+            return;
+        }
+    }
+
+    TimerEntry *timer = addTimer(owner, interval, repeat, delay, paused);
+    timer->callback = callback;
+    timer->key = key;
+}
+
+void Scheduler::unschedule(const std::string &key, void *target)
+{
+    // explicit handle nil arguments when removing an object
+    if (target == nullptr || key.empty())
+    {
+        return;
+    }
 
+    auto it = _targets.find(target);
+    if (it != _targets.end())
+    {
+        for (auto timer : it->second.timers)
+        {
+            if (!timer->selector && key == timer->key)
+            {
+                unscheduleTimer(timer);
                 return;
             }
         }
     }
 }
 
-void Scheduler::priorityIn(tListEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused)
+void Scheduler::insertUpdate(UpdateEntry&& entry)
 {
-    tListEntry *listElement = new tListEntry();
+    int list = entry.priority < 0 ? UPDATES_NEGATIVE : (entry.priority == 0 ? UPDATES_ZERO : UPDATES_POSITIVE);
+    auto& updates = _updateLists[list];
+
+    // after the entries of the same priority. Most of the updates are going to be 0, they are only appended.
+    auto position = updates.end();
+    if (list != UPDATES_ZERO)
+    {
+        position = std::upper_bound(updates.begin(), updates.end(), entry.priority, [](int priority, const UpdateEntry& other) {
+            return priority < other.priority;
+        });
+    }
 
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->priority = priority;
-    listElement->paused = paused;
-    listElement->next = listElement->prev = nullptr;
-    listElement->markedForDeletion = false;
+    size_t index = position - updates.begin();
+    updates.insert(position, std::move(entry));
 
-    // empty list ?
-    if (! *list)
+    updates[index].owner->updateList = list;
+    for (size_t i = index; i < updates.size(); ++i)
     {
-        DL_APPEND(*list, listElement);
+        if (updates[i].owner)
+        {
+            updates[i].owner->updateIndex = (int)i;
+        }
     }
-    else
+}
+
+void Scheduler::removeUpdate(TargetEntry& owner)
+{
+    UpdateEntry& entry = _updateLists[owner.updateList][owner.updateIndex];
+    if (!entry.markedForDeletion)
     {
-        bool added = false;
+        entry.markedForDeletion = true;
+        ++_deadUpdateCount;
+    }
 
-        for (tListEntry *element = *list; element; element = element->next)
+    // while the arrays are walked it is removed at the end of the tick, until then it can be scheduled again
+    if (!_updateHashLocked)
+    {
+        entry.owner = nullptr;
+        entry.callback = nullptr;
+        owner.updateList = -1;
+    }
+}
+
+void Scheduler::reviveUpdate(UpdateEntry& entry)
+{
+    // an update removed during the tick and scheduled again before its end
+    if (entry.markedForDeletion)
+    {
+        entry.markedForDeletion = false;
+        --_deadUpdateCount;
+    }
+}
+
+void Scheduler::compactUpdates()
+{
+    for (int list = UPDATES_NEGATIVE; list < UPDATES_PENDING; ++list)
+    {
+        auto& updates = _updateLists[list];
+        size_t count = 0;
+        for (size_t i = 0; i < updates.size(); ++i)
         {
-            if (priority < element->priority)
+            if (updates[i].markedForDeletion)
             {
-                if (element == *list)
+                if (updates[i].owner)
                 {
-                    DL_PREPEND(*list, listElement);
-                }
-                else
-                {
-                    listElement->next = element;
-                    listElement->prev = element->prev;
-
-                    element->prev->next = listElement;
-                    element->prev = listElement;
+                    updates[i].owner->updateList = -1;
+                    releaseTargetEntry(*updates[i].owner);
                 }
+                continue;
+            }
 
-                added = true;
-                break;
+            if (count != i)
+            {
+                updates[count] = std::move(updates[i]);
+                updates[count].owner->updateIndex = (int)count;
             }
+            ++count;
         }
+        updates.erase(updates.begin() + count, updates.end());
+    }
+    _deadUpdateCount = 0;
 
-        // Not added? priority has the higher value. Append it.
-        if (! added)
+    // the updates scheduled during the tick
+    auto& pending = _updateLists[UPDATES_PENDING];
+    if (!pending.empty())
+    {
+        std::vector<UpdateEntry> entries;
+        entries.swap(pending);
+        for (auto& entry : entries)
         {
-            DL_APPEND(*list, listElement);
+            if (!entry.markedForDeletion)
+            {
+                insertUpdate(std::move(entry));
+            }
+            else if (entry.owner)
+            {
+                entry.owner->updateList = -1;
+                releaseTargetEntry(*entry.owner);
+            }
         }
+        entries.clear();
+        pending.swap(entries);
     }
-
-    // update hash entry for quick access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
 }
 
-void Scheduler::appendIn(_listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused)
+void Scheduler::compactUpdatesIfNeeded()
 {
-    tListEntry *listElement = new tListEntry();
-
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->paused = paused;
-    listElement->priority = 0;
-    listElement->markedForDeletion = false;
-
-    DL_APPEND(*list, listElement);
-
-    // update hash entry for quicker access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
+    // removals outside of a tick only mark the entries, a compaction is paid by as many removals as entries it keeps
+    size_t count = _updateLists[UPDATES_NEGATIVE].size() + _updateLists[UPDATES_ZERO].size() + _updateLists[UPDATES_POSITIVE].size();
+    if (!_updateHashLocked && _deadUpdateCount >= MIN_DEAD_UPDATES_TO_COMPACT && _deadUpdateCount * 2 > count)
+    {
+        compactUpdates();
+    }
 }
 
 void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused)
 {
-    tHashUpdateEntry *hashElement = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, hashElement);
-    if (hashElement)
+    TargetEntry& owner = getTargetEntry(target);
+    if (owner.updateList >= 0)
     {
+        UpdateEntry& entry = _updateLists[owner.updateList][owner.updateIndex];
+
         // check if priority has changed
-        if ((*hashElement->list)->priority != priority)
+        if (entry.priority != priority)
         {
             if (_updateHashLocked)
             {
                 CCLOG("warning: you CANNOT change update priority in scheduled function");
-                hashElement->entry->markedForDeletion = false;
-                hashElement->entry->paused = paused;
+                reviveUpdate(entry);
+                entry.paused = paused;
                 return;
             }
             else
             {
-            	// will be added again outside if (hashElement).
-                unscheduleUpdate(target);
+                // will be added again below.
+                removeUpdate(owner);
             }
         }
         else
         {
-            hashElement->entry->markedForDeletion = false;
-            hashElement->entry->paused = paused;
+            reviveUpdate(entry);
+            entry.paused = paused;
             return;
         }
     }
 
-    // most of the updates are going to be 0, that's way there
-    // is an special list for updates with priority 0
-    if (priority == 0)
-    {
-        appendIn(&_updates0List, callback, target, paused);
-    }
-    else if (priority < 0)
+    UpdateEntry entry;
+    entry.callback = callback;
+    entry.target = target;
+    entry.owner = &owner;
+    entry.priority = priority;
+    entry.paused = paused;
+    entry.markedForDeletion = false;
+
+    if (_updateHashLocked)
     {
-        priorityIn(&_updatesNegList, callback, target, priority, paused);
+        // the arrays are being walked, it is added at the end of the tick
+        auto& pending = _updateLists[UPDATES_PENDING];
+        owner.updateList = UPDATES_PENDING;
+        owner.updateIndex = (int)pending.size();
+        pending.push_back(std::move(entry));
     }
     else
     {
-        // priority > 0
-        priorityIn(&_updatesPosList, callback, target, priority, paused);
+        insertUpdate(std::move(entry));
     }
 }
 
@@ -509,52 +924,21 @@ bool Scheduler::isScheduled(const std::string& key, void *target)
 {
     CCASSERT(!key.empty(), "Argument key must not be empty");
     CCASSERT(target, "Argument target must be non-nullptr");
-    
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (!element)
-    {
-        return false;
-    }
-    
-    if (element->timers == nullptr)
+
+    auto it = _targets.find(target);
+    if (it == _targets.end())
     {
         return false;
     }
-    else
+
+    for (auto timer : it->second.timers)
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        if (!timer->selector && key == timer->key)
         {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
-            
-            if (timer && key == timer->getKey())
-            {
-                return true;
-            }
+            return true;
         }
-        
-        return false;
-    }
-    
-    return false;  // should never get here
-}
-
-void Scheduler::removeUpdateFromHash(struct _listEntry *entry)
-{
-    tHashUpdateEntry *element = nullptr;
-
-    HASH_FIND_PTR(_hashForUpdates, &entry->target, element);
-    if (element)
-    {
-        // list entry
-        DL_DELETE(*element->list, element->entry);
-        CC_SAFE_DELETE(element->entry);
-
-        // hash entry
-        HASH_DEL(_hashForUpdates, element);
-        free(element);
     }
+    return false;
 }
 
 void Scheduler::unscheduleUpdate(void *target)
@@ -564,18 +948,12 @@ void Scheduler::unscheduleUpdate(void *target)
         return;
     }
 
-    tHashUpdateEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, element);
-    if (element)
+    auto it = _targets.find(target);
+    if (it != _targets.end() && it->second.updateList >= 0)
     {
-        if (_updateHashLocked)
-        {
-            element->entry->markedForDeletion = true;
-        }
-        else
-        {
-            this->removeUpdateFromHash(element->entry);
-        }
+        removeUpdate(it->second);
+        releaseTargetEntry(it->second);
+        compactUpdatesIfNeeded();
     }
 }
 
@@ -587,45 +965,34 @@ void Scheduler::unscheduleAll(void)
 void Scheduler::unscheduleAllWithMinPriority(int minPriority)
 {
     // Custom Selectors
-    tHashTimerEntry *element = nullptr;
-    tHashTimerEntry *nextElement = nullptr;
-    for (element = _hashForTimers; element != nullptr;)
+    std::vector<void*> targets;
+    for (auto& pair : _targets)
     {
-        // element may be removed in unscheduleAllSelectorsForTarget
-        nextElement = (tHashTimerEntry *)element->hh.next;
-        unscheduleAllForTarget(element->target);
-
-        element = nextElement;
-    }
-
-    // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
-    {
-        DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+        if (!pair.second.timers.empty())
         {
-            if(entry->priority >= minPriority)
-            {
-                unscheduleUpdate(entry->target);
-            }
+            targets.push_back(pair.first);
         }
     }
-
-    if(minPriority <= 0)
+    for (auto target : targets)
     {
-        DL_FOREACH_SAFE(_updates0List, entry, tmp)
-        {
-            unscheduleUpdate(entry->target);
-        }
+        unscheduleAllForTarget(target);
     }
 
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+    // Updates selectors
+    for (int list = UPDATES_NEGATIVE; list < UPDATE_LIST_COUNT; ++list)
     {
-        if(entry->priority >= minPriority)
+        for (auto& entry : _updateLists[list])
         {
-            unscheduleUpdate(entry->target);
+            if (entry.owner && !entry.markedForDeletion && entry.priority >= minPriority)
+            {
+                TargetEntry& owner = *entry.owner;
+                removeUpdate(owner);
+                releaseTargetEntry(owner);
+            }
         }
     }
+    compactUpdatesIfNeeded();
+
 #if CC_ENABLE_SCRIPT_BINDING
     _scriptHandlerEntries.clear();
 #endif
@@ -639,32 +1006,29 @@ void Scheduler::unscheduleAllForTarget(void *target)
         return;
     }
 
-    // Custom Selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-
-    if (element)
+    auto it = _targets.find(target);
+    if (it == _targets.end())
     {
-        if (ccArrayContainsObject(element->timers, element->currentTimer)
-            && (! element->currentTimerSalvaged))
-        {
-            element->currentTimer->retain();
-            element->currentTimerSalvaged = true;
-        }
-        ccArrayRemoveAllObjects(element->timers);
+        return;
+    }
+    TargetEntry& owner = it->second;
 
-        if (_currentTarget == element)
-        {
-            _currentTargetSalvaged = true;
-        }
-        else
-        {
-            removeHashElement(element);
-        }
+    // Custom Selectors
+    std::vector<TimerEntry*> timers;
+    timers.swap(owner.timers);
+    for (auto timer : timers)
+    {
+        discardTimer(timer);
     }
 
     // update selector
-    unscheduleUpdate(target);
+    if (owner.updateList >= 0)
+    {
+        removeUpdate(owner);
+    }
+
+    releaseTargetEntry(owner);
+    compactUpdatesIfNeeded();
 }
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -694,21 +1058,22 @@ void Scheduler::resumeTarget(void *target)
 {
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
+    auto it = _targets.find(target);
+    if (it == _targets.end())
+    {
+        return;
+    }
+
     // custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    if (!it->second.timers.empty())
     {
-        element->paused = false;
+        resumeTimers(it->second);
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    if (it->second.updateList >= 0)
     {
-        CCASSERT(elementUpdate->entry != nullptr, "elementUpdate's entry can't be nullptr!");
-        elementUpdate->entry->paused = false;
+        _updateLists[it->second.updateList][it->second.updateIndex].paused = false;
     }
 }
 
@@ -716,21 +1081,22 @@ void Scheduler::pauseTarget(void *target)
 {
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
+    auto it = _targets.find(target);
+    if (it == _targets.end())
+    {
+        return;
+    }
+
     // custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    if (!it->second.timers.empty())
     {
-        element->paused = true;
+        pauseTimers(it->second);
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    if (it->second.updateList >= 0)
     {
-        CCASSERT(elementUpdate->entry != nullptr, "elementUpdate's entry can't be nullptr!");
-        elementUpdate->entry->paused = true;
+        _updateLists[it->second.updateList][it->second.updateIndex].paused = true;
     }
 }
 
@@ -738,23 +1104,25 @@ bool Scheduler::isTargetPaused(void *target)
 {
     CCASSERT( target != nullptr, "target must be non nil" );
 
+    auto it = _targets.find(target);
+    if (it == _targets.end())
+    {
+        return false;
+    }
+
     // Custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if( element )
+    if (!it->second.timers.empty())
     {
-        return element->paused;
+        return it->second.timersPaused;
     }
-    
+
     // We should check update selectors if target does not have custom selectors
-	tHashUpdateEntry *elementUpdate = nullptr;
-	HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-	if ( elementUpdate )
+    if (it->second.updateList >= 0)
     {
-		return elementUpdate->entry->paused;
+        return _updateLists[it->second.updateList][it->second.updateIndex].paused;
     }
-    
-    return false;  // should never get here
+
+    return false;
 }
 
 std::set<void*> Scheduler::pauseAllTargets()
@@ -767,45 +1135,28 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     std::set<void*> idsWithSelectors;
 
     // Custom Selectors
-    for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
-        element = (tHashTimerEntry*)element->hh.next)
+    for (auto& pair : _targets)
     {
-        element->paused = true;
-        idsWithSelectors.insert(element->target);
+        if (!pair.second.timers.empty())
+        {
+            pauseTimers(pair.second);
+            idsWithSelectors.insert(pair.first);
+        }
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
+    for (int list = UPDATES_NEGATIVE; list < UPDATE_LIST_COUNT; ++list)
     {
-        DL_FOREACH_SAFE( _updatesNegList, entry, tmp ) 
+        for (auto& entry : _updateLists[list])
         {
-            if(entry->priority >= minPriority)
+            if (entry.owner && entry.priority >= minPriority)
             {
-                entry->paused = true;
-                idsWithSelectors.insert(entry->target);
+                entry.paused = true;
+                idsWithSelectors.insert(entry.target);
             }
         }
     }
 
-    if(minPriority <= 0)
-    {
-        DL_FOREACH_SAFE( _updates0List, entry, tmp )
-        {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE( _updatesPosList, entry, tmp ) 
-    {
-        if(entry->priority >= minPriority) 
-        {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
-        }
-    }
-
     return idsWithSelectors;
 }
 
@@ -818,11 +1169,86 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
 
 void Scheduler::performFunctionInCocosThread(const std::function<void ()> &function)
 {
-    _performMutex.lock();
+    // Pushed on a lock free stack. The cocos thread takes all of it at once, so
+    // an entry is never popped on its own and the CAS can't be fooled by ABA.
+    PerformEntry *entry = new PerformEntry();
+    entry->function = function;
+    entry->next = _functionsToPerform.load(std::memory_order_relaxed);
+    while (!_functionsToPerform.compare_exchange_weak(entry->next, entry, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+}
 
-    _functionsToPerform.push_back(function);
+void Scheduler::runFunctionsToPerform()
+{
+    // The functions run from a local list: one of them may destroy the scheduler, e.g. by purging the Director,
+    // so no member is touched between two calls. The left overs of the last frame come first.
+    PerformEntry *head = _pendingFunctions;
+    PerformEntry *tail = _pendingFunctionsTail;
+    _pendingFunctions = _pendingFunctionsTail = nullptr;
+
+    // one exchange for everything queued since the last frame, reversed to the order it was queued in
+    PerformEntry *queued = _functionsToPerform.exchange(nullptr, std::memory_order_acquire);
+    if (queued)
+    {
+        PerformEntry *queuedTail = queued;
+        PerformEntry *queuedHead = nullptr;
+        while (queued)
+        {
+            PerformEntry *next = queued->next;
+            queued->next = queuedHead;
+            queuedHead = queued;
+            queued = next;
+        }
 
-    _performMutex.unlock();
+        if (tail)
+        {
+            tail->next = queuedHead;
+        }
+        else
+        {
+            head = queuedHead;
+        }
+        tail = queuedTail;
+    }
+
+    // functions queued while these run wait for the next frame
+    float budget = _performTimeBudget;
+    bool destroyed = false;
+    _performDestroyed = &destroyed;
+    auto start = std::chrono::steady_clock::now();
+    while (head)
+    {
+        PerformEntry *entry = head;
+        head = entry->next;
+
+        entry->function();
+        delete entry;
+
+        if (destroyed || (budget > 0 && std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() >= budget))
+        {
+            break;
+        }
+    }
+
+    if (destroyed)
+    {
+        // functions never run are dropped, as by the destructor
+        while (head)
+        {
+            PerformEntry *next = head->next;
+            delete head;
+            head = next;
+        }
+        return;
+    }
+
+    _performDestroyed = nullptr;
+    if (head)
+    {
+        _pendingFunctions = head;
+        _pendingFunctionsTail = tail;
+    }
 }
 
 // main loop
@@ -839,106 +1265,84 @@ void Scheduler::update(float dt)
     // Selector callbacks
     //
 
-    // Iterate over all the Updates' selectors
-    tListEntry *entry, *tmp;
-
-    // updates with priority < 0
-    DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+    // updates with priority < 0, == 0 and > 0. Updates scheduled meanwhile go to the pending list, so the arrays don't move.
+    for (int list = UPDATES_NEGATIVE; list < UPDATES_PENDING; ++list)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        auto& updates = _updateLists[list];
+        for (size_t i = 0, count = updates.size(); i < count; ++i)
         {
-            entry->callback(dt);
+            UpdateEntry& entry = updates[i];
+            if ((! entry.paused) && (! entry.markedForDeletion))
+            {
+                entry.callback(dt);
+            }
         }
     }
 
-    // updates with priority == 0
-    DL_FOREACH_SAFE(_updates0List, entry, tmp)
+    // the updates scheduled by the ones above run in this tick too. The pending list may grow while it is walked.
+    auto& pending = _updateLists[UPDATES_PENDING];
+    for (size_t i = 0; i < pending.size(); ++i)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        if ((! pending[i].paused) && (! pending[i].markedForDeletion))
         {
-            entry->callback(dt);
+            ccSchedulerFunc callback = pending[i].callback;
+            callback(dt);
         }
     }
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
-    {
-        if ((! entry->paused) && (! entry->markedForDeletion))
-        {
-            entry->callback(dt);
-        }
-    }
+    //
+    // Custom selectors
+    //
+    _time += dt;
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
-    {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
+    runEveryFrameTimers();
 
-        if (! _currentTarget->paused)
+    // the wheel slots of the ticks elapsed since the previous update, the last one is visited again by the next update
+    long long nowTick = timerTick(_time);
+    while (true)
+    {
+        TimerEntry **slot = &_timerWheel[0][_wheelTick & (TIMER_WHEEL_SLOTS - 1)];
+        runWheelSlot(slot);
+        if (_wheelTick >= nowTick)
         {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
-            {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                elt->currentTimerSalvaged = false;
-
-                elt->currentTimer->update(dt);
-
-                if (elt->currentTimerSalvaged)
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
-
-                elt->currentTimer = nullptr;
-            }
+            break;
         }
-
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
-
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
+        // a callback scheduled or resumed a timer which is already due
+        if (*slot)
         {
-            removeHashElement(_currentTarget);
+            continue;
         }
-    }
 
-    // delete all updates that are marked for deletion
-    // updates with priority < 0
-    DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
-    {
-        if (entry->markedForDeletion)
+        ++_wheelTick;
+        for (int level = 1; level < TIMER_WHEEL_LEVELS; ++level)
         {
-            this->removeUpdateFromHash(entry);
+            if ((_wheelTick & ((1LL << (TIMER_WHEEL_BITS * level)) - 1)) != 0)
+            {
+                break;
+            }
+            cascadeTimers(level);
         }
     }
 
-    // updates with priority == 0
-    DL_FOREACH_SAFE(_updates0List, entry, tmp)
+    // timers scheduled since the previous update start now, like on the first Timer::update
+    while (_startingTimers)
     {
-        if (entry->markedForDeletion)
-        {
-            this->removeUpdateFromHash(entry);
-        }
+        TimerEntry *timer = _startingTimers;
+        unlinkTimer(timer);
+        timer->started = true;
+        timer->due = _time + (timer->useDelay ? timer->delay : timer->interval);
+        linkTimer(timer);
     }
+    _timerCursor = nullptr;
+
+    _updateHashLocked = false;
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+    // delete all updates that are marked for deletion and add the ones scheduled during the tick
+    if (_deadUpdateCount > 0 || !pending.empty())
     {
-        if (entry->markedForDeletion)
-        {
-            this->removeUpdateFromHash(entry);
-        }
+        compactUpdates();
     }
 
-    _updateHashLocked = false;
-    _currentTarget = nullptr;
-
 #if CC_ENABLE_SCRIPT_BINDING
     //
     // Script callbacks
@@ -965,67 +1369,32 @@ void Scheduler::update(float dt)
     // Functions allocated from another thread
     //
 
-    // Testing size is faster than locking / unlocking.
+    // Testing the queue is faster than taking it.
     // And almost never there will be functions scheduled to be called.
-    if( !_functionsToPerform.empty() ) {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if new functions are added in callback, it will cause thread deadlock.
-        auto temp = _functionsToPerform;
-        _functionsToPerform.clear();
-        _performMutex.unlock();
-        for( const auto &function : temp ) {
-            function();
-        }
-        
+    if (_pendingFunctions || _functionsToPerform.load(std::memory_order_relaxed))
+    {
+        runFunctionsToPerform();
     }
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, unsigned int repeat, float delay, bool paused)
 {
     CCASSERT(target, "Argument target must be non-nullptr");
-    
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (! element)
-    {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
-        element->target = target;
-        
-        HASH_ADD_PTR(_hashForTimers, target, element);
-        
-        // Is this the 1st element ? Then set the pause level to all the selectors of this target
-        element->paused = paused;
-    }
-    else
-    {
-        CCASSERT(element->paused == paused, "element's paused should be paused.");
-    }
-    
-    if (element->timers == nullptr)
-    {
-        element->timers = ccArrayNew(10);
-    }
-    else
+
+    TargetEntry& owner = getTargetEntry(target);
+    CCASSERT(owner.timers.empty() || owner.timersPaused == paused, "element's paused should be paused.");
+
+    for (auto timer : owner.timers)
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        if (timer->selector == selector)
         {
-            TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
-            
-            if (timer && selector == timer->getSelector())
-            {
-                CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
-                timer->setInterval(interval);
-                return;
-            }
+            setTimerInterval(timer, interval);
+            return;
         }
-        ccArrayEnsureExtraCapacity(element->timers, 1);
     }
-    
-    TimerTargetSelector *timer = new (std::nothrow) TimerTargetSelector();
-    timer->initWithSelector(this, selector, target, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
-    timer->release();
+
+    TimerEntry *timer = addTimer(owner, interval, repeat, delay, paused);
+    timer->selector = selector;
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, bool paused)
@@ -1037,35 +1406,21 @@ bool Scheduler::isScheduled(SEL_SCHEDULE selector, Ref *target)
 {
     CCASSERT(selector, "Argument selector must be non-nullptr");
     CCASSERT(target, "Argument target must be non-nullptr");
-    
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (!element)
-    {
-        return false;
-    }
-    
-    if (element->timers == nullptr)
+
+    auto it = _targets.find(target);
+    if (it == _targets.end())
     {
         return false;
     }
-    else
+
+    for (auto timer : it->second.timers)
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        if (timer->selector == selector)
         {
-            TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
-            
-            if (timer && selector == timer->getSelector())
-            {
-                return true;
-            }
+            return true;
         }
-        
-        return false;
     }
-    
-    return false;  // should never get here
+    return false;
 }
 
 void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
@@ -1075,47 +1430,15 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
     {
         return;
     }
-    
-    //CCASSERT(target);
-    //CCASSERT(selector);
-    
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (element)
+
+    auto it = _targets.find(target);
+    if (it != _targets.end())
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        for (auto timer : it->second.timers)
         {
-            TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
-            
-            if (timer && selector == timer->getSelector())
+            if (timer->selector == selector)
             {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
-                
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
-                
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-                
-                if (element->timers->num == 0)
-                {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
-                }
-                
+                unscheduleTimer(timer);
                 return;
             }
         }
@@ -28,13 +28,16 @@ THE SOFTWARE.
 #ifndef __CCSCHEDULER_H__
 #define __CCSCHEDULER_H__
 
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "base/CCRef.h"
 #include "base/CCVector.h"
-#include "base/uthash.h"
 
 NS_CC_BEGIN
 
@@ -141,10 +144,6 @@ private:
  * @{
  */
 
-struct _listEntry;
-struct _hashSelectorEntry;
-struct _hashUpdateEntry;
-
 #if CC_ENABLE_SCRIPT_BINDING
 class SchedulerScriptHandlerEntry;
 #endif
@@ -159,6 +158,9 @@ There are 2 different types of callbacks (selectors):
 
 The 'custom selectors' should be avoided when possible. It is faster, and consumes less memory to use the 'update selector'.
 
+Update selectors are kept in arrays ordered by priority. Custom selectors wait in a hierarchical timer wheel,
+a tick only visits the ones which are due, so their number barely matters as long as their intervals aren't 0.
+
 */
 class CC_DLL Scheduler : public Ref
 {
@@ -423,12 +425,26 @@ public:
     void resumeTargets(const std::set<void*>& targetsToResume);
 
     /** Calls a function on the cocos2d thread. Useful when you need to call a cocos2d function from another thread.
-     This function is thread safe.
+     This function is thread safe and lock free, the functions run in the order they were queued.
      @param function The function to be run in cocos2d thread.
      @since v3.0
      @js NA
      */
     void performFunctionInCocosThread( const std::function<void()> &function);
+
+    /** Sets how long the functions queued by performFunctionInCocosThread may run each frame.
+     The functions left once the budget is spent run first next frame, at least one function runs each frame.
+     @param seconds The time budget in seconds, 0 (the default) runs all the queued functions every frame.
+     @since v3.10
+     @js NA
+     */
+    void setPerformFunctionsTimeBudget(float seconds) { _performTimeBudget = seconds; }
+
+    /** Gets how long the functions queued by performFunctionInCocosThread may run each frame, 0 if not limited.
+     @since v3.10
+     @js NA
+     */
+    float getPerformFunctionsTimeBudget() const { return _performTimeBudget; }
     
     /////////////////////////////////////
     
@@ -499,30 +515,103 @@ protected:
      */
     void schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused);
     
-    void removeHashElement(struct _hashSelectorEntry *element);
-    void removeUpdateFromHash(struct _listEntry *entry);
+    struct TimerEntry;
+    struct TargetEntry;
 
-    // update specific
+    /** An update selector. */
+    struct UpdateEntry
+    {
+        ccSchedulerFunc callback;
+        void *target;
+        TargetEntry *owner; // nullptr once it was unscheduled
+        int priority;
+        bool paused;
+        bool markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
+    };
 
-    void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
-    void appendIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused);
+    /** What is scheduled for a target. */
+    struct TargetEntry
+    {
+        TargetEntry();
 
+        void *target;
+        std::vector<TimerEntry*> timers;
+        int updateList; // the UpdateList holding the update entry, or -1
+        int updateIndex;
+        bool timersPaused;
+    };
+
+    /** A function queued by performFunctionInCocosThread. */
+    struct PerformEntry
+    {
+        std::function<void()> function;
+        PerformEntry *next;
+    };
+
+    enum UpdateList
+    {
+        UPDATES_NEGATIVE,
+        UPDATES_ZERO,
+        UPDATES_POSITIVE,
+        UPDATES_PENDING, // scheduled during a tick, added at its end
+        UPDATE_LIST_COUNT,
+    };
+
+    static const int TIMER_WHEEL_LEVELS = 4;
+    static const int TIMER_WHEEL_BITS = 6;
+    static const int TIMER_WHEEL_SLOTS = 1 << TIMER_WHEEL_BITS;
+
+    TargetEntry& getTargetEntry(void *target);
+    // forgets the target once nothing is scheduled for it anymore
+    void releaseTargetEntry(TargetEntry& entry);
+
+    // update specific
+    void insertUpdate(UpdateEntry&& entry);
+    void removeUpdate(TargetEntry& owner);
+    void reviveUpdate(UpdateEntry& entry);
+    void compactUpdates();
+    void compactUpdatesIfNeeded();
+
+    // timer specific
+    TimerEntry* addTimer(TargetEntry& owner, float interval, unsigned int repeat, float delay, bool paused);
+    void setTimerInterval(TimerEntry *timer, float interval);
+    void unscheduleTimer(TimerEntry *timer);
+    void discardTimer(TimerEntry *timer);
+    void pauseTimers(TargetEntry& owner);
+    void resumeTimers(TargetEntry& owner);
+    void linkTimer(TimerEntry *timer);
+    void pushTimer(TimerEntry **list, TimerEntry *timer);
+    void unlinkTimer(TimerEntry *timer);
+    void insertIntoWheel(TimerEntry *timer);
+    void cascadeTimers(int level);
+    void runWheelSlot(TimerEntry **slot);
+    void runDueTimer(TimerEntry *timer);
+    void runEveryFrameTimers();
+    bool triggerTimer(TimerEntry *timer, float dt);
+    TimerEntry* allocTimer();
+    void freeTimer(TimerEntry *timer);
+    void runFunctionsToPerform();
 
     float _timeScale;
 
     //
     // "updates with priority" stuff
     //
-    struct _listEntry *_updatesNegList;        // list of priority < 0
-    struct _listEntry *_updates0List;            // list priority == 0
-    struct _listEntry *_updatesPosList;        // list priority > 0
-    struct _hashUpdateEntry *_hashForUpdates; // hash used to fetch quickly the list entries for pause,delete,etc
+    std::vector<UpdateEntry> _updateLists[UPDATE_LIST_COUNT];
+    // entries marked for deletion since the arrays were last compacted
+    size_t _deadUpdateCount;
+    std::unordered_map<void*, TargetEntry> _targets;
 
     // Used for "selectors with interval"
-    struct _hashSelectorEntry *_hashForTimers;
-    struct _hashSelectorEntry *_currentTarget;
-    bool _currentTargetSalvaged;
-    // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
+    double _time; // sum of the scaled tick durations, what timers are due against
+    long long _wheelTick;
+    TimerEntry *_timerWheel[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    TimerEntry *_startingTimers; // their first tick only starts them, like Timer::update
+    TimerEntry *_everyFrameTimers; // interval 0
+    TimerEntry *_timerCursor; // next timer of the list being run, unlinking a timer moves it on
+    TimerEntry *_freeTimers;
+    std::vector<TimerEntry*> _timerBlocks;
+    // If true unschedule will not remove anything from the update arrays. Elements will only be marked for deletion.
     bool _updateHashLocked;
     
 #if CC_ENABLE_SCRIPT_BINDING
@@ -530,8 +619,11 @@ protected:
 #endif
     
     // Used for "perform Function"
-    std::vector<std::function<void()>> _functionsToPerform;
-    std::mutex _performMutex;
+    std::atomic<PerformEntry*> _functionsToPerform; // pushed by any thread, newest first
+    PerformEntry *_pendingFunctions; // taken from the queue, oldest first, left over by the time budget
+    PerformEntry *_pendingFunctionsTail;
+    float _performTimeBudget;
+    bool *_performDestroyed; // set by the destructor while runFunctionsToPerform() calls the functions
 };
 
 // end of base group
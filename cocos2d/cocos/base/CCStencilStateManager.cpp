@@ -148,7 +148,7 @@ void StencilStateManager::onBeforeVisit()
     
     // manually save the stencil state
     
-    _currentStencilEnabled = glIsEnabled(GL_STENCIL_TEST);
+    _currentStencilEnabled = GL::isEnabled(GL_STENCIL_TEST);
     glGetIntegerv(GL_STENCIL_WRITEMASK, (GLint *)&_currentStencilWriteMask);
     glGetIntegerv(GL_STENCIL_FUNC, (GLint *)&_currentStencilFunc);
     glGetIntegerv(GL_STENCIL_REF, &_currentStencilRef);
@@ -158,7 +158,7 @@ void StencilStateManager::onBeforeVisit()
     glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS, (GLint *)&_currentStencilPassDepthPass);
     
     // enable stencil use
-    glEnable(GL_STENCIL_TEST);
+    GL::enable(GL_STENCIL_TEST);
     //    RenderState::StateBlock::_defaultState->setStencilTest(true);
     
     // check for OpenGL error while enabling stencil test
@@ -171,7 +171,7 @@ void StencilStateManager::onBeforeVisit()
     
     // manually save the depth test state
     
-    glGetBooleanv(GL_DEPTH_WRITEMASK, &_currentDepthWriteMask);
+    _currentDepthWriteMask = GL::getDepthMask();
     
     // disable depth test while drawing the stencil
     //glDisable(GL_DEPTH_TEST);
@@ -179,7 +179,7 @@ void StencilStateManager::onBeforeVisit()
     // as the stencil is not meant to be rendered in the real scene,
     // it should never prevent something else to be drawn,
     // only disabling depth buffer update should do
-    glDepthMask(GL_FALSE);
+    GL::depthMask(GL_FALSE);
     RenderState::StateBlock::_defaultState->setDepthWrite(false);
     
     ///////////////////////////////////
@@ -254,7 +254,7 @@ void StencilStateManager::onAfterDrawStencil()
     }
     
     // restore the depth test state
-    glDepthMask(_currentDepthWriteMask);
+    GL::depthMask(_currentDepthWriteMask);
     RenderState::StateBlock::_defaultState->setDepthWrite(_currentDepthWriteMask != 0);
     
     //if (currentDepthTestEnabled) {
@@ -297,7 +297,7 @@ void StencilStateManager::onAfterVisit()
     glStencilMask(_currentStencilWriteMask);
     if (!_currentStencilEnabled)
     {
-        glDisable(GL_STENCIL_TEST);
+        GL::disable(GL_STENCIL_TEST);
         //        RenderState::StateBlock::_defaultState->setStencilTest(false);
     }
     
@@ -46,6 +46,18 @@ THE SOFTWARE.
 #define CC_ENABLE_STACKABLE_ACTIONS 1
 #endif
 
+/** @def CC_ENABLE_ACTION_BATCHING
+ * If enabled, MoveBy, MoveTo, ScaleBy, ScaleTo, FadeTo, FadeIn and FadeOut actions run directly on a node are stepped
+ * by the ActionManager from contiguous arrays instead of through Action::step().
+ * Batched actions are stepped after the other actions of the frame, so an action which reads a node moved by a
+ * batched one (e.g. Follow) sees the position of the previous frame.
+ * Disabled by default. Enable it when the order actions of one node are stepped in doesn't matter to the game.
+ * @since v3.10
+ */
+#ifndef CC_ENABLE_ACTION_BATCHING
+#define CC_ENABLE_ACTION_BATCHING 0
+#endif
+
 /** @def CC_ENABLE_GL_STATE_CACHE
  * If enabled, cocos2d will maintain an OpenGL state cache internally to avoid unnecessary switches.
  * In order to use them, you have to use the following functions, instead of the GL ones:
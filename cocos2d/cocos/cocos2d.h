@@ -46,6 +46,7 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/CCIMEDelegate.h"
 #include "base/CCIMEDispatcher.h"
+#include "base/CCJobSystem.h"
 #include "base/CCMap.h"
 #include "base/CCNS.h"
 #include "base/CCProfiling.h"
@@ -152,15 +153,19 @@ THE SOFTWARE.
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCGroupCommand.h"
+#include "renderer/CCInstancedQuadCommand.h"
 #include "renderer/CCMaterial.h"
 #include "renderer/CCPass.h"
 #include "renderer/CCPrimitive.h"
 #include "renderer/CCPrimitiveCommand.h"
 #include "renderer/CCQuadCommand.h"
+#include "renderer/CCRenderArena.h"
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCRenderCommandPool.h"
 #include "renderer/CCRenderState.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCRenderWorkers.h"
+#include "renderer/CCStreamingBuffer.h"
 #include "renderer/CCTechnique.h"
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCTextureCube.h"
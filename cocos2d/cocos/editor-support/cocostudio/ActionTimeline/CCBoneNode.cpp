@@ -429,6 +429,7 @@ void BoneNode::updateVertices()
             _squareVertices[i] += _anchorPointInPoints;
         }
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        invalidateSubtreeBounds();
     }
 }
 
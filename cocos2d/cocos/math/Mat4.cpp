@@ -911,6 +911,16 @@ void Mat4::transformVector(float x, float y, float z, float w, Vec3* dst) const
     MathUtil::transformVec4(m, x, y, z, w, (float*)dst);
 }
 
+void Mat4::transformPoints(const Vec3* src, Vec3* dst, size_t count, size_t stride) const
+{
+    GP_ASSERT(src && dst);
+#ifdef __SSE__
+    MathUtil::transformVec3Points(col, (const float*)src, (float*)dst, count, stride);
+#else
+    MathUtil::transformVec3Points(m, (const float*)src, (float*)dst, count, stride);
+#endif
+}
+
 void Mat4::transformVector(Vec4* vector) const
 {
     GP_ASSERT(vector);
@@ -772,6 +772,19 @@ public:
      */
     inline void transformPoint(const Vec3& point, Vec3* dst) const { GP_ASSERT(dst); transformVector(point.x, point.y, point.z, 1.0f, dst); }
 
+    /**
+     * Transforms a batch of points by this matrix, using SSE or NEON when available.
+     *
+     * The points are read every stride bytes, e.g. the vertices of a V3F_C4B_T2F array with
+     * stride sizeof(V3F_C4B_T2F). Only the x, y and z of each point are written, src and dst may be the same.
+     *
+     * @param src The first point to transform.
+     * @param dst The first point to store the result in.
+     * @param count The number of points.
+     * @param stride The distance in bytes between two points, in both src and dst.
+     */
+    void transformPoints(const Vec3* src, Vec3* dst, size_t count, size_t stride) const;
+
     /**
      * Transforms the specified vector by this matrix by
      * treating the fourth (w) coordinate as zero.
@@ -261,6 +261,20 @@ void MathUtil::transformVec4(const float* m, const float* v, float* dst)
 #endif
 }
 
+void MathUtil::transformVec3Points(const float* m, const float* src, float* dst, size_t count, size_t stride)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::transformVec3Points(m, src, dst, count, stride);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::transformVec3Points(m, src, dst, count, stride);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::transformVec3Points(m, src, dst, count, stride);
+    else MathUtilC::transformVec3Points(m, src, dst, count, stride);
+#else
+    MathUtilC::transformVec3Points(m, src, dst, count, stride);
+#endif
+}
+
 void MathUtil::crossVec3(const float* v1, const float* v2, float* dst)
 {
 #ifdef USE_NEON32
@@ -41,6 +41,8 @@ public:
     
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
+    inline static void transformVec3Points(const float* m, const float* src, float* dst, size_t count, size_t stride);
+    
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
 };
 
@@ -204,6 +206,26 @@ inline void MathUtilC::transformVec4(const float* m, const float* v, float* dst)
     dst[3] = w;
 }
 
+inline void MathUtilC::transformVec3Points(const float* m, const float* src, float* dst, size_t count, size_t stride)
+{
+    // the matrix stays in registers for the whole batch.
+    const float m0 = m[0], m1 = m[1], m2 = m[2];
+    const float m4 = m[4], m5 = m[5], m6 = m[6];
+    const float m8 = m[8], m9 = m[9], m10 = m[10];
+    const float m12 = m[12], m13 = m[13], m14 = m[14];
+    const char* in = (const char*)src;
+    char* out = (char*)dst;
+    for (size_t i = 0; i < count; ++i, in += stride, out += stride)
+    {
+        const float* v = (const float*)in;
+        float x = v[0], y = v[1], z = v[2];
+        float* d = (float*)out;
+        d[0] = x * m0 + y * m4 + z * m8 + m12;
+        d[1] = x * m1 + y * m5 + z * m9 + m13;
+        d[2] = x * m2 + y * m6 + z * m10 + m14;
+    }
+}
+
 inline void MathUtilC::crossVec3(const float* v1, const float* v2, float* dst)
 {
     float x = (v1[1] * v2[2]) - (v1[2] * v2[1]);
@@ -18,6 +18,8 @@
  This file was modified to fit the cocos2d-x project
  */
 
+#include <arm_neon.h>
+
 NS_CC_MATH_BEGIN
 
 class MathUtilNeon64
@@ -41,6 +43,8 @@ public:
     
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
+    inline static void transformVec3Points(const float* m, const float* src, float* dst, size_t count, size_t stride);
+    
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
 };
 
@@ -223,6 +227,25 @@ inline void MathUtilNeon64::transformVec4(const float* m, const float* v, float*
     );
 }
 
+inline void MathUtilNeon64::transformVec3Points(const float* m, const float* src, float* dst, size_t count, size_t stride)
+{
+    // intrinsics rather than one asm block per point, so the matrix columns stay in registers across the batch.
+    float32x4_t c0 = vld1q_f32(m);
+    float32x4_t c1 = vld1q_f32(m + 4);
+    float32x4_t c2 = vld1q_f32(m + 8);
+    float32x4_t c3 = vld1q_f32(m + 12);
+    const char* in = (const char*)src;
+    char* out = (char*)dst;
+    for (size_t i = 0; i < count; ++i, in += stride, out += stride)
+    {
+        const float* v = (const float*)in;
+        float32x4_t r = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(c3, c0, v[0]), c1, v[1]), c2, v[2]);
+        // only x, y and z are written, the bytes after the point belong to the caller (e.g. vertex colors).
+        vst1_f32((float*)out, vget_low_f32(r));
+        vst1q_lane_f32((float*)out + 2, r, 2);
+    }
+}
+
 inline void MathUtilNeon64::crossVec3(const float* v1, const float* v2, float* dst)
 {
         asm volatile(
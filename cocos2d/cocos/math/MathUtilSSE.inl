@@ -151,6 +151,23 @@ void MathUtil::transformVec4(const __m128 m[4], const __m128& v, __m128& dst)
                      );
 }
 
+void MathUtil::transformVec3Points(const __m128 m[4], const float* src, float* dst, size_t count, size_t stride)
+{
+    const char* in = (const char*)src;
+    char* out = (char*)dst;
+    for (size_t i = 0; i < count; ++i, in += stride, out += stride)
+    {
+        const float* v = (const float*)in;
+        __m128 r = _mm_add_ps(
+                              _mm_add_ps(_mm_mul_ps(m[0], _mm_set1_ps(v[0])), _mm_mul_ps(m[1], _mm_set1_ps(v[1]))),
+                              _mm_add_ps(_mm_mul_ps(m[2], _mm_set1_ps(v[2])), m[3])
+                              );
+        // only x, y and z are written, the bytes after the point belong to the caller (e.g. vertex colors).
+        _mm_storel_pi((__m64*)out, r);
+        _mm_store_ss((float*)out + 2, _mm_movehl_ps(r, r));
+    }
+}
+
 #endif
 
 
@@ -131,7 +131,7 @@ void Physics3DDebugDrawer::drawImplementation( const Mat4 &transform, uint32_t f
 {
     _program->use();
     _program->setUniformsForBuiltins(transform);
-    glEnable(GL_DEPTH_TEST);
+    GL::enable(GL_DEPTH_TEST);
 
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
 
@@ -161,7 +161,7 @@ void Physics3DDebugDrawer::drawImplementation( const Mat4 &transform, uint32_t f
 
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,_bufferCount);
 
-    glDisable(GL_DEPTH_TEST);
+    GL::disable(GL_DEPTH_TEST);
     RenderState::StateBlock::_defaultState->setDepthTest(false);
 }
 
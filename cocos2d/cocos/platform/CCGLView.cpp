@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/CCEventDispatcher.h"
 #include "2d/CCCamera.h"
+#include "renderer/ccGLStateCache.h"
 
 NS_CC_BEGIN
 
@@ -244,7 +245,7 @@ void GLView::setScissorInPoints(float x , float y , float w , float h)
 
 bool GLView::isScissorEnabled()
 {
-    return (GL_FALSE == glIsEnabled(GL_SCISSOR_TEST)) ? false : true;
+    return GL::isEnabled(GL_SCISSOR_TEST);
 }
 
 Rect GLView::getScissorRect() const
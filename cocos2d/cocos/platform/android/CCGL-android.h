@@ -65,6 +65,15 @@ extern PFNGLDELETEVERTEXARRAYSOESPROC glDeleteVertexArraysOESEXT;
 #define glBindVertexArrayOES glBindVertexArrayOESEXT
 #define glDeleteVertexArraysOES glDeleteVertexArraysOESEXT
 
+// GL_EXT_instanced_arrays / GL_EXT_draw_instanced, null when the driver has neither
+typedef void (GL_APIENTRYP CC_PFNGLDRAWELEMENTSINSTANCEDPROC) (GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei primcount);
+typedef void (GL_APIENTRYP CC_PFNGLVERTEXATTRIBDIVISORPROC) (GLuint index, GLuint divisor);
+extern CC_PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstancedEXTEXT;
+extern CC_PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisorEXTEXT;
+
+#define glDrawElementsInstanced glDrawElementsInstancedEXTEXT
+#define glVertexAttribDivisor glVertexAttribDivisorEXTEXT
+
 
 #endif // CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
 
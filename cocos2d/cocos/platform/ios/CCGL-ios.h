@@ -35,6 +35,8 @@ THE SOFTWARE.
 #define glBindVertexArray           glBindVertexArrayOES
 #define glMapBuffer                 glMapBufferOES
 #define glUnmapBuffer               glUnmapBufferOES
+#define glDrawElementsInstanced     glDrawElementsInstancedEXT
+#define glVertexAttribDivisor       glVertexAttribDivisorEXT
 
 #define GL_DEPTH24_STENCIL8         GL_DEPTH24_STENCIL8_OES
 #define GL_WRITE_ONLY               GL_WRITE_ONLY_OES
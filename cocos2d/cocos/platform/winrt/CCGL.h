@@ -44,6 +44,10 @@ THE SOFTWARE.
 #include "CCGL_Angle.h"
 #endif
 
+// ANGLE exposes instancing through GL_ANGLE_instanced_arrays, also on the ES 2 contexts
+#define glDrawElementsInstanced     glDrawElementsInstancedANGLE
+#define glVertexAttribDivisor       glVertexAttribDivisorANGLE
+
 
 
 #endif // __CCGL_H__
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #ifndef WIN32
 #include <alloca.h>
 #endif
+#include <climits>
 
 #include "base/CCDirector.h"
 #include "base/uthash.h"
@@ -64,6 +65,8 @@ const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR = "ShaderPositionTextu
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP = "ShaderPositionTextureColor_noMVP";
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST = "ShaderPositionTextureColorAlphaTest";
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV = "ShaderPositionTextureColorAlphaTest_NoMV";
+const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_YUV_NO_MVP = "ShaderPositionTextureYUV_noMVP";
+const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_INSTANCED = "ShaderPositionTextureColor_instanced";
 const char* GLProgram::SHADER_NAME_POSITION_COLOR = "ShaderPositionColor";
 const char* GLProgram::SHADER_NAME_POSITION_COLOR_TEXASPOINTSIZE = "ShaderPositionColorTexAsPointsize";
 const char* GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP = "ShaderPositionColor_noMVP";
@@ -82,6 +85,7 @@ const char* GLProgram::SHADER_NAME_LABEL_OUTLINE = "ShaderLabelOutline";
 const char* GLProgram::SHADER_3D_POSITION = "Shader3DPosition";
 const char* GLProgram::SHADER_3D_POSITION_TEXTURE = "Shader3DPositionTexture";
 const char* GLProgram::SHADER_3D_SKINPOSITION_TEXTURE = "Shader3DSkinPositionTexture";
+const char* GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED = "Shader3DPositionTextureInstanced";
 const char* GLProgram::SHADER_3D_POSITION_NORMAL = "Shader3DPositionNormal";
 const char* GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE = "Shader3DPositionNormalTexture";
 const char* GLProgram::SHADER_3D_SKINPOSITION_NORMAL_TEXTURE = "Shader3DSkinPositionNormalTexture";
@@ -122,6 +126,8 @@ const char* GLProgram::ATTRIBUTE_NAME_BLEND_WEIGHT = "a_blendWeight";
 const char* GLProgram::ATTRIBUTE_NAME_BLEND_INDEX = "a_blendIndex";
 const char* GLProgram::ATTRIBUTE_NAME_TANGENT = "a_tangent";
 const char* GLProgram::ATTRIBUTE_NAME_BINORMAL = "a_binormal";
+const char* GLProgram::ATTRIBUTE_NAME_INSTANCE_TRANSFORM = "a_instanceTransform";
+const char* GLProgram::ATTRIBUTE_NAME_INSTANCE_COLOR = "a_instanceColor";
 
 
 
@@ -186,6 +192,9 @@ GLProgram::GLProgram()
 , _vertShader(0)
 , _fragShader(0)
 , _flags()
+, _userUniformsStateID(0)
+, _applyingUserUniforms(false)
+, _timeUniformsFrame(UINT_MAX)
 {
     _director = Director::getInstance();
     CCASSERT(nullptr != _director, "Director is null when init a GLProgram");
@@ -258,6 +267,8 @@ bool GLProgram::initWithByteArrays(const GLchar* vShaderByteArray, const GLchar*
     }
 
     _hashForUniforms.clear();
+    _userUniformsStateID = 0;
+    _timeUniformsFrame = UINT_MAX;
 
     CHECK_GL_ERROR_DEBUG();
 
@@ -657,6 +668,20 @@ bool GLProgram::updateUniformLocation(GLint location, const GLvoid* data, unsign
         }
     }
 
+    // a user uniform set outside of GLProgramState::applyUniforms(), no state knows the values anymore
+    if (updated && !_applyingUserUniforms && _userUniformsStateID != 0)
+    {
+        bool builtIn = false;
+        for (int i = 0; i < UNIFORM_MAX && !builtIn; ++i)
+        {
+            builtIn = _builtInUniforms[i] == location;
+        }
+        if (!builtIn)
+        {
+            _userUniformsStateID = 0;
+        }
+    }
+
     return updated;
 }
 
@@ -887,7 +912,9 @@ void GLProgram::setUniformsForBuiltins(const Mat4 &matrixMV)
         setUniformLocationWithMatrix3fv(_builtInUniforms[UNIFORM_NORMAL_MATRIX], normalMat, 1);
     }
 
-    if (_flags.usesTime) {
+    // the same for all the draws of a frame
+    if (_flags.usesTime && _timeUniformsFrame != _director->getTotalFrames()) {
+        _timeUniformsFrame = _director->getTotalFrames();
         // This doesn't give the most accurate global time value.
         // Cocos2D doesn't store a high precision time value, so this will have to do.
         // Getting Mach time per frame per shader using time could be extremely expensive.
@@ -918,6 +945,8 @@ void GLProgram::reset()
     }
 
     _hashForUniforms.clear();
+    _userUniformsStateID = 0;
+    _timeUniformsFrame = UINT_MAX;
 }
 
 inline void GLProgram::clearShader()
@@ -165,6 +165,10 @@ public:
     static const char* SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST;
     /**Built in shader for 2d. Support Position, Texture and Color vertex attribute, include alpha test and without multiply vertex by MVP matrix.*/
     static const char* SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV;
+    /**Built in shader for 2d. Support Position, Texture and Color vertex attribute, without multiply vertex by MVP matrix. Converts planar YUV 4:2:0 to RGB, Y in CC_Texture0, U and V in the u_textureU and u_textureV uniforms.*/
+    static const char* SHADER_NAME_POSITION_TEXTURE_YUV_NO_MVP;
+    /**Built in shader for 2d instanced quads. Support Position, Texture and Color vertex attribute, and the per instance a_instanceTransform (model view) and a_instanceColor attributes.*/
+    static const char* SHADER_NAME_POSITION_TEXTURE_COLOR_INSTANCED;
     /**Built in shader for 2d. Support Position, Color vertex attribute.*/
     static const char* SHADER_NAME_POSITION_COLOR;
     /**Built in shader for 2d. Support Position, Color, Texture vertex attribute. texture coordinate will used as point size.*/
@@ -202,6 +206,11 @@ public:
     */
     static const char* SHADER_3D_SKINPOSITION_TEXTURE;
     /**
+    Built in shader used for 3D instanced meshes, support Position and Texture vertex attribute, and the per instance
+    a_instanceTransform attribute, with color specified by a uniform.
+    */
+    static const char* SHADER_3D_POSITION_TEXTURE_INSTANCED;
+    /**
     Built in shader used for 3D, support Position and Normal vertex attribute, used in lighting. with color specified by a uniform.
     */
     static const char* SHADER_3D_POSITION_NORMAL;
@@ -314,6 +323,10 @@ public:
     static const char* ATTRIBUTE_NAME_TANGENT;
     /**Attribute blend binormal.*/
     static const char* ATTRIBUTE_NAME_BINORMAL;
+    /**Attribute per instance transform, a mat4 taking four locations.*/
+    static const char* ATTRIBUTE_NAME_INSTANCE_TRANSFORM;
+    /**Attribute per instance color.*/
+    static const char* ATTRIBUTE_NAME_INSTANCE_COLOR;
     /**
     end of Built Attribute names
     @}
@@ -538,6 +551,12 @@ protected:
     std::unordered_map<std::string, VertexAttrib> _vertexAttribs;
     /**Hash value of uniforms for quick access.*/
     std::unordered_map<GLint, std::pair<GLvoid*, unsigned int>> _hashForUniforms;
+    /**Id of the GLProgramState whose user uniform values the program holds, 0 if unknown.*/
+    uint32_t _userUniformsStateID;
+    /**Set while a GLProgramState applies its user uniforms.*/
+    bool _applyingUserUniforms;
+    /**Frame the time uniforms were set in, they are the same for the whole frame.*/
+    unsigned int _timeUniformsFrame;
     //cached director pointer for calling
     Director* _director;
 };
@@ -42,6 +42,8 @@ enum {
     kShaderType_PositionTextureColor_noMVP,
     kShaderType_PositionTextureColorAlphaTest,
     kShaderType_PositionTextureColorAlphaTestNoMV,
+    kShaderType_PositionTextureYUV_noMVP,
+    kShaderType_PositionTextureColorInstanced,
     kShaderType_PositionColor,
     kShaderType_PositionColorTextureAsPointsize,
     kShaderType_PositionColor_noMVP,
@@ -58,6 +60,7 @@ enum {
     kShaderType_3DPosition,
     kShaderType_3DPositionTex,
     kShaderType_3DSkinPositionTex,
+    kShaderType_3DPositionTexInstanced,
     kShaderType_3DPositionNormal,
     kShaderType_3DPositionNormalTex,
     kShaderType_3DSkinPositionNormalTex,
@@ -151,6 +154,16 @@ void GLProgramCache::loadDefaultGLPrograms()
     p = new (std::nothrow) GLProgram();
     loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTestNoMV);
     _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV, p) );
+
+    // Position Texture Color YUV 4:2:0 without MVP, used by video frames
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_PositionTextureYUV_noMVP);
+    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_YUV_NO_MVP, p) );
+
+    // Position Texture Color drawn once per instance, used by InstancedQuadCommand
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_PositionTextureColorInstanced);
+    _programs.insert( std::make_pair(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_INSTANCED, p) );
     //
     // Position, Color shader
     //
@@ -237,6 +250,10 @@ void GLProgramCache::loadDefaultGLPrograms()
     loadDefaultGLProgram(p, kShaderType_3DSkinPositionTex);
     _programs.insert(std::make_pair(GLProgram::SHADER_3D_SKINPOSITION_TEXTURE, p));
 
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_3DPositionTexInstanced);
+    _programs.insert(std::make_pair(GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED, p));
+
     p = new GLProgram();
     loadDefaultGLProgram(p, kShaderType_3DPositionNormal);
     _programs.insert( std::make_pair(GLProgram::SHADER_3D_POSITION_NORMAL, p) );
@@ -301,6 +318,16 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV);
     p->reset();
     loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTestNoMV);
+
+    // Position Texture Color YUV 4:2:0 without MVP
+    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_YUV_NO_MVP);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_PositionTextureYUV_noMVP);
+
+    // Position Texture Color instanced
+    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_INSTANCED);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_PositionTextureColorInstanced);
     //
     // Position, Color shader
     //
@@ -382,6 +409,10 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p->reset();
     loadDefaultGLProgram(p, kShaderType_3DSkinPositionTex);
 
+    p = getGLProgram(GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_3DPositionTexInstanced);
+
     p = getGLProgram(GLProgram::SHADER_3D_POSITION_NORMAL);
     p->reset();
     loadDefaultGLProgram(p, kShaderType_3DPositionNormal);
@@ -461,6 +492,12 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_PositionTextureColorAlphaTestNoMV:
             p->initWithByteArrays(ccPositionTextureColor_noMVP_vert, ccPositionTextureColorAlphaTest_frag);
             break;
+        case kShaderType_PositionTextureYUV_noMVP:
+            p->initWithByteArrays(ccPositionTextureColor_noMVP_vert, ccPositionTextureYUV_frag);
+            break;
+        case kShaderType_PositionTextureColorInstanced:
+            p->initWithByteArrays(ccPositionTextureColor_instanced_vert, ccPositionTextureColor_noMVP_frag);
+            break;
         case kShaderType_PositionColor:
             p->initWithByteArrays(ccPositionColor_vert ,ccPositionColor_frag);
             break;
@@ -511,6 +548,9 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_3DSkinPositionTex:
             p->initWithByteArrays(cc3D_SkinPositionTex_vert, cc3D_ColorTex_frag);
             break;
+        case kShaderType_3DPositionTexInstanced:
+            p->initWithByteArrays(cc3D_InstancedPositionTex_vert, cc3D_ColorTex_frag);
+            break;
         case kShaderType_3DPositionNormal:
             {
                 std::string def = getShaderMacrosForLight();
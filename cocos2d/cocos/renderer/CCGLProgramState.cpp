@@ -56,6 +56,7 @@ UniformValue::UniformValue()
 : _uniform(nullptr)
 , _glprogram(nullptr)
 , _type(Type::VALUE)
+, _dirty(true)
 {
 }
 
@@ -63,6 +64,7 @@ UniformValue::UniformValue(Uniform *uniform, GLProgram* glprogram)
 : _uniform(uniform)
 , _glprogram(glprogram)
 , _type(Type::VALUE)
+, _dirty(true)
 {
 }
 
@@ -144,6 +146,19 @@ void UniformValue::apply()
                 break;
         }
     }
+    _dirty = false;
+}
+
+void UniformValue::bindTexture()
+{
+    if (_uniform->type == GL_SAMPLER_2D)
+    {
+        GL::bindTexture2DN(_value.tex.textureUnit, _value.tex.textureId);
+    }
+    else if (_uniform->type == GL_SAMPLER_CUBE)
+    {
+        GL::bindTextureN(_value.tex.textureUnit, _value.tex.textureId, GL_TEXTURE_CUBE_MAP);
+    }
 }
 
 void UniformValue::setCallback(const std::function<void(GLProgram*, Uniform*)> &callback)
@@ -164,6 +179,7 @@ void UniformValue::setCallback(const std::function<void(GLProgram*, Uniform*)> &
 void UniformValue::setTexture(GLuint textureId, GLuint textureUnit)
 {
     //CCASSERT(_uniform->type == GL_SAMPLER_2D, "Wrong type. expecting GL_SAMPLER_2D");
+    _dirty = _dirty || _type != Type::VALUE || _value.tex.textureId != textureId || _value.tex.textureUnit != textureUnit;
     _value.tex.textureId = textureId;
     _value.tex.textureUnit = textureUnit;
     _type = Type::VALUE;
@@ -171,6 +187,7 @@ void UniformValue::setTexture(GLuint textureId, GLuint textureUnit)
 void UniformValue::setInt(int value)
 {
     CCASSERT(_uniform->type == GL_INT, "Wrong type: expecting GL_INT");
+    _dirty = _dirty || _type != Type::VALUE || _value.intValue != value;
     _value.intValue = value;
     _type = Type::VALUE;
 }
@@ -178,6 +195,7 @@ void UniformValue::setInt(int value)
 void UniformValue::setFloat(float value)
 {
     CCASSERT(_uniform->type == GL_FLOAT, "Wrong type: expecting GL_FLOAT");
+    _dirty = _dirty || _type != Type::VALUE || _value.floatValue != value;
     _value.floatValue = value;
     _type = Type::VALUE;
 }
@@ -193,6 +211,7 @@ void UniformValue::setFloatv(ssize_t size, const float* pointer)
 void UniformValue::setVec2(const Vec2& value)
 {
     CCASSERT(_uniform->type == GL_FLOAT_VEC2, "Wrong type: expecting GL_FLOAT_VEC2");
+    _dirty = _dirty || _type != Type::VALUE || memcmp(_value.v2Value, &value, sizeof(_value.v2Value)) != 0;
 	memcpy(_value.v2Value, &value, sizeof(_value.v2Value));
     _type = Type::VALUE;
 }
@@ -208,6 +227,7 @@ void UniformValue::setVec2v(ssize_t size, const Vec2* pointer)
 void UniformValue::setVec3(const Vec3& value)
 {
     CCASSERT(_uniform->type == GL_FLOAT_VEC3, "Wrong type: expecting GL_FLOAT_VEC3");
+    _dirty = _dirty || _type != Type::VALUE || memcmp(_value.v3Value, &value, sizeof(_value.v3Value)) != 0;
 	memcpy(_value.v3Value, &value, sizeof(_value.v3Value));
     _type = Type::VALUE;
 
@@ -225,6 +245,7 @@ void UniformValue::setVec3v(ssize_t size, const Vec3* pointer)
 void UniformValue::setVec4(const Vec4& value)
 {
     CCASSERT (_uniform->type == GL_FLOAT_VEC4, "Wrong type: expecting GL_FLOAT_VEC4");
+    _dirty = _dirty || _type != Type::VALUE || memcmp(_value.v4Value, &value, sizeof(_value.v4Value)) != 0;
 	memcpy(_value.v4Value, &value, sizeof(_value.v4Value));
     _type = Type::VALUE;
 }
@@ -240,6 +261,7 @@ void UniformValue::setVec4v(ssize_t size, const Vec4* pointer)
 void UniformValue::setMat4(const Mat4& value)
 {
     CCASSERT(_uniform->type == GL_FLOAT_MAT4, "_uniform's type should be equal GL_FLOAT_MAT4.");
+    _dirty = _dirty || _type != Type::VALUE || memcmp(_value.matrixValue, &value, sizeof(_value.matrixValue)) != 0;
 	memcpy(_value.matrixValue, &value, sizeof(_value.matrixValue));
     _type = Type::VALUE;
 }
@@ -364,6 +386,12 @@ GLProgramState::GLProgramState()
 , _glprogram(nullptr)
 , _nodeBinding(nullptr)
 {
+    // 0 is for no state
+    static uint32_t s_lastStateID = 0;
+    _stateID = ++s_lastStateID;
+    if (_stateID == 0)
+        _stateID = ++s_lastStateID;
+
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
     /** listen the event that renderer was recreated on Android/WP8 */
     CCLOG("create rendererRecreatedListener for GLProgramState");
@@ -511,9 +539,25 @@ void GLProgramState::applyUniforms()
 {
     // set uniforms
     updateUniformsAndAttributes();
+
+    // When the program holds the values of this state already, only the changed values are sent.
+    // Pointers and callbacks can change without a setter, they are always applied.
+    bool upToDate = _glprogram->_userUniformsStateID == _stateID;
+    _glprogram->_applyingUserUniforms = true;
     for(auto& uniform : _uniforms) {
-        uniform.second.apply();
+        auto& value = uniform.second;
+        if (upToDate && !value._dirty && value._type == UniformValue::Type::VALUE)
+        {
+            // the texture units are shared by all the programs
+            value.bindTexture();
+        }
+        else
+        {
+            value.apply();
+        }
     }
+    _glprogram->_applyingUserUniforms = false;
+    _glprogram->_userUniformsStateID = _stateID;
 }
 
 void GLProgramState::setGLProgram(GLProgram *glprogram)
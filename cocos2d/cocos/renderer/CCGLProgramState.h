@@ -108,6 +108,8 @@ public:
     void apply();
 
 protected:
+    /**Bind the texture of a sampler uniform, for a value already in the program.*/
+    void bindTexture();
 
     enum class Type {
         VALUE,
@@ -121,6 +123,8 @@ protected:
     GLProgram* _glprogram;
     /** What kind of type is the Uniform */
     Type _type;
+    /** Whether the value changed since it was applied */
+    bool _dirty;
 
     /**
      @name Uniform Value Uniform
@@ -458,6 +462,9 @@ protected:
 
     Node* _nodeBinding; // weak ref
 
+    // identifies the state to its GLProgram, which knows the state whose uniform values it holds
+    uint32_t _stateID;
+
     // contains uniform name and variable
     std::unordered_map<std::string, std::string> _autoBindings;
 
@@ -0,0 +1,120 @@
+/****************************************************************************
+ Copyright (c) 2016 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCInstancedQuadCommand.h"
+
+#include <algorithm>
+
+#include "renderer/ccGLStateCache.h"
+#include "renderer/CCGLProgram.h"
+#include "renderer/CCRenderArena.h"
+#include "renderer/CCRenderer.h"
+
+NS_CC_BEGIN
+
+// the renderer asserts on QuadCommands of VBO_SIZE vertices or more
+static const ssize_t MAX_EXPANDED_QUADS_PER_COMMAND = Renderer::VBO_SIZE / 8;
+
+InstancedQuadCommand::InstancedQuadCommand()
+:_textureID(0)
+,_glProgramState(nullptr)
+,_blendType(BlendFunc::DISABLE)
+,_instances(nullptr)
+,_instanceCount(0)
+{
+    _type = RenderCommand::Type::INSTANCED_QUAD_COMMAND;
+}
+
+InstancedQuadCommand::~InstancedQuadCommand()
+{
+}
+
+void InstancedQuadCommand::init(float globalOrder, GLuint textureID, const BlendFunc& blendType, const V3F_C4B_T2F_Quad& quad,
+                                const Instance* instances, ssize_t instanceCount, uint32_t flags)
+{
+    // the transforms are in the instances
+    RenderCommand::init(globalOrder, Mat4::IDENTITY, flags);
+
+    if (_glProgramState == nullptr)
+    {
+        _glProgramState = GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_INSTANCED);
+    }
+
+    _textureID = textureID;
+    _blendType = blendType;
+    _quad = quad;
+    _instances = instances;
+    _instanceCount = instanceCount;
+}
+
+void InstancedQuadCommand::useMaterial() const
+{
+    //Set texture
+    GL::bindTexture2D(_textureID);
+
+    //set blend mode
+    GL::blendFunc(_blendType.src, _blendType.dst);
+
+    _glProgramState->applyGLProgram(Mat4::IDENTITY);
+    _glProgramState->applyUniforms();
+}
+
+QuadCommand* InstancedQuadCommand::expandInstances(RenderArena* arena, ssize_t* commandCount)
+{
+    // in the frame arena: the command can be queued several times in a frame
+    auto expandedQuads = arena->allocateArray<V3F_C4B_T2F_Quad>(_instanceCount);
+    for (ssize_t i = 0; i < _instanceCount; ++i)
+    {
+        const Instance& instance = _instances[i];
+        V3F_C4B_T2F_Quad& expanded = expandedQuads[i];
+        expanded = _quad;
+        instance.transform.transformPoints(&_quad.tl.vertices, &expanded.tl.vertices, 4, sizeof(V3F_C4B_T2F));
+
+        for (V3F_C4B_T2F* vertex = &expanded.tl; vertex <= &expanded.br; ++vertex)
+        {
+            Color4B& color = vertex->colors;
+            color.r = (GLubyte)(color.r * instance.color.r / 255);
+            color.g = (GLubyte)(color.g * instance.color.g / 255);
+            color.b = (GLubyte)(color.b * instance.color.b / 255);
+            color.a = (GLubyte)(color.a * instance.color.a / 255);
+        }
+    }
+
+    // the vertices are in world space already, the renderer batches them with the sprites
+    auto quadState = GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
+    *commandCount = (_instanceCount + MAX_EXPANDED_QUADS_PER_COMMAND - 1) / MAX_EXPANDED_QUADS_PER_COMMAND;
+    auto expandedCommands = arena->createArray<QuadCommand>(*commandCount);
+    for (ssize_t i = 0; i < *commandCount; ++i)
+    {
+        QuadCommand* command = expandedCommands + i;
+        ssize_t first = i * MAX_EXPANDED_QUADS_PER_COMMAND;
+        ssize_t count = std::min(MAX_EXPANDED_QUADS_PER_COMMAND, _instanceCount - first);
+        command->init(_globalOrder, _textureID, quadState, _blendType, &expandedQuads[first], count, Mat4::IDENTITY, 0);
+        command->set3D(_is3D);
+        command->setTransparent(_isTransparent);
+    }
+    return expandedCommands;
+}
+
+NS_CC_END
@@ -0,0 +1,117 @@
+/****************************************************************************
+ Copyright (c) 2016 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef _CC_INSTANCEDQUADCOMMAND_H_
+#define _CC_INSTANCEDQUADCOMMAND_H_
+
+#include "renderer/CCQuadCommand.h"
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+NS_CC_BEGIN
+
+class RenderArena;
+
+/**
+ Command used to render the same quad many times, e.g. the bullets of a pattern or the members of a crowd.
+ Only a transform and a color are submitted per instance: where the GL context supports instancing
+ (see Configuration::supportsInstancing) all of them are drawn by one glDrawElementsInstanced call,
+ otherwise the instances are expanded into quads batched like the ones of QuadCommand.
+ */
+class CC_DLL InstancedQuadCommand : public RenderCommand
+{
+public:
+    /** Per instance data, read by the a_instanceTransform and a_instanceColor attributes. */
+    struct Instance
+    {
+        /** Model view transform of the instance. */
+        Mat4 transform;
+        /** Multiplied with the vertex colors of the quad, premultiplied by the opacity. */
+        Color4B color;
+    };
+
+    /**Constructor.*/
+    InstancedQuadCommand();
+    /**Destructor.*/
+    ~InstancedQuadCommand();
+
+    /** Initializes the command.
+     @param globalOrder GlobalZOrder of the command.
+     @param textureID The openGL handle of the used texture.
+     @param blendType Blend function for the command.
+     @param quad The quad drawn for every instance, in the local space of the instances.
+     @param instances Transform and color of the instances, they must stay valid until the frame is drawn.
+     @param instanceCount The number of instances.
+     @param flags to indicate that the command is using 3D rendering or not.
+     */
+    void init(float globalOrder, GLuint textureID, const BlendFunc& blendType, const V3F_C4B_T2F_Quad& quad,
+              const Instance* instances, ssize_t instanceCount, uint32_t flags);
+
+    /**Apply the texture, shaders, programs, blend functions to GPU pipeline.*/
+    void useMaterial() const;
+    /**Get the openGL texture handle.*/
+    inline GLuint getTextureID() const { return _textureID; }
+    /**Get the quad drawn for every instance.*/
+    inline const V3F_C4B_T2F_Quad& getQuad() const { return _quad; }
+    /**Get the pointer of the instances.*/
+    inline const Instance* getInstances() const { return _instances; }
+    /**Get the number of instances.*/
+    inline ssize_t getInstanceCount() const { return _instanceCount; }
+    /**Get the glprogramstate of the instanced shader.*/
+    inline GLProgramState* getGLProgramState() const { return _glProgramState; }
+    /**Get the blend function.*/
+    inline BlendFunc getBlendType() const { return _blendType; }
+
+    /**
+     Expands the instances into quads, for contexts without instancing.
+     Returns the commandCount QuadCommands to process instead of this command, they and their quads
+     are created in arena.
+     */
+    QuadCommand* expandInstances(RenderArena* arena, ssize_t* commandCount);
+
+protected:
+    /**OpenGL handle for texture.*/
+    GLuint _textureID;
+    /**GLprogramstate of the instanced shader.*/
+    GLProgramState* _glProgramState;
+    /**Blend function when rendering the quads.*/
+    BlendFunc _blendType;
+    /**The quad drawn for every instance.*/
+    V3F_C4B_T2F_Quad _quad;
+    /**The pointer to the instances.*/
+    const Instance* _instances;
+    /**The number of instances.*/
+    ssize_t _instanceCount;
+};
+
+NS_CC_END
+
+/**
+ end of support group
+ @}
+ */
+#endif //_CC_INSTANCEDQUADCOMMAND_H_
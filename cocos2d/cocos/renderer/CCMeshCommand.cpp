@@ -41,6 +41,7 @@
 #include "renderer/CCTechnique.h"
 #include "renderer/CCMaterial.h"
 #include "renderer/CCPass.h"
+#include "renderer/CCVertexAttribBinding.h"
 #include "xxhash.h"
 
 NS_CC_BEGIN
@@ -56,6 +57,9 @@ MeshCommand::MeshCommand()
 , _vao(0)
 , _material(nullptr)
 , _stateBlock(nullptr)
+, _instanceTransforms(nullptr)
+, _instanceCount(0)
+, _instanceBuffer(0)
 {
     _type = RenderCommand::Type::MESH_COMMAND;
 
@@ -89,6 +93,8 @@ void MeshCommand::init(float globalZOrder,
     _indexFormat = indexFormat;
     _indexCount = indexCount;
     _mv.set(mv);
+    _instanceTransforms = nullptr;
+    _instanceCount = 0;
 
     _is3D = true;
 }
@@ -124,6 +130,8 @@ void MeshCommand::init(float globalZOrder,
     _indexFormat = indexFormat;
     _indexCount = indexCount;
     _mv.set(mv);
+    _instanceTransforms = nullptr;
+    _instanceCount = 0;
     
     _is3D = true;
 
@@ -151,9 +159,19 @@ void MeshCommand::setMatrixPaletteSize(int size)
     _matrixPaletteSize = size;
 }
 
+void MeshCommand::setInstanceTransforms(const Mat4* transforms, ssize_t count)
+{
+    _instanceTransforms = transforms;
+    _instanceCount = transforms ? count : 0;
+}
+
 MeshCommand::~MeshCommand()
 {
     releaseVAO();
+    if (_instanceBuffer)
+    {
+        glDeleteBuffers(1, &_instanceBuffer);
+    }
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
     Director::getInstance()->getEventDispatcher()->removeEventListener(_rendererRecreatedListener);
 #endif
@@ -220,8 +238,8 @@ void MeshCommand::batchDraw()
         {
             pass->bind(_mv);
 
-            glDrawElements(_primitive, (GLsizei)_indexCount, _indexFormat, 0);
-            CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _indexCount);
+            auto binding = pass->getVertexAttributeBinding();
+            drawElements(pass->getGLProgramState()->getGLProgram(), binding && binding->hasVAO());
 
             pass->unbind();
         }
@@ -234,8 +252,7 @@ void MeshCommand::batchDraw()
         applyRenderState();
 
         // Draw
-        glDrawElements(_primitive, (GLsizei)_indexCount, _indexFormat, 0);
-        CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _indexCount);
+        drawElements(_glProgramState->getGLProgram(), _vao != 0);
     }
 }
 void MeshCommand::postBatchDraw()
@@ -271,8 +288,8 @@ void MeshCommand::execute()
         {
             pass->bind(_mv, true);
 
-            glDrawElements(_primitive, (GLsizei)_indexCount, _indexFormat, 0);
-            CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _indexCount);
+            auto binding = pass->getVertexAttributeBinding();
+            drawElements(pass->getGLProgramState()->getGLProgram(), binding && binding->hasVAO());
 
             pass->unbind();
         }
@@ -285,15 +302,100 @@ void MeshCommand::execute()
         applyRenderState();
 
         // Draw
-        glDrawElements(_primitive, (GLsizei)_indexCount, _indexFormat, 0);
-        
-        CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _indexCount);
+        drawElements(_glProgramState->getGLProgram(), false);
     }
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
+void MeshCommand::drawElements(GLProgram* glProgram, bool vaoBound)
+{
+    GLint location = _instanceCount > 0 ? glProgram->getAttribLocation(GLProgram::ATTRIBUTE_NAME_INSTANCE_TRANSFORM) : -1;
+    if (location < 0)
+    {
+        if (_instanceCount <= 0)
+        {
+            glDrawElements(_primitive, (GLsizei)_indexCount, _indexFormat, 0);
+            CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _indexCount);
+            return;
+        }
+
+        // the program only knows the model view
+        for (ssize_t i = 0; i < _instanceCount; ++i)
+        {
+            glProgram->setUniformsForBuiltins(_mv * _instanceTransforms[i]);
+            glDrawElements(_primitive, (GLsizei)_indexCount, _indexFormat, 0);
+            CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _indexCount);
+        }
+        return;
+    }
+
+    // the attribute takes one location per column.
+    // The private VAOs only enable the mesh attribs, so the columns are known to be disabled in them;
+    // the default VAO has its enabled attribs in the state cache.
+    CCASSERT(location + 4 <= 16, "the instance transform must fit in the vertex attribs of the state cache");
+    uint32_t columns = 0xFu << location;
+    uint32_t enabledFlags = vaoBound ? 0 : GL::getEnabledVertexAttribs();
+
+    if (Configuration::getInstance()->supportsInstancing())
+    {
+        if (_instanceBuffer == 0)
+        {
+            glGenBuffers(1, &_instanceBuffer);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(Mat4) * _instanceCount, _instanceTransforms, GL_STREAM_DRAW);
+        if (!vaoBound)
+        {
+            GL::enableVertexAttribs(enabledFlags | columns);
+        }
+        for (GLint column = 0; column < 4; ++column)
+        {
+            if (vaoBound)
+                glEnableVertexAttribArray(location + column);
+            glVertexAttribPointer(location + column, 4, GL_FLOAT, GL_FALSE, sizeof(Mat4), (GLvoid*)(column * 4 * sizeof(float)));
+            glVertexAttribDivisor(location + column, 1);
+        }
+
+        glDrawElementsInstanced(_primitive, (GLsizei)_indexCount, _indexFormat, 0, (GLsizei)_instanceCount);
+        CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _indexCount * _instanceCount);
+
+        for (GLint column = 0; column < 4; ++column)
+        {
+            glVertexAttribDivisor(location + column, 0);
+            if (vaoBound)
+                glDisableVertexAttribArray(location + column);
+        }
+        if (!vaoBound)
+        {
+            GL::enableVertexAttribs(enabledFlags);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+    }
+    else
+    {
+        // a disabled attribute array reads the current value of the attribute, set once per instance
+        if (!vaoBound)
+        {
+            GL::enableVertexAttribs(enabledFlags & ~columns);
+        }
+        for (ssize_t i = 0; i < _instanceCount; ++i)
+        {
+            for (GLint column = 0; column < 4; ++column)
+            {
+                glVertexAttrib4fv(location + column, _instanceTransforms[i].m + column * 4);
+            }
+            glDrawElements(_primitive, (GLsizei)_indexCount, _indexFormat, 0);
+            CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _indexCount);
+        }
+        if (!vaoBound)
+        {
+            GL::enableVertexAttribs(enabledFlags);
+        }
+    }
+}
+
 void MeshCommand::buildVAO()
 {
     // FIXME: Assumes that all the passes in the Material share the same Vertex Attribs
@@ -334,6 +436,7 @@ void MeshCommand::releaseVAO()
 void MeshCommand::listenRendererRecreated(EventCustom* event)
 {
     _vao = 0;
+    _instanceBuffer = 0;
 }
 
 #endif
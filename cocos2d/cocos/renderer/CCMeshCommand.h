@@ -55,6 +55,14 @@ public:
     void setMatrixPaletteSize(int size);
     void setLightMask(unsigned int lightmask);
 
+    /**
+     Draws the mesh once per transform, each one applied before the model view of the command. A program
+     with the a_instanceTransform attribute (e.g. GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED) reads
+     them in one glDrawElementsInstanced call where supported, any other program is drawn once per transform.
+     The transforms must stay valid until the frame is drawn, init() resets them.
+     */
+    void setInstanceTransforms(const Mat4* transforms, ssize_t count);
+
     void execute();
     
     //used for batch
@@ -78,6 +86,10 @@ protected:
     // apply renderstate, not used when using material
     void applyRenderState();
 
+    // draws the elements once, or once per instance transform. vaoBound tells whether a private VAO holds the attribs,
+    // rather than the default one tracked by the GL state cache
+    void drawElements(GLProgram* glProgram, bool vaoBound);
+
 
     Vec4 _displayColor; // in order to support tint and fade in fade out
     
@@ -94,6 +106,11 @@ protected:
     GLenum _primitive;
     GLenum _indexFormat;
     ssize_t _indexCount;
+
+    // instancing mode, weak ref
+    const Mat4* _instanceTransforms;
+    ssize_t _instanceCount;
+    GLuint _instanceBuffer;
     
     // States, default value all false
 
@@ -0,0 +1,126 @@
+/****************************************************************************
+ Copyright (c) 2016 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCRenderArena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+// blocks are aligned for anything the renderer stores, Mat4 included
+static const size_t BLOCK_ALIGNMENT = 16;
+
+static char* allocateBlock(size_t size)
+{
+    // malloc only guarantees the alignment of the largest scalar type
+    return static_cast<char*>(malloc(size + BLOCK_ALIGNMENT));
+}
+
+static char* alignedStart(char* block)
+{
+    uintptr_t address = reinterpret_cast<uintptr_t>(block);
+    return reinterpret_cast<char*>((address + BLOCK_ALIGNMENT - 1) & ~(uintptr_t)(BLOCK_ALIGNMENT - 1));
+}
+
+RenderArena::RenderArena(size_t blockSize)
+: _offset(0)
+, _used(0)
+{
+    addBlock(blockSize);
+}
+
+RenderArena::~RenderArena()
+{
+    reset();
+    for (auto& block : _blocks)
+    {
+        free(block.data);
+    }
+}
+
+void RenderArena::addBlock(size_t minSize)
+{
+    // each block doubles the capacity, a frame needs a few of them at most
+    size_t size = _blocks.empty() ? minSize : std::max(minSize, getCapacity());
+    if (!_blocks.empty())
+    {
+        _used += _offset;
+    }
+    _blocks.push_back(Block{ allocateBlock(size), size });
+    _offset = 0;
+}
+
+void* RenderArena::allocate(size_t size, size_t alignment)
+{
+    CCASSERT(alignment <= BLOCK_ALIGNMENT && (alignment & (alignment - 1)) == 0, "unsupported alignment");
+
+    size_t offset = (_offset + alignment - 1) & ~(alignment - 1);
+    if (offset + size > _blocks.back().size)
+    {
+        addBlock(size);
+        offset = 0;
+    }
+    _offset = offset + size;
+    return alignedStart(_blocks.back().data) + offset;
+}
+
+void RenderArena::reset()
+{
+    // in reverse, like the destruction of locals
+    for (auto it = _destructors.rbegin(); it != _destructors.rend(); ++it)
+    {
+        it->destroy(it->object);
+    }
+    _destructors.clear();
+
+    if (_blocks.size() > 1)
+    {
+        // one block holding the whole frame keeps the next one contiguous
+        size_t size = getCapacity();
+        for (auto& block : _blocks)
+        {
+            free(block.data);
+        }
+        _blocks.clear();
+        _blocks.push_back(Block{ allocateBlock(size), size });
+    }
+    _offset = 0;
+    _used = 0;
+}
+
+size_t RenderArena::getCapacity() const
+{
+    size_t capacity = 0;
+    for (const auto& block : _blocks)
+    {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+NS_CC_END
@@ -0,0 +1,132 @@
+/****************************************************************************
+ Copyright (c) 2016 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_RENDER_ARENA_H_
+#define __CC_RENDER_ARENA_H_
+
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+ Linear allocator for the render commands and vertex data of one frame.
+ Allocations are carved one after the other out of a block, so the commands queued in a frame are
+ contiguous in memory, and are all released at once by reset(). The renderer resets its arena at
+ the end of Renderer::clean(), everything created in it is valid until then.
+ When a frame doesn't fit in the block, more blocks are added and reset() replaces them by a single
+ block large enough for the whole frame: after the first frames nothing is allocated anymore.
+ */
+class CC_DLL RenderArena
+{
+public:
+    /** @param blockSize The size in bytes of the first block. */
+    explicit RenderArena(size_t blockSize);
+    ~RenderArena();
+
+    /** Returns size bytes aligned on alignment, a power of two. */
+    void* allocate(size_t size, size_t alignment);
+
+    /** Returns uninitialized storage for count objects of type T, e.g. vertices. They are never destroyed. */
+    template <class T>
+    T* allocateArray(size_t count)
+    {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /** Constructs a T in the arena, its destructor is called by reset(). */
+    template <class T, class... Args>
+    T* create(Args&&... args)
+    {
+        T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value)
+        {
+            _destructors.push_back(Destructor{ &destroy<T>, object });
+        }
+        return object;
+    }
+
+    /** Default constructs count contiguous objects of type T, their destructors are called by reset(). */
+    template <class T>
+    T* createArray(size_t count)
+    {
+        T* objects = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        for (size_t i = 0; i < count; ++i)
+        {
+            new (objects + i) T();
+            if (!std::is_trivially_destructible<T>::value)
+            {
+                _destructors.push_back(Destructor{ &destroy<T>, objects + i });
+            }
+        }
+        return objects;
+    }
+
+    /** Destroys the objects created since the last reset and makes the memory available again. */
+    void reset();
+
+    /** Returns the bytes allocated since the last reset. */
+    size_t getUsedSize() const { return _used + _offset; }
+    /** Returns the bytes held by the arena. */
+    size_t getCapacity() const;
+
+protected:
+    struct Block
+    {
+        char* data;
+        size_t size;
+    };
+    struct Destructor
+    {
+        void (*destroy)(void*);
+        void* object;
+    };
+
+    template <class T>
+    static void destroy(void* object) { static_cast<T*>(object)->~T(); }
+
+    void addBlock(size_t minSize);
+
+    std::vector<Block> _blocks;        // the last one is allocated from
+    std::vector<Destructor> _destructors;
+    size_t _offset;                    // in the last block
+    size_t _used;                      // in the blocks before the last one
+};
+
+NS_CC_END
+
+/**
+ end of support group
+ @}
+ */
+#endif //__CC_RENDER_ARENA_H_
@@ -63,7 +63,9 @@ public:
         /**Primitive command, used to draw primitives such as lines, points and triangles.*/
         PRIMITIVE_COMMAND,
         /**Triangles command, used to draw triangles.*/
-        TRIANGLES_COMMAND
+        TRIANGLES_COMMAND,
+        /**Instanced quad command, used to draw one quad many times.*/
+        INSTANCED_QUAD_COMMAND
     };
 
     /**
@@ -0,0 +1,136 @@
+/****************************************************************************
+ Copyright (c) 2016 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCRenderWorkers.h"
+
+#include <algorithm>
+
+NS_CC_BEGIN
+
+// ranges handed out per thread, more than one so that uneven ranges balance out
+static const size_t RANGES_PER_THREAD = 4;
+
+RenderWorkers::RenderWorkers(unsigned int threadCount)
+: _func(nullptr)
+, _count(0)
+, _rangeSize(0)
+, _nextRange(0)
+, _busyThreads(0)
+, _generation(0)
+, _quit(false)
+{
+    _threads.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        _threads.push_back(std::thread(&RenderWorkers::workerLoop, this));
+    }
+}
+
+RenderWorkers::~RenderWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _workAvailable.notify_all();
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+void RenderWorkers::parallelFor(size_t count, size_t minRange, const std::function<void(size_t, size_t)>& func)
+{
+    if (_threads.empty() || count <= minRange)
+    {
+        if (count > 0)
+        {
+            func(0, count);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _func = &func;
+        _count = count;
+        _rangeSize = std::max(minRange, count / ((_threads.size() + 1) * RANGES_PER_THREAD));
+        _rangeSize = std::max(_rangeSize, (size_t)1);
+        _nextRange = 0;
+        _busyThreads = (unsigned int)_threads.size();
+        ++_generation;
+    }
+    _workAvailable.notify_all();
+
+    runRanges();
+
+    // every thread has to leave the job before func goes out of scope
+    std::unique_lock<std::mutex> lock(_mutex);
+    _workDone.wait(lock, [this]() { return _busyThreads == 0; });
+    _func = nullptr;
+}
+
+void RenderWorkers::runRanges()
+{
+    for (;;)
+    {
+        size_t begin = _nextRange.fetch_add(_rangeSize);
+        if (begin >= _count)
+        {
+            break;
+        }
+        (*_func)(begin, std::min(begin + _rangeSize, _count));
+    }
+}
+
+void RenderWorkers::workerLoop()
+{
+    unsigned int generation = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _workAvailable.wait(lock, [&]() { return _quit || _generation != generation; });
+            if (_quit)
+            {
+                return;
+            }
+            generation = _generation;
+        }
+
+        runRanges();
+
+        bool last;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            last = --_busyThreads == 0;
+        }
+        if (last)
+        {
+            _workDone.notify_one();
+        }
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,93 @@
+/****************************************************************************
+ Copyright (c) 2016 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_RENDER_WORKERS_H_
+#define __CC_RENDER_WORKERS_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+ Fork-join worker threads used by the renderer to split CPU work of one frame, like transforming
+ the nodes of large subtrees and filling the batched vertex buffers, over several cores.
+ Only the main thread submits work and it works along with the threads until everything is done,
+ nothing outlives the call. GL calls must never be made from the work functions.
+ */
+class CC_DLL RenderWorkers
+{
+public:
+    /** Starts threadCount threads, the calling thread is an extra worker. */
+    explicit RenderWorkers(unsigned int threadCount);
+    /** Stops and joins the threads. */
+    ~RenderWorkers();
+
+    /** Returns the number of threads, without the calling thread. */
+    unsigned int getThreadCount() const { return (unsigned int)_threads.size(); }
+
+    /**
+     Calls func(begin, end) on ranges covering [0, count), in parallel, and returns once all of them ran.
+     Ranges hold at least minRange items, less work than that runs on the calling thread only.
+     Not reentrant: func must not call parallelFor.
+     */
+    void parallelFor(size_t count, size_t minRange, const std::function<void(size_t, size_t)>& func);
+
+protected:
+    void workerLoop();
+    void runRanges();
+
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _workAvailable;
+    std::condition_variable _workDone;
+
+    // the job being run, only changed by parallelFor while no worker is inside it
+    const std::function<void(size_t, size_t)>* _func;
+    size_t _count;
+    size_t _rangeSize;
+    std::atomic<size_t> _nextRange;
+    unsigned int _busyThreads;
+    unsigned int _generation;
+    bool _quit;
+};
+
+NS_CC_END
+
+/**
+ end of support group
+ @}
+ */
+#endif //__CC_RENDER_WORKERS_H_
@@ -25,9 +25,12 @@
 #include "renderer/CCRenderer.h"
 
 #include <algorithm>
+#include <cfloat>
+#include <cstring>
 
 #include "renderer/CCTrianglesCommand.h"
 #include "renderer/CCQuadCommand.h"
+#include "renderer/CCInstancedQuadCommand.h"
 #include "renderer/CCBatchCommand.h"
 #include "renderer/CCCustomCommand.h"
 #include "renderer/CCGroupCommand.h"
@@ -37,7 +40,10 @@
 #include "renderer/CCMaterial.h"
 #include "renderer/CCTechnique.h"
 #include "renderer/CCPass.h"
+#include "renderer/CCRenderArena.h"
 #include "renderer/CCRenderState.h"
+#include "renderer/CCRenderWorkers.h"
+#include "renderer/CCStreamingBuffer.h"
 #include "renderer/ccGLStateCache.h"
 
 #include "base/CCConfiguration.h"
@@ -51,14 +57,93 @@
 NS_CC_BEGIN
 
 // helper
-static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
+// Returns an unsigned key ordered like the float: negative values are reversed and put below the positive ones.
+static uint32_t getFloatSortKey(float value)
 {
-    return a->getGlobalOrder() < b->getGlobalOrder();
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
 }
 
-static bool compare3DCommand(RenderCommand* a, RenderCommand* b)
+// Below that many commands an insertion sort is faster than the passes of the radix sort.
+static const size_t RADIX_SORT_MIN_COMMANDS = 32;
+
+// Commands that are never batched, and can't be moved, while reordering for batching.
+static const uint64_t BATCH_KEY_BARRIER = ~(uint64_t)0;
+// Commands that can be moved but are drawn on their own.
+static const uint64_t BATCH_KEY_ALONE = BATCH_KEY_BARRIER - 1;
+// How many runs of other materials a command looks back for one of its own.
+static const size_t BATCH_REORDER_LOOKBACK = 32;
+
+// Returns the command type and material in one key, and the bounds of the command's vertices on the z = 0 plane.
+static uint64_t getBatchKey(RenderCommand* command, Rect& bounds)
 {
-    return  a->getDepth() > b->getDepth();
+    const V3F_C4B_T2F* verts = nullptr;
+    ssize_t count = 0;
+    const Mat4* modelView = nullptr;
+    uint32_t materialID = 0;
+
+    auto type = command->getType();
+    if (type == RenderCommand::Type::TRIANGLES_COMMAND)
+    {
+        auto cmd = static_cast<TrianglesCommand*>(command);
+        verts = cmd->getVertices();
+        count = cmd->getVertexCount();
+        modelView = &cmd->getModelView();
+        materialID = cmd->getMaterialID();
+    }
+    else if (type == RenderCommand::Type::QUAD_COMMAND)
+    {
+        auto cmd = static_cast<QuadCommand*>(command);
+        verts = (const V3F_C4B_T2F*)cmd->getQuads();
+        count = cmd->getQuadCount() * 4;
+        modelView = &cmd->getModelView();
+        materialID = cmd->getMaterialID();
+    }
+    else
+    {
+        return BATCH_KEY_BARRIER;
+    }
+    if (count <= 0)
+    {
+        return BATCH_KEY_BARRIER;
+    }
+
+    // the local box of the vertices, transformed: enough for the overlap test as long as it stays on the z = 0 plane
+    Vec3 minimum = verts[0].vertices;
+    Vec3 maximum = verts[0].vertices;
+    for (ssize_t i = 1; i < count; ++i)
+    {
+        const Vec3& v = verts[i].vertices;
+        minimum.set(std::min(minimum.x, v.x), std::min(minimum.y, v.y), std::min(minimum.z, v.z));
+        maximum.set(std::max(maximum.x, v.x), std::max(maximum.y, v.y), std::max(maximum.z, v.z));
+    }
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    bool flat = true;
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        Vec3 point((corner & 1) ? maximum.x : minimum.x, (corner & 2) ? maximum.y : minimum.y, (corner & 4) ? maximum.z : minimum.z);
+        modelView->transformPoint(&point);
+        minX = std::min(minX, point.x);
+        minY = std::min(minY, point.y);
+        maxX = std::max(maxX, point.x);
+        maxY = std::max(maxY, point.y);
+        flat = flat && point.z == 0;
+    }
+    // the camera maps the z = 0 plane to the screen without folding it, so boxes apart on it are apart on screen.
+    // Off the plane, e.g. with a positionZ or a 3D rotation, the perspective projection moves the vertices on
+    // screen by their depth: the xy box no longer tells whether two commands overlap, such a command isn't moved.
+    if (!flat)
+    {
+        return BATCH_KEY_BARRIER;
+    }
+    bounds.setRect(minX, minY, maxX - minX, maxY - minY);
+
+    if (command->isSkipBatching() || materialID == Renderer::MATERIAL_ID_DO_NOT_BATCH)
+    {
+        return BATCH_KEY_ALONE;
+    }
+    return ((uint64_t)type << 32) | materialID;
 }
 
 // queue
@@ -112,9 +197,101 @@ ssize_t RenderQueue::size() const
 void RenderQueue::sort()
 {
     // Don't sort _queue0, it already comes sorted
-    std::sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]), std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
-    std::sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]), compareRenderCommand);
-    std::sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]), compareRenderCommand);
+    sortCommands(_commands[QUEUE_GROUP::TRANSPARENT_3D], true);
+    sortCommands(_commands[QUEUE_GROUP::GLOBALZ_NEG], false);
+    sortCommands(_commands[QUEUE_GROUP::GLOBALZ_POS], false);
+}
+
+void RenderQueue::sortCommands(std::vector<RenderCommand*>& commands, bool farthestFirst)
+{
+    size_t count = commands.size();
+    if (count < 2)
+    {
+        return;
+    }
+
+    // keys in the first half, the radix sort writes its passes to the second
+    _sortKeys.resize(count * 2);
+    uint32_t* keys = _sortKeys.data();
+    bool sorted = true;
+    for (size_t i = 0; i < count; ++i)
+    {
+        RenderCommand* command = commands[i];
+        keys[i] = farthestFirst ? ~getFloatSortKey(command->getDepth()) : getFloatSortKey(command->getGlobalOrder());
+        sorted = sorted && (i == 0 || keys[i - 1] <= keys[i]);
+    }
+    // the order of most scenes doesn't change between frames
+    if (sorted)
+    {
+        return;
+    }
+
+    if (count < RADIX_SORT_MIN_COMMANDS)
+    {
+        for (size_t i = 1; i < count; ++i)
+        {
+            uint32_t key = keys[i];
+            RenderCommand* command = commands[i];
+            size_t j = i;
+            for (; j > 0 && keys[j - 1] > key; --j)
+            {
+                keys[j] = keys[j - 1];
+                commands[j] = commands[j - 1];
+            }
+            keys[j] = key;
+            commands[j] = command;
+        }
+        return;
+    }
+
+    // LSD radix sort on bytes, stable so commands of equal key keep the order they were added in
+    size_t histograms[4][256] = {};
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t key = keys[i];
+        ++histograms[0][key & 0xff];
+        ++histograms[1][(key >> 8) & 0xff];
+        ++histograms[2][(key >> 16) & 0xff];
+        ++histograms[3][key >> 24];
+    }
+
+    _sortBuffer.resize(count);
+    uint32_t* sourceKeys = keys;
+    uint32_t* destinationKeys = keys + count;
+    RenderCommand** source = commands.data();
+    RenderCommand** destination = _sortBuffer.data();
+    for (int pass = 0; pass < 4; ++pass)
+    {
+        size_t* histogram = histograms[pass];
+        int shift = pass * 8;
+        // a byte all keys share doesn't move anything, e.g. the exponent of close global Z
+        if (histogram[(sourceKeys[0] >> shift) & 0xff] == count)
+        {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (int digit = 0; digit < 256; ++digit)
+        {
+            size_t digitCount = histogram[digit];
+            histogram[digit] = offset;
+            offset += digitCount;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t key = sourceKeys[i];
+            size_t position = histogram[(key >> shift) & 0xff]++;
+            destinationKeys[position] = key;
+            destination[position] = source[i];
+        }
+        std::swap(sourceKeys, destinationKeys);
+        std::swap(source, destination);
+    }
+
+    if (source != commands.data())
+    {
+        std::copy(source, source + count, commands.begin());
+    }
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -154,9 +331,9 @@ void RenderQueue::realloc(size_t reserveSize)
 
 void RenderQueue::saveRenderState()
 {
-    _isDepthEnabled = glIsEnabled(GL_DEPTH_TEST) != GL_FALSE;
-    _isCullEnabled = glIsEnabled(GL_CULL_FACE) != GL_FALSE;
-    glGetBooleanv(GL_DEPTH_WRITEMASK, &_isDepthWrite);
+    _isDepthEnabled = GL::isEnabled(GL_DEPTH_TEST);
+    _isCullEnabled = GL::isEnabled(GL_CULL_FACE);
+    _isDepthWrite = GL::getDepthMask();
     
     CHECK_GL_ERROR_DEBUG();
 }
@@ -165,28 +342,28 @@ void RenderQueue::restoreRenderState()
 {
     if (_isCullEnabled)
     {
-        glEnable(GL_CULL_FACE);
+        GL::enable(GL_CULL_FACE);
         RenderState::StateBlock::_defaultState->setCullFace(true);
     }
     else
     {
-        glDisable(GL_CULL_FACE);
+        GL::disable(GL_CULL_FACE);
         RenderState::StateBlock::_defaultState->setCullFace(false);
     }
     
     
     if (_isDepthEnabled)
     {
-        glEnable(GL_DEPTH_TEST);
+        GL::enable(GL_DEPTH_TEST);
         RenderState::StateBlock::_defaultState->setDepthTest(true);
     }
     else
     {
-        glDisable(GL_DEPTH_TEST);
+        GL::disable(GL_DEPTH_TEST);
         RenderState::StateBlock::_defaultState->setDepthTest(false);
     }
     
-    glDepthMask(_isDepthWrite);
+    GL::depthMask(_isDepthWrite);
     RenderState::StateBlock::_defaultState->setDepthWrite(_isDepthEnabled);
 
     CHECK_GL_ERROR_DEBUG();
@@ -196,6 +373,13 @@ void RenderQueue::restoreRenderState()
 //
 //
 static const int DEFAULT_RENDER_QUEUE = 0;
+// below that the vertices of a batch are filled on the GL thread only, waking the workers costs more
+static const int PARALLEL_FILL_MIN_VERTICES = 2048;
+static const size_t PARALLEL_FILL_MIN_COMMANDS = 32;
+// the streaming buffers grow up to this many full batches, when a frame doesn't fit in them
+static const size_t STREAMING_BUFFER_MAX_BATCHES = 8;
+// a thousand sprites worth of commands, the arena grows to the largest frame
+static const size_t FRAME_ARENA_BLOCK_SIZE = 256 * 1024;
 
 //
 // constructors, destructor, init
@@ -205,21 +389,35 @@ Renderer::Renderer()
 ,_lastBatchedMeshCommand(nullptr)
 ,_filledVertex(0)
 ,_filledIndex(0)
+,_quadIndicesVBO(0)
 ,_numberQuads(0)
 ,_glViewAssigned(false)
+,_drawnBatches(0)
+,_drawnVertices(0)
+,_drawCallsSaved(0)
 ,_isRendering(false)
 ,_isDepthTestFor2D(false)
+,_workers(nullptr)
+,_frameArena(nullptr)
+,_batchReorderEnabled(false)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
 {
     _groupCommandManager = new (std::nothrow) GroupCommandManager();
+
+    // room for two full batches to begin with, the same as the former separate quad and triangle buffers
+    _vertexStream = new (std::nothrow) StreamingBuffer(GL_ARRAY_BUFFER, 2 * VBO_SIZE * sizeof(V3F_C4B_T2F), STREAMING_BUFFER_MAX_BATCHES * VBO_SIZE * sizeof(V3F_C4B_T2F));
+    _indexStream = new (std::nothrow) StreamingBuffer(GL_ELEMENT_ARRAY_BUFFER, 2 * INDEX_VBO_SIZE * sizeof(GLushort), STREAMING_BUFFER_MAX_BATCHES * INDEX_VBO_SIZE * sizeof(GLushort));
     
+    _frameArena = new (std::nothrow) RenderArena(FRAME_ARENA_BLOCK_SIZE);
+
     _commandGroupStack.push(DEFAULT_RENDER_QUEUE);
     
     RenderQueue defaultRenderQueue;
     _renderGroups.push_back(defaultRenderQueue);
     _batchedCommands.reserve(BATCH_QUADCOMMAND_RESEVER_SIZE);
+    _batchedOffsets.reserve(BATCH_QUADCOMMAND_RESEVER_SIZE);
 
     // default clear color
     _clearColor = Color4F::BLACK;
@@ -229,9 +427,12 @@ Renderer::~Renderer()
 {
     _renderGroups.clear();
     _groupCommandManager->release();
+    CC_SAFE_DELETE(_workers);
     
-    glDeleteBuffers(2, _buffersVBO);
-    glDeleteBuffers(2, _quadbuffersVBO);
+    CC_SAFE_DELETE(_vertexStream);
+    CC_SAFE_DELETE(_frameArena);
+    CC_SAFE_DELETE(_indexStream);
+    glDeleteBuffers(1, &_quadIndicesVBO);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -274,6 +475,9 @@ void Renderer::initGLView()
 
 void Renderer::setupBuffer()
 {
+    _vertexStream->recreate();
+    _indexStream->recreate();
+
     if(Configuration::getInstance()->supportsShareableVAO())
     {
         setupVBOAndVAO();
@@ -286,57 +490,33 @@ void Renderer::setupBuffer()
 
 void Renderer::setupVBOAndVAO()
 {
-    //generate vbo and vao for trianglesCommand
+    //generate vao for trianglesCommand, the attribute offsets are set for each batch
     glGenVertexArrays(1, &_buffersVAO);
     GL::bindVAO(_buffersVAO);
 
-    glGenBuffers(2, &_buffersVBO[0]);
-
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, _verts, GL_DYNAMIC_DRAW);
-
-    // vertices
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexStream->getBuffer());
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, vertices));
-
-    // colors
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, colors));
-
-    // tex coords
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, _indices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexStream->getBuffer());
 
     // Must unbind the VAO before changing the element buffer.
     GL::bindVAO(0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    //generate vbo and vao for quadCommand
+    //generate vao for quadCommand, it streams its vertices from the same buffer
     glGenVertexArrays(1, &_quadVAO);
     GL::bindVAO(_quadVAO);
     
-    glGenBuffers(2, &_quadbuffersVBO[0]);
-    
-    glBindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * VBO_SIZE, _quadVerts, GL_DYNAMIC_DRAW);
-    
-    // vertices
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexStream->getBuffer());
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, vertices));
-    
-    // colors
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_COLOR);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, colors));
-    
-    // tex coords
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
     
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
+    glGenBuffers(1, &_quadIndicesVBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadIndicesVBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_quadIndices[0]) * INDEX_VBO_SIZE, _quadIndices, GL_STATIC_DRAW);
     
     // Must unbind the VAO before changing the element buffer.
@@ -349,8 +529,7 @@ void Renderer::setupVBOAndVAO()
 
 void Renderer::setupVBO()
 {
-    glGenBuffers(2, &_buffersVBO[0]);
-    glGenBuffers(2, &_quadbuffersVBO[0]);
+    glGenBuffers(1, &_quadIndicesVBO);
     mapBuffers();
 }
 
@@ -359,18 +538,7 @@ void Renderer::mapBuffers()
     // Avoid changing the element buffer for whatever VAO might be bound.
     GL::bindVAO(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, _verts, GL_DYNAMIC_DRAW);
-    
-    glBindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * VBO_SIZE, _quadVerts, GL_DYNAMIC_DRAW);
-    
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, _indices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadIndicesVBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_quadIndices[0]) * INDEX_VBO_SIZE, _quadIndices, GL_STATIC_DRAW);
     
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
@@ -378,6 +546,18 @@ void Renderer::mapBuffers()
     CHECK_GL_ERROR_DEBUG();
 }
 
+void Renderer::setVertexAttribPointers(size_t offset)
+{
+    // vertices
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, vertices)));
+
+    // colors
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, colors)));
+
+    // tex coords
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, texCoords)));
+}
+
 void Renderer::addCommand(RenderCommand* command)
 {
     int renderQueue =_commandGroupStack.top();
@@ -433,10 +613,11 @@ void Renderer::processRenderCommand(RenderCommand* command)
             drawBatchedTriangles();
         }
         
-        //Batch Triangles
+        //Batch Triangles, the vertices are filled when the batch is drawn
         _batchedCommands.push_back(cmd);
-        
-        fillVerticesAndIndices(cmd);
+        _batchedOffsets.push_back(std::make_pair(_filledVertex, _filledIndex));
+        _filledVertex += cmd->getVertexCount();
+        _filledIndex += cmd->getIndexCount();
         
         if(cmd->isSkipBatching())
         {
@@ -461,16 +642,33 @@ void Renderer::processRenderCommand(RenderCommand* command)
             drawBatchedQuads();
         }
         
-        //Batch Quads
+        //Batch Quads, the vertices are filled when the batch is drawn
         _batchQuadCommands.push_back(cmd);
-        
-        fillQuads(cmd);
+        _batchQuadOffsets.push_back(_numberQuads);
+        _numberQuads += cmd->getQuadCount();
         
         if(cmd->isSkipBatching())
         {
             drawBatchedQuads();
         }
     }
+    else if (RenderCommand::Type::INSTANCED_QUAD_COMMAND == commandType)
+    {
+        auto cmd = static_cast<InstancedQuadCommand*>(command);
+        if (Configuration::getInstance()->supportsInstancing())
+        {
+            flush();
+            drawInstancedQuads(cmd);
+        }
+        else
+        {
+            // batched with the quads around them
+            ssize_t count = 0;
+            auto quadCommands = cmd->expandInstances(_frameArena, &count);
+            for (ssize_t i = 0; i < count; ++i)
+                processRenderCommand(quadCommands + i);
+        }
+    }
     else if (RenderCommand::Type::MESH_COMMAND == commandType)
     {
         flush2D();
@@ -541,23 +739,23 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     {
         if(_isDepthTestFor2D)
         {
-            glEnable(GL_DEPTH_TEST);
-            glDepthMask(true);
-            glEnable(GL_BLEND);
+            GL::enable(GL_DEPTH_TEST);
+            GL::depthMask(true);
+            GL::enable(GL_BLEND);
             RenderState::StateBlock::_defaultState->setDepthTest(true);
             RenderState::StateBlock::_defaultState->setDepthWrite(true);
             RenderState::StateBlock::_defaultState->setBlend(true);
         }
         else
         {
-            glDisable(GL_DEPTH_TEST);
-            glDepthMask(false);
-            glEnable(GL_BLEND);
+            GL::disable(GL_DEPTH_TEST);
+            GL::depthMask(false);
+            GL::enable(GL_BLEND);
             RenderState::StateBlock::_defaultState->setDepthTest(false);
             RenderState::StateBlock::_defaultState->setDepthWrite(false);
             RenderState::StateBlock::_defaultState->setBlend(true);
         }
-        glDisable(GL_CULL_FACE);
+        GL::disable(GL_CULL_FACE);
         RenderState::StateBlock::_defaultState->setCullFace(false);
         
         for (auto it = zNegQueue.cbegin(); it != zNegQueue.cend(); ++it)
@@ -574,10 +772,10 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     if (opaqueQueue.size() > 0)
     {
         //Clear depth to achieve layered rendering
-        glEnable(GL_DEPTH_TEST);
-        glDepthMask(true);
-        glDisable(GL_BLEND);
-        glEnable(GL_CULL_FACE);
+        GL::enable(GL_DEPTH_TEST);
+        GL::depthMask(true);
+        GL::disable(GL_BLEND);
+        GL::enable(GL_CULL_FACE);
         RenderState::StateBlock::_defaultState->setDepthTest(true);
         RenderState::StateBlock::_defaultState->setDepthWrite(true);
         RenderState::StateBlock::_defaultState->setBlend(false);
@@ -597,10 +795,10 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     const auto& transQueue = queue.getSubQueue(RenderQueue::QUEUE_GROUP::TRANSPARENT_3D);
     if (transQueue.size() > 0)
     {
-        glEnable(GL_DEPTH_TEST);
-        glDepthMask(false);
-        glEnable(GL_BLEND);
-        glEnable(GL_CULL_FACE);
+        GL::enable(GL_DEPTH_TEST);
+        GL::depthMask(false);
+        GL::enable(GL_BLEND);
+        GL::enable(GL_CULL_FACE);
 
         RenderState::StateBlock::_defaultState->setDepthTest(true);
         RenderState::StateBlock::_defaultState->setDepthWrite(false);
@@ -623,9 +821,9 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     {
         if(_isDepthTestFor2D)
         {
-            glEnable(GL_DEPTH_TEST);
-            glDepthMask(true);
-            glEnable(GL_BLEND);
+            GL::enable(GL_DEPTH_TEST);
+            GL::depthMask(true);
+            GL::enable(GL_BLEND);
 
             RenderState::StateBlock::_defaultState->setDepthTest(true);
             RenderState::StateBlock::_defaultState->setDepthWrite(true);
@@ -634,16 +832,16 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
         }
         else
         {
-            glDisable(GL_DEPTH_TEST);
-            glDepthMask(false);
-            glEnable(GL_BLEND);
+            GL::disable(GL_DEPTH_TEST);
+            GL::depthMask(false);
+            GL::enable(GL_BLEND);
 
             RenderState::StateBlock::_defaultState->setDepthTest(false);
             RenderState::StateBlock::_defaultState->setDepthWrite(false);
             RenderState::StateBlock::_defaultState->setBlend(true);
 
         }
-        glDisable(GL_CULL_FACE);
+        GL::disable(GL_CULL_FACE);
         RenderState::StateBlock::_defaultState->setCullFace(false);
         
         for (auto it = zZeroQueue.cbegin(); it != zZeroQueue.cend(); ++it)
@@ -661,9 +859,9 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     {
         if(_isDepthTestFor2D)
         {
-            glEnable(GL_DEPTH_TEST);
-            glDepthMask(true);
-            glEnable(GL_BLEND);
+            GL::enable(GL_DEPTH_TEST);
+            GL::depthMask(true);
+            GL::enable(GL_BLEND);
             
             RenderState::StateBlock::_defaultState->setDepthTest(true);
             RenderState::StateBlock::_defaultState->setDepthWrite(true);
@@ -672,16 +870,16 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
         }
         else
         {
-            glDisable(GL_DEPTH_TEST);
-            glDepthMask(false);
-            glEnable(GL_BLEND);
+            GL::disable(GL_DEPTH_TEST);
+            GL::depthMask(false);
+            GL::enable(GL_BLEND);
             
             RenderState::StateBlock::_defaultState->setDepthTest(false);
             RenderState::StateBlock::_defaultState->setDepthWrite(false);
             RenderState::StateBlock::_defaultState->setBlend(true);
             
         }
-        glDisable(GL_CULL_FACE);
+        GL::disable(GL_CULL_FACE);
         RenderState::StateBlock::_defaultState->setCullFace(false);
         
         for (auto it = zPosQueue.cbegin(); it != zPosQueue.cend(); ++it)
@@ -709,6 +907,12 @@ void Renderer::render()
         for (auto &renderqueue : _renderGroups)
         {
             renderqueue.sort();
+            if (_batchReorderEnabled)
+            {
+                reorderForBatching(renderqueue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_NEG));
+                reorderForBatching(renderqueue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_ZERO));
+                reorderForBatching(renderqueue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_POS));
+            }
         }
         visitRenderQueue(_renderGroups[0]);
     }
@@ -716,12 +920,94 @@ void Renderer::render()
     _isRendering = false;
 }
 
+void Renderer::reorderForBatching(std::vector<RenderCommand*>& commands)
+{
+    // the queues are sorted by global Z, each range of equal Z is reordered on its own
+    auto first = commands.begin();
+    while (first != commands.end())
+    {
+        float z = (*first)->getGlobalOrder();
+        auto last = first + 1;
+        while (last != commands.end() && (*last)->getGlobalOrder() == z)
+        {
+            ++last;
+        }
+        if (last - first > 2)
+        {
+            reorderRange(first, last);
+        }
+        first = last;
+    }
+}
+
+void Renderer::reorderRange(std::vector<RenderCommand*>::iterator first, std::vector<RenderCommand*>::iterator last)
+{
+    // Each command joins the latest run of its material, unless it overlaps a command drawn after that run,
+    // which would then be covered by it. Otherwise it starts a new run. The runs are then drawn in order.
+    _batchRuns.clear();
+    _reorderedCommands.clear();
+    ssize_t callsBefore = 0;
+    uint64_t previousKey = BATCH_KEY_BARRIER;
+
+    for (auto it = first; it != last; ++it)
+    {
+        Rect bounds;
+        uint64_t key = getBatchKey(*it, bounds);
+        if (key != previousKey || key >= BATCH_KEY_ALONE)
+        {
+            ++callsBefore;
+        }
+        previousKey = key;
+
+        size_t run = _batchRuns.size();
+        if (key < BATCH_KEY_ALONE)
+        {
+            size_t lookback = std::min(_batchRuns.size(), BATCH_REORDER_LOOKBACK);
+            for (size_t i = _batchRuns.size(); i > _batchRuns.size() - lookback; --i)
+            {
+                auto& candidate = _batchRuns[i - 1];
+                if (candidate.key == key)
+                {
+                    candidate.bounds.merge(bounds);
+                    run = i - 1;
+                    break;
+                }
+                if (candidate.key == BATCH_KEY_BARRIER || candidate.bounds.intersectsRect(bounds))
+                {
+                    break;
+                }
+            }
+        }
+        if (run == _batchRuns.size())
+        {
+            BatchRun batchRun = { key, bounds };
+            _batchRuns.push_back(batchRun);
+        }
+        _reorderedCommands.push_back(std::make_pair(run, *it));
+    }
+
+    if (_batchRuns.size() == _reorderedCommands.size())
+    {
+        return; // nothing moved
+    }
+
+    std::stable_sort(_reorderedCommands.begin(), _reorderedCommands.end(),
+                     [](const std::pair<size_t, RenderCommand*>& a, const std::pair<size_t, RenderCommand*>& b) { return a.first < b.first; });
+    // a run never follows one of the same material, each is a draw call
+    ssize_t callsAfter = (ssize_t)_batchRuns.size();
+    for (size_t i = 0; i < _reorderedCommands.size(); ++i)
+    {
+        *(first + i) = _reorderedCommands[i].second;
+    }
+    _drawCallsSaved += std::max(callsBefore - callsAfter, (ssize_t)0);
+}
+
 void Renderer::clean()
 {
     // Clear render group
     for (size_t j = 0 ; j < _renderGroups.size(); j++)
     {
-        //commands are owned by nodes
+        //commands are owned by nodes or by the frame arena
         // for (const auto &cmd : _renderGroups[j])
         // {
         //     cmd->releaseToCommandPool();
@@ -732,20 +1018,28 @@ void Renderer::clean()
     // Clear batch commands
     _batchedCommands.clear();
     _batchQuadCommands.clear();
+    _batchedOffsets.clear();
+    _batchQuadOffsets.clear();
     _filledVertex = 0;
     _filledIndex = 0;
     _numberQuads = 0;
     _lastMaterialID = 0;
     _lastBatchedMeshCommand = nullptr;
+
+    _vertexStream->endFrame();
+    _indexStream->endFrame();
+
+    // nothing references the commands of the frame anymore
+    _frameArena->reset();
 }
 
 void Renderer::clear()
 {
     //Enable Depth mask to make sure glClear clear the depth buffer correctly
-    glDepthMask(true);
+    GL::depthMask(true);
     glClearColor(_clearColor.r, _clearColor.g, _clearColor.b, _clearColor.a);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glDepthMask(false);
+    GL::depthMask(false);
 
     RenderState::StateBlock::_defaultState->setDepthWrite(false);
 }
@@ -755,8 +1049,8 @@ void Renderer::setDepthTest(bool enable)
     if (enable)
     {
         glClearDepth(1.0f);
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(GL_LEQUAL);
+        GL::enable(GL_DEPTH_TEST);
+        GL::depthFunc(GL_LEQUAL);
 
         RenderState::StateBlock::_defaultState->setDepthTest(true);
         RenderState::StateBlock::_defaultState->setDepthFunction(RenderState::DEPTH_LEQUAL);
@@ -765,7 +1059,7 @@ void Renderer::setDepthTest(bool enable)
     }
     else
     {
-        glDisable(GL_DEPTH_TEST);
+        GL::disable(GL_DEPTH_TEST);
 
         RenderState::StateBlock::_defaultState->setDepthTest(false);
     }
@@ -774,40 +1068,86 @@ void Renderer::setDepthTest(bool enable)
     CHECK_GL_ERROR_DEBUG();
 }
 
-void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
+void Renderer::setWorkerThreadCount(unsigned int count)
 {
-    memcpy(_verts + _filledVertex, cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
-    const Mat4& modelView = cmd->getModelView();
-    
-    for(ssize_t i=0; i< cmd->getVertexCount(); ++i)
+    CCASSERT(!_isRendering, "Cannot change the worker threads while rendering");
+    if (count != getWorkerThreadCount())
+    {
+        CC_SAFE_DELETE(_workers);
+        if (count > 0)
+        {
+            _workers = new (std::nothrow) RenderWorkers(count);
+        }
+    }
+}
+
+unsigned int Renderer::getWorkerThreadCount() const
+{
+    return _workers ? _workers->getThreadCount() : 0;
+}
+
+void Renderer::fillBatchedTriangles()
+{
+    auto fill = [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            fillVerticesAndIndices(_batchedCommands[i], _batchedOffsets[i].first, _batchedOffsets[i].second);
+        }
+    };
+    if (_workers && _filledVertex >= PARALLEL_FILL_MIN_VERTICES)
+    {
+        _workers->parallelFor(_batchedCommands.size(), PARALLEL_FILL_MIN_COMMANDS, fill);
+    }
+    else
+    {
+        fill(0, _batchedCommands.size());
+    }
+}
+
+void Renderer::fillBatchedQuads()
+{
+    auto fill = [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            fillQuads(_batchQuadCommands[i], _batchQuadOffsets[i]);
+        }
+    };
+    if (_workers && _numberQuads * 4 >= PARALLEL_FILL_MIN_VERTICES)
     {
-        V3F_C4B_T2F *q = &_verts[i + _filledVertex];
-        Vec3 *vec1 = (Vec3*)&q->vertices;
-        modelView.transformPoint(vec1);
+        _workers->parallelFor(_batchQuadCommands.size(), PARALLEL_FILL_MIN_COMMANDS, fill);
     }
+    else
+    {
+        fill(0, _batchQuadCommands.size());
+    }
+}
+
+void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd, int vertexOffset, int indexOffset)
+{
+    memcpy(_verts + vertexOffset, cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
+    const Mat4& modelView = cmd->getModelView();
+    
+    // transformed in place, as one batch
+    Vec3* vertices = &_verts[vertexOffset].vertices;
+    modelView.transformPoints(vertices, vertices, cmd->getVertexCount(), sizeof(V3F_C4B_T2F));
     
     const unsigned short* indices = cmd->getIndices();
     //fill index
     for(ssize_t i=0; i< cmd->getIndexCount(); ++i)
     {
-        _indices[_filledIndex + i] = _filledVertex + indices[i];
+        _indices[indexOffset + i] = vertexOffset + indices[i];
     }
-    
-    _filledVertex += cmd->getVertexCount();
-    _filledIndex += cmd->getIndexCount();
 }
 
-void Renderer::fillQuads(const QuadCommand *cmd)
+void Renderer::fillQuads(const QuadCommand *cmd, int quadOffset)
 {
     const Mat4& modelView = cmd->getModelView();
     const V3F_C4B_T2F* quads =  (V3F_C4B_T2F*)cmd->getQuads();
-    for(ssize_t i=0; i< cmd->getQuadCount() * 4; ++i)
-    {
-        _quadVerts[i + _numberQuads * 4] = quads[i];
-        modelView.transformPoint(quads[i].vertices,&(_quadVerts[i + _numberQuads * 4].vertices));
-    }
+    V3F_C4B_T2F* dst = _quadVerts + quadOffset * 4;
+    memcpy(dst, quads, sizeof(V3F_C4B_T2F) * 4 * cmd->getQuadCount());
     
-    _numberQuads += cmd->getQuadCount();
+    // transformed in place, as one batch
+    modelView.transformPoints(&dst->vertices, &dst->vertices, cmd->getQuadCount() * 4, sizeof(V3F_C4B_T2F));
 }
 
 void Renderer::drawBatchedTriangles()
@@ -823,51 +1163,24 @@ void Renderer::drawBatchedTriangles()
         return;
     }
 
+    fillBatchedTriangles();
+
+    // the batch goes after the previous ones in the streaming buffers, the indices start at its first vertex
     if (Configuration::getInstance()->supportsShareableVAO())
     {
-        //Bind VAO
         GL::bindVAO(_buffersVAO);
-        //Set VBO data
-        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-
-        // option 1: subdata
-//        glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0])*start, sizeof(_quads[0]) * n , &_quads[start] );
-
-        // option 2: data
-//        glBufferData(GL_ARRAY_BUFFER, sizeof(quads_[0]) * (n-start), &quads_[start], GL_DYNAMIC_DRAW);
-
-        // option 3: orphaning + glMapBuffer
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _filledVertex, nullptr, GL_DYNAMIC_DRAW);
-        void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-        memcpy(buf, _verts, sizeof(_verts[0])* _filledVertex);
-        glUnmapBuffer(GL_ARRAY_BUFFER);
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices, GL_STATIC_DRAW);
     }
     else
     {
-#define kQuadSize sizeof(_verts[0])
-        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _filledVertex , _verts, GL_DYNAMIC_DRAW);
-
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+    }
 
-        // vertices
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, vertices));
-
-        // colors
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, colors));
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexStream->getBuffer());
+    size_t vertexOffset = _vertexStream->write(_verts, sizeof(_verts[0]) * _filledVertex);
+    setVertexAttribPointers(vertexOffset);
 
-        // tex coords
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices, GL_STATIC_DRAW);
-    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexStream->getBuffer());
+    size_t indexOffset = _indexStream->write(_indices, sizeof(_indices[0]) * _filledIndex);
 
     //Start drawing vertices in batch
     for(const auto& cmd : _batchedCommands)
@@ -878,7 +1191,7 @@ void Renderer::drawBatchedTriangles()
             //Draw quads
             if(indexToDraw > 0)
             {
-                glDrawElements(GL_TRIANGLES, (GLsizei) indexToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (startIndex*sizeof(_indices[0])) );
+                glDrawElements(GL_TRIANGLES, (GLsizei) indexToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (indexOffset + startIndex*sizeof(_indices[0])) );
                 _drawnBatches++;
                 _drawnVertices += indexToDraw;
 
@@ -897,7 +1210,7 @@ void Renderer::drawBatchedTriangles()
     //Draw any remaining triangles
     if(indexToDraw > 0)
     {
-        glDrawElements(GL_TRIANGLES, (GLsizei) indexToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (startIndex*sizeof(_indices[0])) );
+        glDrawElements(GL_TRIANGLES, (GLsizei) indexToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (indexOffset + startIndex*sizeof(_indices[0])) );
         _drawnBatches++;
         _drawnVertices += indexToDraw;
     }
@@ -914,6 +1227,7 @@ void Renderer::drawBatchedTriangles()
     }
 
     _batchedCommands.clear();
+    _batchedOffsets.clear();
     _filledVertex = 0;
     _filledIndex = 0;
 }
@@ -930,51 +1244,23 @@ void Renderer::drawBatchedQuads()
     {
         return;
     }
-    
+
+    fillBatchedQuads();
+
+    // the batch goes after the previous ones in the streaming buffer, the quad indices are static
     if (Configuration::getInstance()->supportsShareableVAO())
     {
-        //Bind VAO
         GL::bindVAO(_quadVAO);
-        //Set VBO data
-        glBindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
-        
-        // option 1: subdata
-        //  glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0])*start, sizeof(_quads[0]) * n , &_quads[start] );
-        
-        // option 2: data
-        //  glBufferData(GL_ARRAY_BUFFER, sizeof(quads_[0]) * (n-start), &quads_[start], GL_DYNAMIC_DRAW);
-        
-        // option 3: orphaning + glMapBuffer
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * _numberQuads * 4, nullptr, GL_DYNAMIC_DRAW);
-        void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-        memcpy(buf, _quadVerts, sizeof(_quadVerts[0])* _numberQuads * 4);
-        glUnmapBuffer(GL_ARRAY_BUFFER);
-        
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
     }
     else
     {
-#define kQuadSize sizeof(_verts[0])
-        glBindBuffer(GL_ARRAY_BUFFER, _quadbuffersVBO[0]);
-        
-        glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * _numberQuads * 4 , _quadVerts, GL_DYNAMIC_DRAW);
-        
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
-        
-        // vertices
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, vertices));
-        
-        // colors
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, colors));
-        
-        // tex coords
-        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(V3F_C4B_T2F, texCoords));
-        
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadIndicesVBO);
     }
 
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexStream->getBuffer());
+    size_t vertexOffset = _vertexStream->write(_quadVerts, sizeof(_quadVerts[0]) * _numberQuads * 4);
+    setVertexAttribPointers(vertexOffset);
 
     // FIXME: The logic of this code is confusing, and error prone
     // Needs refactoring
@@ -1029,9 +1315,69 @@ void Renderer::drawBatchedQuads()
     }
     
     _batchQuadCommands.clear();
+    _batchQuadOffsets.clear();
     _numberQuads = 0;
 }
 
+void Renderer::drawInstancedQuads(InstancedQuadCommand* cmd)
+{
+    ssize_t instanceCount = cmd->getInstanceCount();
+    if (instanceCount <= 0)
+    {
+        return;
+    }
+
+    auto glProgram = cmd->getGLProgramState()->getGLProgram();
+    GLint transformLocation = glProgram->getAttribLocation(GLProgram::ATTRIBUTE_NAME_INSTANCE_TRANSFORM);
+    GLint colorLocation = glProgram->getAttribLocation(GLProgram::ATTRIBUTE_NAME_INSTANCE_COLOR);
+    CCASSERT(transformLocation >= 0 && colorLocation >= 0, "The instanced shader needs a_instanceTransform and a_instanceColor");
+
+    // the mat4 attribute takes four locations, one per column
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX | (0xF << transformLocation) | (1 << colorLocation));
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexStream->getBuffer());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadIndicesVBO);
+
+    cmd->useMaterial();
+
+    // the quad and the instances reading it must be in the same storage of the ring
+    typedef InstancedQuadCommand::Instance Instance;
+    const size_t quadSize = sizeof(V3F_C4B_T2F_Quad);
+    const size_t reserveSize = quadSize + 16;
+    ssize_t maxInstances = (ssize_t)((_vertexStream->getCapacity() - reserveSize) / sizeof(Instance));
+
+    for (ssize_t first = 0; first < instanceCount; first += maxInstances)
+    {
+        ssize_t count = std::min(maxInstances, instanceCount - first);
+        _vertexStream->reserve(reserveSize + count * sizeof(Instance));
+        size_t quadOffset = _vertexStream->write(&cmd->getQuad(), quadSize);
+        size_t instanceOffset = _vertexStream->write(cmd->getInstances() + first, count * sizeof(Instance));
+        setVertexAttribPointers(quadOffset);
+
+        for (GLint column = 0; column < 4; ++column)
+        {
+            glVertexAttribPointer(transformLocation + column, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+                                  (GLvoid*) (instanceOffset + offsetof(Instance, transform) + column * 4 * sizeof(float)));
+            glVertexAttribDivisor(transformLocation + column, 1);
+        }
+        glVertexAttribPointer(colorLocation, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Instance), (GLvoid*) (instanceOffset + offsetof(Instance, color)));
+        glVertexAttribDivisor(colorLocation, 1);
+
+        glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, (GLvoid*) 0, (GLsizei) count);
+        _drawnBatches++;
+        _drawnVertices += count * 6;
+    }
+
+    // other programs read these locations once per vertex
+    for (GLint column = 0; column < 4; ++column)
+    {
+        glVertexAttribDivisor(transformLocation + column, 0);
+    }
+    glVertexAttribDivisor(colorLocation, 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
 void Renderer::flush()
 {
     flush2D();
@@ -1073,6 +1419,11 @@ void Renderer::flushTriangles()
 
 // helpers
 bool Renderer::checkVisibility(const Mat4 &transform, const Size &size)
+{
+    return checkVisibility(transform, Rect(Vec2::ZERO, size));
+}
+
+bool Renderer::checkVisibility(const Mat4 &transform, const Rect &rect)
 {
     auto scene = Director::getInstance()->getRunningScene();
     
@@ -1085,9 +1436,9 @@ bool Renderer::checkVisibility(const Mat4 &transform, const Size &size)
     Rect visiableRect(director->getVisibleOrigin(), director->getVisibleSize());
     
     // transform center point to screen space
-    float hSizeX = size.width/2;
-    float hSizeY = size.height/2;
-    Vec3 v3p(hSizeX, hSizeY, 0);
+    float hSizeX = rect.size.width/2;
+    float hSizeY = rect.size.height/2;
+    Vec3 v3p(rect.origin.x + hSizeX, rect.origin.y + hSizeY, 0);
     transform.transformPoint(&v3p);
     Vec2 v2p = Camera::getVisitingCamera()->projectGL(v3p);
 
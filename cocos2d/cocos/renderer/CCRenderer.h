@@ -43,8 +43,12 @@ NS_CC_BEGIN
 
 class EventListenerCustom;
 class QuadCommand;
+class InstancedQuadCommand;
 class TrianglesCommand;
 class MeshCommand;
+class RenderArena;
+class RenderWorkers;
+class StreamingBuffer;
 
 /** Class that knows how to sort `RenderCommand` objects.
  Since the commands that have `z == 0` are "pushed back" in
@@ -78,7 +82,8 @@ public:
     void push_back(RenderCommand* command);
     /**Return the number of render commands.*/
     ssize_t size() const;
-    /**Sort the render commands.*/
+    /**Sort the render commands by global Z, and the transparent 3D ones from back to front.
+    The sort is stable and linear in the number of commands, a queue already in order isn't moved.*/
     void sort();
     /**Treat sorted commands as an array, access them one by one.*/
     RenderCommand* operator[](ssize_t index) const;
@@ -97,8 +102,14 @@ public:
     void restoreRenderState();
     
 protected:
+    /**Radix sort of the commands on their global Z, or on their depth from the farthest.*/
+    void sortCommands(std::vector<RenderCommand*>& commands, bool farthestFirst);
+
     /**The commands in the render queue.*/
     std::vector<RenderCommand*> _commands[QUEUE_COUNT];
+    /**Keys and commands of the radix sort passes, kept between frames.*/
+    std::vector<uint32_t> _sortKeys;
+    std::vector<RenderCommand*> _sortBuffer;
     
     /**Cull state.*/
     bool _isCullEnabled;
@@ -158,7 +169,7 @@ public:
     /** Renders into the GLView all the queued `RenderCommand` objects */
     void render();
 
-    /** Cleans all `RenderCommand`s in the queue */
+    /** Cleans all `RenderCommand`s in the queue, and resets the frame arena */
     void clean();
 
     /** Clear GL buffer and screen */
@@ -174,8 +185,21 @@ public:
     ssize_t getDrawnVertices() const { return _drawnVertices; }
     /* RenderCommands (except) QuadCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
+    /* returns the number of draw calls saved by the batch reordering in the last frame */
+    ssize_t getDrawCallsSaved() const { return _drawCallsSaved; }
     /* clear draw stats */
-    void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
+    void clearDrawStats() { _drawnBatches = _drawnVertices = _drawCallsSaved = 0; }
+
+    /**
+     * Enable/Disable the reordering of 2D commands with the same global Z by material, before rendering.
+     * Interleaved sprites of several atlases are then drawn in a few batches instead of one per sprite.
+     * A command is only moved before commands it doesn't overlap on screen, so the result looks the same. Commands with
+     * vertices off the z = 0 plane (a positionZ or a 3D rotation) are never moved, nor moved across.
+     * Disabled by default.
+     */
+    void setBatchReorderEnabled(bool enabled) { _batchReorderEnabled = enabled; }
+    /** Returns whether commands with the same global Z are reordered by material. */
+    bool isBatchReorderEnabled() const { return _batchReorderEnabled; }
 
     /**
      * Enable/Disable depth test
@@ -189,6 +213,27 @@ public:
 
     /** returns whether or not a rectangle is visible or not */
     bool checkVisibility(const Mat4& transform, const Size& size);
+    /** returns whether or not a rectangle in the space of the transform is visible or not */
+    bool checkVisibility(const Mat4& transform, const Rect& rect);
+
+    /**
+     * Enables multi-threaded rendering with count worker threads, 0 (the default) disables it.
+     * The vertices of batched QuadCommand and TrianglesCommand objects are then transformed on the workers,
+     * and nodes set with Node::setParallelVisit() update the transforms of their children on them.
+     * Commands are still queued and all GL calls made on the GL thread. Can't be changed while rendering.
+     */
+    void setWorkerThreadCount(unsigned int count);
+    /** Returns the number of worker threads, 0 when multi-threaded rendering is disabled. */
+    unsigned int getWorkerThreadCount() const;
+    /** Returns the worker threads, nullptr when multi-threaded rendering is disabled. */
+    RenderWorkers* getWorkers() const { return _workers; }
+
+    /**
+     * Returns the arena of the current frame. Commands and vertices created in it from Node::draw() live
+     * until the end of the frame, so a node can queue as many commands as it needs, and be drawn several
+     * times in a frame, without owning them. The queued commands are then contiguous in memory.
+     */
+    RenderArena* getFrameArena() const { return _frameArena; }
 
 protected:
 
@@ -197,8 +242,11 @@ protected:
     void setupVBOAndVAO();
     void setupVBO();
     void mapBuffers();
+    // points the vertex attributes at a batch written at offset in the vertex stream
+    void setVertexAttribPointers(size_t offset);
     void drawBatchedTriangles();
     void drawBatchedQuads();
+    void drawInstancedQuads(InstancedQuadCommand* cmd);
 
     //Draw the previews queued quads and flush previous context
     void flush();
@@ -210,11 +258,18 @@ protected:
     void flushQuads();
     void flushTriangles();
 
+    // groups the commands of each range of equal global Z by material, see setBatchReorderEnabled()
+    void reorderForBatching(std::vector<RenderCommand*>& commands);
+    void reorderRange(std::vector<RenderCommand*>::iterator first, std::vector<RenderCommand*>::iterator last);
+
     void processRenderCommand(RenderCommand* command);
     void visitRenderQueue(RenderQueue& queue);
 
-    void fillVerticesAndIndices(const TrianglesCommand* cmd);
-    void fillQuads(const QuadCommand* cmd);
+    // Vertices are filled when a batch is drawn, on the workers if there are enough of them.
+    void fillBatchedTriangles();
+    void fillBatchedQuads();
+    void fillVerticesAndIndices(const TrianglesCommand* cmd, int vertexOffset, int indexOffset);
+    void fillQuads(const QuadCommand* cmd, int quadOffset);
 
     /* clear color set outside be used in setGLDefaultValues() */
     Color4F _clearColor;
@@ -228,12 +283,18 @@ protected:
     MeshCommand*              _lastBatchedMeshCommand;
     std::vector<TrianglesCommand*> _batchedCommands;
     std::vector<QuadCommand*> _batchQuadCommands;
+    // where the vertices (and indices) of each batched command go in the buffers
+    std::vector<std::pair<int, int>> _batchedOffsets;
+    std::vector<int> _batchQuadOffsets;
+
+    //the batches of both command types are streamed to the GL buffers one after the other
+    StreamingBuffer* _vertexStream;
+    StreamingBuffer* _indexStream;
 
     //for TrianglesCommand
     V3F_C4B_T2F _verts[VBO_SIZE];
     GLushort _indices[INDEX_VBO_SIZE];
     GLuint _buffersVAO;
-    GLuint _buffersVBO[2]; //0: vertex  1: indices
 
     int _filledVertex;
     int _filledIndex;
@@ -242,7 +303,7 @@ protected:
     V3F_C4B_T2F _quadVerts[VBO_SIZE];
     GLushort _quadIndices[INDEX_VBO_SIZE];
     GLuint _quadVAO;
-    GLuint _quadbuffersVBO[2]; //0: vertex  1: indices
+    GLuint _quadIndicesVBO;
     int _numberQuads;
     
     bool _glViewAssigned;
@@ -250,12 +311,27 @@ protected:
     // stats
     ssize_t _drawnBatches;
     ssize_t _drawnVertices;
+    ssize_t _drawCallsSaved;
     //the flag for checking whether renderer is rendering
     bool _isRendering;
     
     bool _isDepthTestFor2D;
     
     GroupCommandManager* _groupCommandManager;
+
+    RenderWorkers* _workers;
+
+    RenderArena* _frameArena;
+
+    // consecutive commands of one material while reordering, with their screen bounds
+    struct BatchRun
+    {
+        uint64_t key;
+        Rect bounds;
+    };
+    bool _batchReorderEnabled;
+    std::vector<BatchRun> _batchRuns;
+    std::vector<std::pair<size_t, RenderCommand*>> _reorderedCommands;
     
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     EventListenerCustom* _cacheTextureListener;
@@ -0,0 +1,143 @@
+/****************************************************************************
+ Copyright (c) 2016 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCStreamingBuffer.h"
+
+#include <algorithm>
+
+#include "base/CCConfiguration.h"
+
+// glMapBufferRange is core in desktop GL 3 and GLES 3, iOS has GL_EXT_map_buffer_range.
+// Elsewhere the data is written with glBufferSubData.
+#if defined(GL_MAP_UNSYNCHRONIZED_BIT)
+#define CC_STREAMING_MAP_BUFFER_RANGE(target, offset, size) \
+    glMapBufferRange(target, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT)
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) && defined(GL_MAP_UNSYNCHRONIZED_BIT_EXT)
+#define CC_STREAMING_MAP_BUFFER_RANGE(target, offset, size) \
+    glMapBufferRangeEXT(target, offset, size, GL_MAP_WRITE_BIT_EXT | GL_MAP_INVALIDATE_RANGE_BIT_EXT | GL_MAP_UNSYNCHRONIZED_BIT_EXT)
+#endif
+
+NS_CC_BEGIN
+
+// offsets are kept aligned for the vertex attributes and the indices
+static const size_t WRITE_ALIGNMENT = 16;
+
+StreamingBuffer::StreamingBuffer(GLenum target, size_t capacity, size_t maxCapacity)
+: _target(target)
+, _buffer(0)
+, _capacity(capacity)
+, _maxCapacity(std::max(capacity, maxCapacity))
+, _offset(capacity)
+, _frameBytes(0)
+, _orphanCount(0)
+, _lastOrphanCount(0)
+, _useMapBufferRange(false)
+{
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+    if (_buffer)
+    {
+        glDeleteBuffers(1, &_buffer);
+    }
+}
+
+void StreamingBuffer::recreate()
+{
+    // the old name died with the context, the storage is allocated by the first write.
+    glGenBuffers(1, &_buffer);
+    _offset = _capacity;
+#ifdef CC_STREAMING_MAP_BUFFER_RANGE
+    _useMapBufferRange = Configuration::getInstance()->supportsMapBufferRange();
+#endif
+}
+
+void StreamingBuffer::orphan()
+{
+    glBufferData(_target, _capacity, nullptr, GL_STREAM_DRAW);
+    _offset = 0;
+    ++_orphanCount;
+}
+
+void StreamingBuffer::reserve(size_t size)
+{
+    CCASSERT(size <= _capacity, "StreamingBuffer: reserve larger than the buffer");
+    if (_offset + size > _capacity)
+    {
+        orphan();
+    }
+}
+
+size_t StreamingBuffer::write(const void* data, size_t size)
+{
+    CCASSERT(size <= _capacity, "StreamingBuffer: write larger than the buffer");
+    if (_offset + size > _capacity)
+    {
+        orphan();
+    }
+
+    size_t offset = _offset;
+    void* dst = nullptr;
+#ifdef CC_STREAMING_MAP_BUFFER_RANGE
+    // nothing drawn so far reads this range, the driver doesn't have to wait for the GPU.
+    if (_useMapBufferRange)
+    {
+        dst = CC_STREAMING_MAP_BUFFER_RANGE(_target, offset, size);
+    }
+#endif
+    if (dst)
+    {
+        memcpy(dst, data, size);
+        glUnmapBuffer(_target);
+    }
+    else
+    {
+        glBufferSubData(_target, offset, size, data);
+    }
+
+    _offset = std::min(_capacity, (offset + size + WRITE_ALIGNMENT - 1) & ~(WRITE_ALIGNMENT - 1));
+    _frameBytes += size;
+    return offset;
+}
+
+void StreamingBuffer::endFrame()
+{
+    // a frame should orphan the buffer once at most.
+    if (_orphanCount > 1 && _capacity < _maxCapacity)
+    {
+        size_t capacity = _capacity;
+        while (capacity < _frameBytes + _frameBytes / 4)
+        {
+            capacity *= 2;
+        }
+        _capacity = std::min(capacity, _maxCapacity);
+        _offset = _capacity;
+    }
+    _lastOrphanCount = _orphanCount;
+    _orphanCount = 0;
+    _frameBytes = 0;
+}
+
+NS_CC_END
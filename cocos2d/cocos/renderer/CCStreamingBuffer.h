@@ -0,0 +1,103 @@
+/****************************************************************************
+ Copyright (c) 2016 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_STREAMING_BUFFER_H_
+#define __CC_STREAMING_BUFFER_H_
+
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCGL.h"
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+ A GL buffer written as a ring, for data that is uploaded once and drawn once, like the batched
+ vertices of the renderer.
+ Each write goes after the previous one, so the GPU can still read earlier ranges. When the ring is
+ full the buffer is orphaned (glBufferData with no data) and writing starts over, the driver keeps
+ the old storage alive until the draws using it are done. Writes use unsynchronized glMapBufferRange
+ where supported and glBufferSubData otherwise. A ring too small to hold a whole frame grows.
+ */
+class CC_DLL StreamingBuffer
+{
+public:
+    /**
+     @param target GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER.
+     @param capacity The initial size in bytes.
+     @param maxCapacity The size in bytes the ring doesn't grow beyond.
+     */
+    StreamingBuffer(GLenum target, size_t capacity, size_t maxCapacity);
+    ~StreamingBuffer();
+
+    /** Creates the GL buffer, again after the GL context was lost. */
+    void recreate();
+
+    /** Returns the GL buffer. */
+    GLuint getBuffer() const { return _buffer; }
+    /** Returns the size of the ring in bytes. */
+    size_t getCapacity() const { return _capacity; }
+
+    /**
+     Copies size bytes at the end of the ring and returns their offset in the buffer.
+     The buffer must be bound to its target. size can't be more than the capacity.
+     */
+    size_t write(const void* data, size_t size);
+
+    /**
+     Makes the next writes of up to size bytes in total, alignment included, go to the same storage,
+     for draws reading several of them. The buffer must be bound to its target.
+     */
+    void reserve(size_t size);
+
+    /** Ends the frame: a ring that wrapped in it grows to hold what was written. */
+    void endFrame();
+
+    /** Returns how often the buffer was orphaned in the last frame. */
+    unsigned int getOrphanCount() const { return _lastOrphanCount; }
+
+protected:
+    void orphan();
+
+    GLenum _target;
+    GLuint _buffer;
+    size_t _capacity;
+    size_t _maxCapacity;
+    size_t _offset;           // where the next write goes, _capacity forces an orphan
+    size_t _frameBytes;       // written since the last endFrame()
+    unsigned int _orphanCount;
+    unsigned int _lastOrphanCount;
+    bool _useMapBufferRange;
+};
+
+NS_CC_END
+
+/**
+ end of support group
+ @}
+ */
+#endif //__CC_STREAMING_BUFFER_H_
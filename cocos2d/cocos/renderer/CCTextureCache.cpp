@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCJobSystem.h"
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
 
@@ -56,8 +57,7 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
-, _needQuit(false)
+: _needQuit(false)
 , _asyncRefCount(0)
 {
 }
@@ -68,8 +68,6 @@ TextureCache::~TextureCache()
 
     for( auto it=_textures.begin(); it!=_textures.end(); ++it)
         (it->second)->release();
-
-    CC_SAFE_DELETE(_loadingThread);
 }
 
 void TextureCache::destroyInstance()
@@ -93,30 +91,31 @@ std::string TextureCache::getDescription() const
 struct TextureCache::AsyncStruct
 {
 public:
-    AsyncStruct(const std::string& fn, std::function<void(Texture2D*)> f) : filename(fn), callback(f), loadSuccess(false) {}
+    AsyncStruct(const std::string& fn, std::function<void(Texture2D*)> f) : filename(fn), callback(f), loadSuccess(false), loaded(false) {}
     
     std::string filename;
     std::function<void(Texture2D*)> callback;
     Image image;
     bool loadSuccess;
+    std::atomic<bool> loaded;
+    JobSystem::JobHandle job;
 };
 
 /**
  The addImageAsync logic follow the steps:
- - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
+ - find the image has been add or not, if not add an AsyncStruct to _asyncStructQueue and schedule a job loading it (GL thread)
+ - load res and fill image data to AsyncStruct.image, then mark the AsyncStruct as loaded (JobSystem worker)
+ - on schedule callback, pop the loaded AsyncStructs at the front of _asyncStructQueue, convert image to texture, then delete AsyncStruct (GL thread)
  
- the Critical Area include these members:
- - _requestQueue: locked by _requestMutex
- - _responseQueue: locked by _responseMutex
+ the images are loaded in parallel, callbacks are still called in request order:
+ - AsyncStruct::loaded is the only member shared by both threads, the image is only touched by the job until it is set
  
  the object's life time:
  - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
+ - image data: new in JobSystem worker, delete in GL thread(by Image instance)
  
  Note:
- - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
+ - all AsyncStruct referenced in _asyncStructQueue, for unbind function use and to keep the callback order.
  
  How to deal add image many times?
  - At first, this situation is abnormal, we only ensure the logic is correct.
@@ -149,14 +148,6 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
         return;
     }
 
-    // lazy init
-    if (_loadingThread == nullptr)
-    {
-        // create a new thread to load images
-        _loadingThread = new std::thread(&TextureCache::loadImage, this);
-        _needQuit = false;
-    }
-
     if (0 == _asyncRefCount)
     {
         Director::getInstance()->getScheduler()->schedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this, 0, false);
@@ -169,11 +160,7 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
     
     // add async struct into queue
     _asyncStructQueue.push_back(data);
-    _requestMutex.lock();
-    _requestQueue.push_back(data);
-    _requestMutex.unlock();
-
-    _sleepCondition.notify_one();
+    data->job = JobSystem::getInstance()->schedule(std::bind(&TextureCache::loadImage, this, data));
 }
 
 void TextureCache::unbindImageAsync(const std::string& filename)
@@ -205,65 +192,25 @@ void TextureCache::unbindAllImageAsync()
     }
 }
 
-void TextureCache::loadImage()
+void TextureCache::loadImage(AsyncStruct* asyncStruct)
 {
-    AsyncStruct *asyncStruct = nullptr;
-    std::mutex signalMutex;
-    std::unique_lock<std::mutex> signal(signalMutex);
-    while (!_needQuit)
+    if (!_needQuit)
     {
-        // pop an AsyncStruct from request queue
-        _requestMutex.lock();
-        if(_requestQueue.empty())
-        {
-            asyncStruct = nullptr;
-        }else
-        {
-            asyncStruct = _requestQueue.front();
-            _requestQueue.pop_front();
-        }
-        _requestMutex.unlock();
-        
-        if (nullptr == asyncStruct) {
-            _sleepCondition.wait(signal);
-            continue;
-        }
-        
         // load image
         asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
-
-        // push the asyncStruct to response queue
-        _responseMutex.lock();
-        _responseQueue.push_back(asyncStruct);
-        _responseMutex.unlock();
     }
+    asyncStruct->loaded = true;
 }
 
 void TextureCache::addImageAsyncCallBack(float dt)
 {
     Texture2D *texture = nullptr;
     AsyncStruct *asyncStruct = nullptr;
-    while (true)
+    // an image loaded out of order waits for the ones requested before it
+    while (!_asyncStructQueue.empty() && _asyncStructQueue.front()->loaded)
     {
-        // pop an AsyncStruct from response queue
-        _responseMutex.lock();
-        if(_responseQueue.empty())
-        {
-            asyncStruct = nullptr;
-        }else
-        {
-            asyncStruct = _responseQueue.front();
-            _responseQueue.pop_front();
-            
-            // the asyncStruct's sequence order in _asyncStructQueue must equal to the order in _responseQueue
-            CC_ASSERT(asyncStruct == _asyncStructQueue.front());
-            _asyncStructQueue.pop_front();
-        }
-        _responseMutex.unlock();
-        
-        if (nullptr == asyncStruct) {
-            break;
-        }
+        asyncStruct = _asyncStructQueue.front();
+        _asyncStructQueue.pop_front();
         
         // check the image has been convert to texture or not
         auto it = _textures.find(asyncStruct->filename);
@@ -557,10 +504,17 @@ const std::string TextureCache::getTextureFilePath( cocos2d::Texture2D *texture
 
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
+    // pending jobs skip loading, the running ones are waited for. Once the JobSystem is stopped,
+    // as on Director::reset(), its running jobs were waited for and the queued ones dropped.
     _needQuit = true;
-    _sleepCondition.notify_one();
-    if (_loadingThread) _loadingThread->join();
+    auto jobSystem = JobSystem::getInstanceIfStarted();
+    if (jobSystem)
+    {
+        for (auto asyncStruct : _asyncStructQueue)
+        {
+            jobSystem->wait(asyncStruct->job);
+        }
+    }
 }
 
 std::string TextureCache::getCachedTextureInfo() const
@@ -29,6 +29,8 @@ THE SOFTWARE.
 #define __CCTEXTURE_CACHE_H__
 
 #include <string>
+#include <atomic>
+#include <deque>
 #include <mutex>
 #include <thread>
 #include <condition_variable>
@@ -216,25 +218,16 @@ public:
 
 
 private:
+    struct AsyncStruct;
+
     void addImageAsyncCallBack(float dt);
-    void loadImage();
+    void loadImage(AsyncStruct* asyncStruct);
     void parseNinePatchImage(Image* image, Texture2D* texture, const std::string& path);
 public:
 protected:
-    struct AsyncStruct;
-    
-    std::thread* _loadingThread;
-
     std::deque<AsyncStruct*> _asyncStructQueue;
-    std::deque<AsyncStruct*> _requestQueue;
-    std::deque<AsyncStruct*> _responseQueue;
-
-    std::mutex _requestMutex;
-    std::mutex _responseMutex;
-    
-    std::condition_variable _sleepCondition;
 
-    bool _needQuit;
+    std::atomic<bool> _needQuit;
 
     int _asyncRefCount;
 
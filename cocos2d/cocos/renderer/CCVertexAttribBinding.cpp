@@ -217,6 +217,11 @@ uint32_t VertexAttribBinding::getVertexAttribsFlags() const
     return _vertexAttribsFlags;
 }
 
+bool VertexAttribBinding::hasVAO() const
+{
+    return _handle != 0;
+}
+
 void VertexAttribBinding::parseAttributes()
 {
     CCASSERT(_glProgramState, "invalid glprogram");
@@ -86,6 +86,11 @@ public:
      */
     uint32_t getVertexAttribsFlags() const;
 
+    /**
+     * Returns whether bind() binds a vertex array object, or enables the attribs of the default one.
+     */
+    bool hasVAO() const;
+
 
 private:
 
@@ -43,8 +43,18 @@ namespace
     static GLuint s_currentProjectionMatrix = -1;
     static uint32_t s_attributeFlags = 0;  // 32 attributes max
 
+    static GL::StateStats s_stateStats = { 0, 0 };
+
 #if CC_ENABLE_GL_STATE_CACHE
 
+    // the capabilities with a shadow, the others are always passed to GL
+    static const int CAPABILITY_COUNT = 5;
+    static int       s_capabilities[CAPABILITY_COUNT] = { -1, -1, -1, -1, -1 }; // -1 is unknown
+    static int       s_depthMask = -1;
+    static GLenum    s_depthFunc = -1;
+    static GLenum    s_cullFace = -1;
+    static GLenum    s_frontFace = -1;
+
     static GLuint    s_currentShaderProgram = -1;
     static GLuint    s_currentBoundTexture[MAX_ACTIVE_TEXTURE] =  {(GLuint)-1,(GLuint)-1,(GLuint)-1,(GLuint)-1, (GLuint)-1,(GLuint)-1,(GLuint)-1,(GLuint)-1, (GLuint)-1,(GLuint)-1,(GLuint)-1,(GLuint)-1, (GLuint)-1,(GLuint)-1,(GLuint)-1,(GLuint)-1, };
     static GLenum    s_blendingSource = -1;
@@ -53,6 +63,19 @@ namespace
     static GLuint    s_VAO = 0;
     static GLenum    s_activeTexture = -1;
 
+    static int getCapabilityIndex(GLenum capability)
+    {
+        switch (capability)
+        {
+            case GL_BLEND: return 0;
+            case GL_CULL_FACE: return 1;
+            case GL_DEPTH_TEST: return 2;
+            case GL_SCISSOR_TEST: return 3;
+            case GL_STENCIL_TEST: return 4;
+            default: return -1;
+        }
+    }
+
 #endif // CC_ENABLE_GL_STATE_CACHE
 }
 
@@ -77,6 +100,16 @@ void invalidateStateCache( void )
     s_blendingDest = -1;
     s_GLServerState = 0;
     s_VAO = 0;
+    s_activeTexture = -1;
+
+    for (int i = 0; i < CAPABILITY_COUNT; i++)
+    {
+        s_capabilities[i] = -1;
+    }
+    s_depthMask = -1;
+    s_depthFunc = -1;
+    s_cullFace = -1;
+    s_frontFace = -1;
     
 #endif // CC_ENABLE_GL_STATE_CACHE
 }
@@ -98,9 +131,15 @@ void useProgram( GLuint program )
 #if CC_ENABLE_GL_STATE_CACHE
     if( program != s_currentShaderProgram ) {
         s_currentShaderProgram = program;
+        ++s_stateStats.issued;
         glUseProgram(program);
     }
+    else
+    {
+        ++s_stateStats.skipped;
+    }
 #else
+    ++s_stateStats.issued;
     glUseProgram(program);
 #endif // CC_ENABLE_GL_STATE_CACHE
 }
@@ -109,12 +148,13 @@ static void SetBlending(GLenum sfactor, GLenum dfactor)
 {
 	if (sfactor == GL_ONE && dfactor == GL_ZERO)
     {
-		glDisable(GL_BLEND);
+		disable(GL_BLEND);
         RenderState::StateBlock::_defaultState->setBlend(false);
 	}
     else
     {
-		glEnable(GL_BLEND);
+		enable(GL_BLEND);
+		++s_stateStats.issued;
 		glBlendFunc(sfactor, dfactor);
 
         RenderState::StateBlock::_defaultState->setBlend(true);
@@ -132,6 +172,10 @@ void blendFunc(GLenum sfactor, GLenum dfactor)
         s_blendingDest = dfactor;
         SetBlending(sfactor, dfactor);
     }
+    else
+    {
+        ++s_stateStats.skipped;
+    }
 #else
     SetBlending( sfactor, dfactor );
 #endif // CC_ENABLE_GL_STATE_CACHE
@@ -160,8 +204,13 @@ void bindTexture2DN(GLuint textureUnit, GLuint textureId)
 	{
 		s_currentBoundTexture[textureUnit] = textureId;
 		activeTexture(GL_TEXTURE0 + textureUnit);
+		++s_stateStats.issued;
 		glBindTexture(GL_TEXTURE_2D, textureId);
 	}
+	else
+	{
+		++s_stateStats.skipped;
+	}
 #else
 	glActiveTexture(GL_TEXTURE0 + textureUnit);
 	glBindTexture(GL_TEXTURE_2D, textureId);
@@ -176,8 +225,13 @@ void bindTextureN(GLuint textureUnit, GLuint textureId, GLuint textureType/* = G
     {
         s_currentBoundTexture[textureUnit] = textureId;
         activeTexture(GL_TEXTURE0 + textureUnit);
+        ++s_stateStats.issued;
         glBindTexture(textureType, textureId);
     }
+    else
+    {
+        ++s_stateStats.skipped;
+    }
 #else
     glActiveTexture(GL_TEXTURE0 + textureUnit);
     glBindTexture(textureType, textureId);
@@ -210,8 +264,13 @@ void activeTexture(GLenum texture)
 #if CC_ENABLE_GL_STATE_CACHE
     if(s_activeTexture != texture) {
         s_activeTexture = texture;
+        ++s_stateStats.issued;
         glActiveTexture(s_activeTexture);
     }
+    else
+    {
+        ++s_stateStats.skipped;
+    }
 #else
     glActiveTexture(texture);
 #endif
@@ -226,8 +285,13 @@ void bindVAO(GLuint vaoId)
         if (s_VAO != vaoId)
         {
             s_VAO = vaoId;
+            ++s_stateStats.issued;
             glBindVertexArray(vaoId);
         }
+        else
+        {
+            ++s_stateStats.skipped;
+        }
 #else
         glBindVertexArray(vaoId);
 #endif // CC_ENABLE_GL_STATE_CACHE
@@ -249,6 +313,7 @@ void enableVertexAttribs(uint32_t flags)
         bool enabledBefore = (s_attributeFlags & bit) != 0;
         if(enabled != enabledBefore) 
         {
+            ++s_stateStats.issued;
             if( enabled )
                 glEnableVertexAttribArray(i);
             else
@@ -258,6 +323,165 @@ void enableVertexAttribs(uint32_t flags)
     s_attributeFlags = flags;
 }
 
+uint32_t getEnabledVertexAttribs(void)
+{
+    return s_attributeFlags;
+}
+
+// GL server side state functions
+
+static void setCapability(GLenum capability, bool enabled)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    int index = getCapabilityIndex(capability);
+    if (index >= 0)
+    {
+        if (s_capabilities[index] == (enabled ? 1 : 0))
+        {
+            ++s_stateStats.skipped;
+            return;
+        }
+        s_capabilities[index] = enabled ? 1 : 0;
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    ++s_stateStats.issued;
+    if (enabled)
+        glEnable(capability);
+    else
+        glDisable(capability);
+}
+
+void enable(GLenum capability)
+{
+    setCapability(capability, true);
+}
+
+void disable(GLenum capability)
+{
+    setCapability(capability, false);
+}
+
+bool isEnabled(GLenum capability)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    int index = getCapabilityIndex(capability);
+    if (index >= 0)
+    {
+        if (s_capabilities[index] < 0)
+        {
+            s_capabilities[index] = glIsEnabled(capability) ? 1 : 0;
+        }
+        return s_capabilities[index] != 0;
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+    return glIsEnabled(capability) != GL_FALSE;
+}
+
+void depthMask(GLboolean flag)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    int mask = flag ? 1 : 0;
+    if (s_depthMask == mask)
+    {
+        ++s_stateStats.skipped;
+        return;
+    }
+    s_depthMask = mask;
+#endif // CC_ENABLE_GL_STATE_CACHE
+    ++s_stateStats.issued;
+    glDepthMask(flag);
+}
+
+GLboolean getDepthMask(void)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_depthMask < 0)
+    {
+        GLboolean flag = GL_TRUE;
+        glGetBooleanv(GL_DEPTH_WRITEMASK, &flag);
+        s_depthMask = flag ? 1 : 0;
+    }
+    return s_depthMask ? GL_TRUE : GL_FALSE;
+#else
+    GLboolean flag = GL_TRUE;
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &flag);
+    return flag;
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void depthFunc(GLenum func)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_depthFunc == func)
+    {
+        ++s_stateStats.skipped;
+        return;
+    }
+    s_depthFunc = func;
+#endif // CC_ENABLE_GL_STATE_CACHE
+    ++s_stateStats.issued;
+    glDepthFunc(func);
+}
+
+GLenum getDepthFunc(void)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_depthFunc == (GLenum)-1)
+    {
+        GLint func = GL_LESS;
+        glGetIntegerv(GL_DEPTH_FUNC, &func);
+        s_depthFunc = (GLenum)func;
+    }
+    return s_depthFunc;
+#else
+    GLint func = GL_LESS;
+    glGetIntegerv(GL_DEPTH_FUNC, &func);
+    return (GLenum)func;
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void cullFace(GLenum mode)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_cullFace == mode)
+    {
+        ++s_stateStats.skipped;
+        return;
+    }
+    s_cullFace = mode;
+#endif // CC_ENABLE_GL_STATE_CACHE
+    ++s_stateStats.issued;
+    glCullFace(mode);
+}
+
+void frontFace(GLenum mode)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_frontFace == mode)
+    {
+        ++s_stateStats.skipped;
+        return;
+    }
+    s_frontFace = mode;
+#endif // CC_ENABLE_GL_STATE_CACHE
+    ++s_stateStats.issued;
+    glFrontFace(mode);
+}
+
+// GL state statistics
+
+StateStats getStateStats(void)
+{
+    return s_stateStats;
+}
+
+void resetStateStats(void)
+{
+    s_stateStats.issued = 0;
+    s_stateStats.skipped = 0;
+}
+
 // GL Uniforms functions
 
 void setProjectionMatrixDirty( void )
@@ -118,6 +118,13 @@ void CC_DLL setProjectionMatrixDirty(void);
  */
 void CC_DLL enableVertexAttribs(uint32_t flags);
 
+/**
+ * Returns the vertex attribs enabled by the last enableVertexAttribs(), without querying GL.
+ * They are the ones of the default vertex array object, the VAOs keep their own.
+ * @since v3.10
+ */
+uint32_t CC_DLL getEnabledVertexAttribs(void);
+
 /** 
  * If the texture is not already bound to texture unit 0, it binds it.
  *
@@ -172,6 +179,95 @@ void CC_DLL activeTexture(GLenum texture);
  */
 void CC_DLL bindVAO(GLuint vaoId);
 
+/**
+ * Enables a capability of the GL server in case it is not already enabled.
+ * GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_SCISSOR_TEST and GL_STENCIL_TEST are cached, the other
+ * capabilities are always passed to glEnable(). Use it instead of glEnable() for the cached ones,
+ * or the cache no longer matches the GL state.
+ *
+ * If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glEnable() directly.
+ * @since v3.10
+ */
+void CC_DLL enable(GLenum capability);
+
+/**
+ * Disables a capability of the GL server in case it is not already disabled. See enable().
+ *
+ * If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDisable() directly.
+ * @since v3.10
+ */
+void CC_DLL disable(GLenum capability);
+
+/**
+ * Returns whether a capability is enabled, from the cache when it is cached, so without the pipeline
+ * stall of glIsEnabled().
+ * @since v3.10
+ */
+bool CC_DLL isEnabled(GLenum capability);
+
+/**
+ * Sets the depth write mask in case it is different from the current one.
+ *
+ * If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDepthMask() directly.
+ * @since v3.10
+ */
+void CC_DLL depthMask(GLboolean flag);
+
+/**
+ * Returns the depth write mask, from the cache when it is known.
+ * @since v3.10
+ */
+GLboolean CC_DLL getDepthMask(void);
+
+/**
+ * Sets the depth function in case it is different from the current one.
+ *
+ * If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glDepthFunc() directly.
+ * @since v3.10
+ */
+void CC_DLL depthFunc(GLenum func);
+
+/**
+ * Returns the depth function, from the cache when it is known.
+ * @since v3.10
+ */
+GLenum CC_DLL getDepthFunc(void);
+
+/**
+ * Sets the culled faces in case they are different from the current ones.
+ *
+ * If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glCullFace() directly.
+ * @since v3.10
+ */
+void CC_DLL cullFace(GLenum mode);
+
+/**
+ * Sets the front face winding in case it is different from the current one.
+ *
+ * If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glFrontFace() directly.
+ * @since v3.10
+ */
+void CC_DLL frontFace(GLenum mode);
+
+/** Counts of the state changes asked to the cache: passed to GL, or dropped as redundant. */
+struct StateStats
+{
+    unsigned int issued;
+    unsigned int skipped;
+};
+
+/**
+ * Returns the state changes since the last resetStateStats(). The Director resets them every frame.
+ * @since v3.10
+ */
+StateStats CC_DLL getStateStats(void);
+
+/**
+ * Resets the state change counts.
+ * @since v3.10
+ */
+void CC_DLL resetStateStats(void);
+
 // end of support group
 /// @}
 
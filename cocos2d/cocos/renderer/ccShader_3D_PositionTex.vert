@@ -85,4 +85,20 @@ void main()
     TextureCoordOut.y = 1.0 - TextureCoordOut.y;
 }
 
-);
\ No newline at end of file
+);
+
+const char* cc3D_InstancedPositionTex_vert = STRINGIFY(
+
+attribute vec4 a_position;
+attribute vec2 a_texCoord;
+attribute mat4 a_instanceTransform;
+
+varying vec2 TextureCoordOut;
+
+void main(void)
+{
+    gl_Position = CC_MVPMatrix * (a_instanceTransform * a_position);
+    TextureCoordOut = a_texCoord;
+    TextureCoordOut.y = 1.0 - TextureCoordOut.y;
+}
+);
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2016 Chukong Technologies Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Planar YUV 4:2:0 (I420): luma in CC_Texture0, chroma planes in u_textureU and u_textureV,
+// all three are single channel (I8) textures. Full range BT.601 as written by JPEG/JFIF.
+const char* ccPositionTextureYUV_frag = STRINGIFY(
+\n#ifdef GL_ES\n
+precision mediump float;
+\n#endif\n
+
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+
+uniform sampler2D u_textureU;
+uniform sampler2D u_textureV;
+
+void main()
+{
+    float y = texture2D(CC_Texture0, v_texCoord).r;
+    float u = texture2D(u_textureU, v_texCoord).r - 0.5;
+    float v = texture2D(u_textureV, v_texCoord).r - 0.5;
+    vec3 rgb = vec3(y + 1.402 * v,
+                    y - 0.344136 * u - 0.714136 * v,
+                    y + 1.772 * u);
+    gl_FragColor = v_fragmentColor * vec4(rgb, 1.0);
+}
+);
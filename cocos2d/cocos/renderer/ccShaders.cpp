@@ -58,9 +58,15 @@ NS_CC_BEGIN
 #include "ccShader_PositionTextureColor_noMVP.frag"
 #include "ccShader_PositionTextureColor_noMVP.vert"
 
+//
+#include "ccShader_PositionTextureColor_instanced.vert"
+
 //
 #include "ccShader_PositionTextureColorAlphaTest.frag"
 
+//
+#include "ccShader_PositionTextureYUV.frag"
+
 //
 #include "ccShader_PositionTexture_uColor.frag"
 #include "ccShader_PositionTexture_uColor.vert"
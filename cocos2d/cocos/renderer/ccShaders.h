@@ -58,8 +58,12 @@ extern CC_DLL const GLchar * ccPositionTextureColor_vert;
 extern CC_DLL const GLchar * ccPositionTextureColor_noMVP_frag;
 extern CC_DLL const GLchar * ccPositionTextureColor_noMVP_vert;
 
+extern CC_DLL const GLchar * ccPositionTextureColor_instanced_vert;
+
 extern CC_DLL const GLchar * ccPositionTextureColorAlphaTest_frag;
 
+extern CC_DLL const GLchar * ccPositionTextureYUV_frag;
+
 extern CC_DLL const GLchar * ccPositionTexture_uColor_frag;
 extern CC_DLL const GLchar * ccPositionTexture_uColor_vert;
 
@@ -77,6 +81,7 @@ extern CC_DLL const GLchar * ccLabel_vert;
 
 extern CC_DLL const GLchar * cc3D_PositionTex_vert;
 extern CC_DLL const GLchar * cc3D_SkinPositionTex_vert;
+extern CC_DLL const GLchar * cc3D_InstancedPositionTex_vert;
 extern CC_DLL const GLchar * cc3D_ColorTex_frag;
 extern CC_DLL const GLchar * cc3D_Color_frag;
 extern CC_DLL const GLchar * cc3D_PositionNormalTex_vert;
@@ -842,6 +842,7 @@ namespace ui {
 
         //we must invalide the transform when toggling scale9enabled
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        invalidateSubtreeBounds();
 
         if (_scale9Enabled)
         {
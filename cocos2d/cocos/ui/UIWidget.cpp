@@ -145,6 +145,7 @@ _unifySize(false),
 _enabled(true),
 _bright(true),
 _touchEnabled(false),
+_touchBoundsCulling(false),
 _highlight(false),
 _affectByClipping(false),
 _ignoreSize(false),
@@ -584,6 +585,7 @@ void Widget::setTouchEnabled(bool enable)
         _touchListener = EventListenerTouchOneByOne::create();
         CC_SAFE_RETAIN(_touchListener);
         _touchListener->setSwallowTouches(true);
+        _touchListener->setTouchBoundsCulling(_touchBoundsCulling);
         _touchListener->onTouchBegan = CC_CALLBACK_2(Widget::onTouchBegan, this);
         _touchListener->onTouchMoved = CC_CALLBACK_2(Widget::onTouchMoved, this);
         _touchListener->onTouchEnded = CC_CALLBACK_2(Widget::onTouchEnded, this);
@@ -602,6 +604,20 @@ bool Widget::isTouchEnabled() const
     return _touchEnabled;
 }
 
+void Widget::setTouchBoundsCulling(bool enabled)
+{
+    _touchBoundsCulling = enabled;
+    if (_touchListener)
+    {
+        _touchListener->setTouchBoundsCulling(enabled);
+    }
+}
+
+bool Widget::isTouchBoundsCulling() const
+{
+    return _touchBoundsCulling;
+}
+
 bool Widget::isHighlighted() const
 {
     return _highlight;
@@ -1220,6 +1236,7 @@ void Widget::copyProperties(Widget *widget)
     setVisible(widget->isVisible());
     setBright(widget->isBright());
     setTouchEnabled(widget->isTouchEnabled());
+    setTouchBoundsCulling(widget->isTouchBoundsCulling());
     setLocalZOrder(widget->getLocalZOrder());
     setTag(widget->getTag());
     setName(widget->getName());
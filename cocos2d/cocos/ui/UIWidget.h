@@ -231,6 +231,28 @@ public:
      */
     bool isTouchEnabled() const;
 
+    /**
+     * Sets whether touches that begin outside the content box of the widget are skipped.
+     *
+     * When enabled, the EventDispatcher doesn't call onTouchBegan for them, which keeps touch dispatch cheap
+     * on scenes with many widgets. Don't enable it on widgets whose hitTest accepts touches outside of the
+     * content size, like a Slider with a large ball or a TextField with a touch area.
+     * The default value is false.
+     *
+     * @see EventListenerTouchOneByOne::setTouchBoundsCulling
+     * @param enabled   True to skip the touches outside of the widget.
+     * @since v3.10
+     */
+    void setTouchBoundsCulling(bool enabled);
+
+    /**
+     * Determines if touches that begin outside the content box of the widget are skipped.
+     *
+     * @return true if touches outside of the widget are skipped.
+     * @since v3.10
+     */
+    bool isTouchBoundsCulling() const;
+
     /**
      * Determines if the widget is highlighted
      *
@@ -940,6 +962,7 @@ protected:
     bool _enabled;
     bool _bright;
     bool _touchEnabled;
+    bool _touchBoundsCulling;
     bool _highlight;
     bool _affectByClipping;
     bool _ignoreSize;
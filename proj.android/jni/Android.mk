@@ -12,9 +12,18 @@ LOCAL_MODULE_FILENAME := libcocos2dcpp
 
 LOCAL_SRC_FILES := hellocpp/main.cpp \
                    ../../Classes/AppDelegate.cpp \
-                   ../../Classes/HelloWorldScene.cpp
-
-LOCAL_C_INCLUDES := $(LOCAL_PATH)/../../Classes
+                   ../../Classes/HelloWorldScene.cpp \
+                   ../../Classes/CCMediaPlayer.cpp \
+                   ../../Classes/CCVideoClock.cpp \
+                   ../../Classes/CCVideoDecodePool.cpp \
+                   ../../Classes/CCVideoDecoder.cpp \
+                   ../../Classes/CCVideoManager.cpp \
+                   ../../Classes/CCVideoPlayer.cpp \
+                   ../../Classes/CCVideoSprite.cpp \
+                   ../../Classes/CCVideoStream.cpp
+
+LOCAL_C_INCLUDES := $(LOCAL_PATH)/../../Classes \
+                    $(LOCAL_PATH)/../../cocos2d/external/jpeg/include/android
 
 # _COCOS_HEADER_ANDROID_BEGIN
 # _COCOS_HEADER_ANDROID_END
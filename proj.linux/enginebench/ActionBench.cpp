@@ -0,0 +1,97 @@
+#include "EngineBench.h"
+#include "cocos2d.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+USING_NS_CC;
+
+namespace
+{
+	const int NODE_COUNT = 10000;
+	const float FRAME_DT = 1.0f / 60.0f;
+	const int FRAMES = 60;
+
+	// Subclasses aren't batched by the ActionManager, they are stepped through Action::step() as before.
+	class SteppedMoveTo : public MoveTo
+	{
+	public:
+		static SteppedMoveTo * create(float duration, const Vec2& position)
+		{
+			SteppedMoveTo * action = new SteppedMoveTo();
+			action->initWithDuration(duration, position);
+			action->autorelease();
+			return action;
+		}
+	};
+
+	class SteppedScaleTo : public ScaleTo
+	{
+	public:
+		static SteppedScaleTo * create(float duration, float scale)
+		{
+			SteppedScaleTo * action = new SteppedScaleTo();
+			action->initWithDuration(duration, scale);
+			action->autorelease();
+			return action;
+		}
+	};
+
+	class SteppedFadeTo : public FadeTo
+	{
+	public:
+		static SteppedFadeTo * create(float duration, GLubyte opacity)
+		{
+			SteppedFadeTo * action = new SteppedFadeTo();
+			action->initWithDuration(duration, opacity);
+			action->autorelease();
+			return action;
+		}
+	};
+
+	// A MoveTo, a ScaleTo and a FadeTo on every node, long enough to run through all the measured frames.
+	double measureTweens(const Vector<Node*>& nodes, bool stepped)
+	{
+		ActionManager * manager = new ActionManager();
+		for (Node * node : nodes)
+		{
+			Vec2 position((float)(rand() % 1024), (float)(rand() % 768));
+			float duration = 1000.0f;
+			if (stepped)
+			{
+				manager->addAction(SteppedMoveTo::create(duration, position), node, false);
+				manager->addAction(SteppedScaleTo::create(duration, 2.0f), node, false);
+				manager->addAction(SteppedFadeTo::create(duration, 0), node, false);
+			}
+			else
+			{
+				manager->addAction(MoveTo::create(duration, position), node, false);
+				manager->addAction(ScaleTo::create(duration, 2.0f), node, false);
+				manager->addAction(FadeTo::create(duration, 0), node, false);
+			}
+		}
+
+		double ms = EngineBench::measure([&]() {
+			for (int i = 0; i < FRAMES; ++i) manager->update(FRAME_DT);
+		});
+		manager->release();
+		return ms;
+	}
+}
+
+void EngineBench::runActions()
+{
+	Vector<Node*> nodes;
+	for (int i = 0; i < NODE_COUNT; ++i)
+	{
+		nodes.pushBack(Node::create());
+	}
+
+#if !CC_ENABLE_ACTION_BATCHING
+	// batching is off by default, both runs step every action the same way.
+	printf("enginebench: actions aren't batched, build with -DCC_ENABLE_ACTION_BATCHING=1 to measure them\n");
+#endif
+	double beforeMs = measureTweens(nodes, true);
+	double afterMs = measureTweens(nodes, false);
+	report("ActionManager update, 30k tweens", (double)NODE_COUNT * 3 * FRAMES, "actions", beforeMs, afterMs);
+}
@@ -0,0 +1,31 @@
+#include "EngineBench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+
+namespace EngineBench
+{
+	double measure(const std::function<void()>& fn, double minMs)
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		fn(); // warms the caches up
+		double best = 1e30;
+		double total = 0.0;
+		while (total < minMs)
+		{
+			Clock::time_point start = Clock::now();
+			fn();
+			double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			best = std::min(best, ms);
+			total += ms;
+		}
+		return best;
+	}
+
+	void report(const char * name, double count, const char * unit, double beforeMs, double afterMs)
+	{
+		printf("%-36s %14.1f %14.1f  %s/ms  x%.2f\n", name, count / beforeMs, count / afterMs, unit, beforeMs / afterMs);
+	}
+}
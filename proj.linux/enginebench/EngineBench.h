@@ -0,0 +1,27 @@
+#ifndef _ENGINE_BENCH_
+#define _ENGINE_BENCH_
+
+#include <functional>
+
+// Micro benchmarks of engine hot paths.
+// They run without a window or GL context on the same data the engine works on, and time the
+// current code path against the one it replaced, so a change can be judged on this machine.
+namespace EngineBench
+{
+	// Calls fn repeatedly for at least minMs and returns the best time of one call in milliseconds.
+	double measure(const std::function<void()>& fn, double minMs = 200.0);
+
+	// Prints one row: the throughput (count / ms) before and after, and the speedup.
+	void report(const char * name, double count, const char * unit, double beforeMs, double afterMs);
+
+	// Renderer::fillQuads / fillVerticesAndIndices: per vertex transformPoint against Mat4::transformPoints.
+	void runVertexTransform();
+
+	// Scheduler::update and schedule / unschedule on 10k nodes: linked lists and uthash against arrays and a timer wheel.
+	void runScheduler();
+
+	// ActionManager::update with a MoveTo, ScaleTo and FadeTo on 10k nodes: Action::step() per action against the batches.
+	void runActions();
+}
+
+#endif /*_ENGINE_BENCH_*/
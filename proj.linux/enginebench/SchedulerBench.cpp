@@ -0,0 +1,82 @@
+#include "EngineBench.h"
+#include "BaselineScheduler.h"
+#include "cocos2d.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+USING_NS_CC;
+
+namespace
+{
+	const int NODE_COUNT = 10000;
+	const float FRAME_DT = 1.0f / 60.0f;
+
+	struct Target : public Ref
+	{
+		Target() : calls(0) {}
+		void update(float dt) { ++calls; }
+		int calls;
+	};
+
+	// frames per measured call, enough for the per frame cost to dominate.
+	const int FRAMES = 60;
+}
+
+void EngineBench::runScheduler()
+{
+	std::vector<Target> targets(NODE_COUNT);
+
+	// scheduleUpdate on every node, called each frame.
+	{
+		EngineBenchBaseline::Scheduler before;
+		Scheduler after;
+		for (Target& target : targets)
+		{
+			before.scheduleUpdate(&target, 0, false);
+			after.scheduleUpdate(&target, 0, false);
+		}
+		double beforeMs = measure([&]() {
+			for (int i = 0; i < FRAMES; ++i) before.update(FRAME_DT);
+		});
+		double afterMs = measure([&]() {
+			for (int i = 0; i < FRAMES; ++i) after.update(FRAME_DT);
+		});
+		report("Scheduler update, 10k updates", (double)NODE_COUNT * FRAMES, "calls", beforeMs, afterMs);
+	}
+
+	// a custom selector per node with intervals of 0.1 to 2 seconds, most frames only a few are due.
+	{
+		EngineBenchBaseline::Scheduler before;
+		Scheduler after;
+		for (Target& target : targets)
+		{
+			float interval = 0.1f + (float)(rand() % 20) * 0.1f;
+			before.schedule([&target](float dt) { target.update(dt); }, &target, interval, false, "timer");
+			after.schedule([&target](float dt) { target.update(dt); }, &target, interval, false, "timer");
+		}
+		double beforeMs = measure([&]() {
+			for (int i = 0; i < FRAMES; ++i) before.update(FRAME_DT);
+		});
+		double afterMs = measure([&]() {
+			for (int i = 0; i < FRAMES; ++i) after.update(FRAME_DT);
+		});
+		report("Scheduler update, 10k timers", (double)NODE_COUNT * FRAMES, "timers", beforeMs, afterMs);
+	}
+
+	// nodes entering and leaving the scene: scheduleUpdate, then unscheduleAllForTarget.
+	{
+		double beforeMs = measure([&]() {
+			EngineBenchBaseline::Scheduler before;
+			for (Target& target : targets) before.scheduleUpdate(&target, 0, false);
+			for (Target& target : targets) before.unscheduleAllForTarget(&target);
+		});
+		double afterMs = measure([&]() {
+			Scheduler after;
+			for (Target& target : targets) after.scheduleUpdate(&target, 0, false);
+			for (Target& target : targets) after.unscheduleAllForTarget(&target);
+		});
+		report("Scheduler schedule + unschedule, 10k", (double)NODE_COUNT, "nodes", beforeMs, afterMs);
+	}
+}
@@ -0,0 +1,100 @@
+#include "EngineBench.h"
+#include "cocos2d.h"
+
+#include <stdio.h>
+#include <thread>
+#include <stdlib.h>
+#include <vector>
+
+USING_NS_CC;
+
+namespace
+{
+	// Fills the quads of one batch the way Renderer::fillQuads did before the batch transform.
+	void fillPerVertex(const Mat4& modelView, const V3F_C4B_T2F * quads, ssize_t quadCount, V3F_C4B_T2F * out)
+	{
+		for (ssize_t i = 0; i < quadCount * 4; ++i)
+		{
+			out[i] = quads[i];
+			modelView.transformPoint(quads[i].vertices, &(out[i].vertices));
+		}
+	}
+
+	// Renderer::fillQuads now.
+	void fillBatched(const Mat4& modelView, const V3F_C4B_T2F * quads, ssize_t quadCount, V3F_C4B_T2F * out)
+	{
+		memcpy(out, quads, sizeof(V3F_C4B_T2F) * 4 * quadCount);
+		modelView.transformPoints(&out->vertices, &out->vertices, quadCount * 4, sizeof(V3F_C4B_T2F));
+	}
+}
+
+void EngineBench::runVertexTransform()
+{
+	Mat4 modelView;
+	Mat4::createTranslation(Vec3(480.0f, 320.0f, 0.0f), &modelView);
+	modelView.rotateZ(0.3f);
+	modelView.scale(1.5f);
+
+	// from a few sprites up to a full VBO (Renderer::VBO_SIZE / 4 quads).
+	static const ssize_t BATCH_SIZES[] = { 16, 256, 16384 };
+	for (ssize_t quadCount : BATCH_SIZES)
+	{
+		std::vector<V3F_C4B_T2F> quads(quadCount * 4);
+		std::vector<V3F_C4B_T2F> out(quadCount * 4);
+		for (V3F_C4B_T2F& vertex : quads)
+		{
+			vertex.vertices.set((float)(rand() % 1024), (float)(rand() % 768), 0.0f);
+			vertex.colors = Color4B::WHITE;
+			vertex.texCoords = Tex2F((float)(rand() % 2), (float)(rand() % 2));
+		}
+
+		// enough batches per call for the small sizes to be measurable.
+		int repeats = (int)(65536 / quadCount);
+		double before = measure([&]() {
+			for (int i = 0; i < repeats; ++i)
+			{
+				fillPerVertex(modelView, quads.data(), quadCount, out.data());
+			}
+		});
+		double after = measure([&]() {
+			for (int i = 0; i < repeats; ++i)
+			{
+				fillBatched(modelView, quads.data(), quadCount, out.data());
+			}
+		});
+
+		char name[64];
+		snprintf(name, sizeof(name), "fillQuads, %d quads per batch", (int)quadCount);
+		report(name, (double)quadCount * repeats, "quads", before, after);
+	}
+
+	// a full batch of 4 quads commands (e.g. sprites) filled on the render workers, Renderer::setWorkerThreadCount.
+	unsigned int threads = std::max(1u, std::thread::hardware_concurrency()) - 1;
+	if (threads > 0)
+	{
+		const ssize_t quadCount = 16384;
+		const ssize_t commandQuads = 4;
+		std::vector<V3F_C4B_T2F> quads(quadCount * 4);
+		std::vector<V3F_C4B_T2F> out(quadCount * 4);
+		RenderWorkers workers(threads);
+
+		double before = measure([&]() {
+			for (ssize_t i = 0; i < quadCount; i += commandQuads)
+			{
+				fillBatched(modelView, &quads[i * 4], commandQuads, &out[i * 4]);
+			}
+		});
+		double after = measure([&]() {
+			workers.parallelFor(quadCount / commandQuads, 32, [&](size_t begin, size_t end) {
+				for (size_t i = begin * commandQuads; i < end * commandQuads; i += commandQuads)
+				{
+					fillBatched(modelView, &quads[i * 4], commandQuads, &out[i * 4]);
+				}
+			});
+		});
+
+		char name[64];
+		snprintf(name, sizeof(name), "fillQuads, 1 against %u threads", threads + 1);
+		report(name, (double)quadCount, "quads", before, after);
+	}
+}
@@ -0,0 +1,59 @@
+#include "EngineBench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+struct Bench
+{
+	const char * name;
+	void (*run)();
+};
+
+static const Bench BENCHES[] =
+{
+	{ "vertex", EngineBench::runVertexTransform },
+	{ "scheduler", EngineBench::runScheduler },
+	{ "actions", EngineBench::runActions },
+};
+
+static void usage()
+{
+	printf("usage: enginebench [name...]\n  runs every benchmark when no name is given:");
+	for (const Bench& bench : BENCHES)
+	{
+		printf(" %s", bench.name);
+	}
+	printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		bool known = false;
+		for (const Bench& bench : BENCHES)
+		{
+			known = known || strcmp(argv[i], bench.name) == 0;
+		}
+		if (!known)
+		{
+			usage();
+			return strcmp(argv[i], "--help") == 0 ? 0 : 2;
+		}
+	}
+
+	printf("%-36s %14s %14s\n", "", "before", "after");
+	for (const Bench& bench : BENCHES)
+	{
+		bool selected = argc == 1;
+		for (int i = 1; i < argc; ++i)
+		{
+			selected = selected || strcmp(argv[i], bench.name) == 0;
+		}
+		if (selected)
+		{
+			bench.run();
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,26 @@
+#ifndef _ENGINE_TESTS_
+#define _ENGINE_TESTS_
+
+#include <stdio.h>
+
+// Tests of the engine code which runs across threads, where a bug rarely shows in the demo.
+// They run without a window or GL context; each returns false after printing the failed checks.
+// Build them under -fsanitize=thread to also catch the races that don't fail a check.
+namespace EngineTests
+{
+	// JobSystem: dependency ordering, wait() from a job, destroyInstance() with queued jobs, and the AsyncTaskPool
+	// network tasks keeping off the workers.
+	bool runJobSystem();
+
+	// Scheduler::performFunctionInCocosThread: many producers against a time budget, a function destroying the scheduler.
+	bool runScheduler();
+
+	// Scheduler custom timers: delays, repeats, interval changes, pause, unscheduling and wheel cascades, run through
+	// the baseline Scheduler vendored in proj.linux/enginebench too, the triggers and their dt must match.
+	bool runSchedulerTimers();
+}
+
+#define ENGINE_CHECK(condition) \
+	do { if (!(condition)) { printf("  %s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); ok = false; } } while (0)
+
+#endif /*_ENGINE_TESTS_*/
@@ -0,0 +1,230 @@
+#include "EngineTests.h"
+#include "base/CCJobSystem.h"
+#include "base/CCAsyncTaskPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+USING_NS_CC;
+
+namespace
+{
+	// Every job appends its name once it ran, a job must come after the ones it depends on.
+	bool testDependencies()
+	{
+		bool ok = true;
+		JobSystem * jobs = JobSystem::getInstance();
+		std::mutex mutex;
+		std::string order;
+		auto append = [&](char name, int sleepMs) {
+			return [&, name, sleepMs]() {
+				// a slow dependency gives the dependent jobs every chance to start too early
+				std::this_thread::sleep_for(std::chrono::milliseconds(sleepMs));
+				std::lock_guard<std::mutex> lock(mutex);
+				order += name;
+			};
+		};
+
+		auto a = jobs->schedule(append('a', 30));
+		auto b = jobs->schedule(append('b', 10), nullptr, JobSystem::Priority::NORMAL, { a });
+		auto c = jobs->schedule(append('c', 0), nullptr, JobSystem::Priority::HIGH, { a, b });
+		auto d = jobs->then(c, append('d', 0));
+		jobs->wait(d);
+		ENGINE_CHECK(order == "abcd");
+		ENGINE_CHECK(JobSystem::isDone(a) && JobSystem::isDone(b) && JobSystem::isDone(c));
+
+		// a fan out and in: every leaf after the root, the join after every leaf.
+		const int LEAVES = 64;
+		std::atomic<int> rootRan(0);
+		std::atomic<int> leavesRan(0);
+		std::atomic<int> leavesBeforeRoot(0);
+		int leavesSeenByJoin = -1;
+		auto root = jobs->schedule([&]() {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			rootRan = 1;
+		});
+		std::vector<JobSystem::JobHandle> leaves;
+		for (int i = 0; i < LEAVES; ++i)
+		{
+			leaves.push_back(jobs->then(root, [&]() {
+				leavesBeforeRoot += rootRan ? 0 : 1;
+				++leavesRan;
+			}));
+		}
+		auto join = jobs->schedule([&]() { leavesSeenByJoin = leavesRan; }, nullptr, JobSystem::Priority::NORMAL, leaves);
+		jobs->wait(join);
+		ENGINE_CHECK(leavesBeforeRoot == 0);
+		ENGINE_CHECK(leavesSeenByJoin == LEAVES);
+
+		// a dependency which already ran doesn't hold the job back.
+		auto late = jobs->schedule(nullptr, nullptr, JobSystem::Priority::LOW, { a });
+		jobs->wait(late);
+		ENGINE_CHECK(JobSystem::isDone(late));
+		return ok;
+	}
+
+	// More jobs than workers each wait for jobs they spawn: with every worker blocked in wait(),
+	// only the waiting threads running queued jobs themselves keep it from dead locking.
+	bool testWaitFromWorker()
+	{
+		bool ok = true;
+		JobSystem * jobs = JobSystem::getInstance();
+		const int OUTER = (int)jobs->getWorkerCount() * 2 + 1;
+		const int INNER = 16;
+		std::atomic<int> innerRan(0);
+		std::atomic<int> innerMissing(0);
+
+		std::vector<JobSystem::JobHandle> outer;
+		for (int i = 0; i < OUTER; ++i)
+		{
+			outer.push_back(jobs->schedule([&]() {
+				std::vector<JobSystem::JobHandle> inner;
+				for (int j = 0; j < INNER; ++j)
+				{
+					inner.push_back(jobs->schedule([&]() { ++innerRan; }));
+				}
+				for (const auto& job : inner)
+				{
+					jobs->wait(job);
+					innerMissing += JobSystem::isDone(job) ? 0 : 1;
+				}
+			}));
+		}
+		for (const auto& job : outer)
+		{
+			jobs->wait(job);
+		}
+		ENGINE_CHECK(innerRan == OUTER * INNER);
+		ENGINE_CHECK(innerMissing == 0);
+		return ok;
+	}
+
+	// destroyInstance() waits for the running jobs and drops the queued ones.
+	bool testShutdownWithQueuedJobs()
+	{
+		bool ok = true;
+		JobSystem * jobs = JobSystem::getInstance();
+		const int WORKERS = (int)jobs->getWorkerCount();
+		std::atomic<bool> gate(false);
+		std::atomic<int> blockersStarted(0);
+		std::atomic<int> blockersDone(0);
+		std::atomic<int> queuedRan(0);
+
+		// one job holding every worker, so the ones queued after them stay queued
+		for (int i = 0; i < WORKERS; ++i)
+		{
+			jobs->schedule([&]() {
+				++blockersStarted;
+				while (!gate)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				}
+				++blockersDone;
+			});
+		}
+		while (blockersStarted < WORKERS)
+		{
+			std::this_thread::yield();
+		}
+
+		const int QUEUED = 100;
+		std::vector<JobSystem::JobHandle> queued;
+		for (int i = 0; i < QUEUED; ++i)
+		{
+			queued.push_back(jobs->schedule([&]() { ++queuedRan; }));
+		}
+
+		std::thread destroyer(&JobSystem::destroyInstance);
+		// let the destructor flag the workers before they are released
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		gate = true;
+		destroyer.join();
+
+		ENGINE_CHECK(blockersDone == WORKERS);
+		ENGINE_CHECK(queuedRan == 0);
+		ENGINE_CHECK(JobSystem::getInstanceIfStarted() == nullptr);
+		int dropped = 0;
+		for (const auto& job : queued)
+		{
+			dropped += JobSystem::isDone(job) ? 0 : 1;
+		}
+		ENGINE_CHECK(dropped == QUEUED);
+
+		// the handles keep the dropped jobs alive until here, a new system starts cleanly.
+		queued.clear();
+		auto after = JobSystem::getInstance()->schedule(nullptr);
+		JobSystem::getInstance()->wait(after);
+		ENGINE_CHECK(JobSystem::isDone(after));
+		JobSystem::destroyInstance();
+		return ok;
+	}
+
+	// AsyncTaskPool network tasks block on I/O: they run one by one, in order, on a thread of their own, not on the workers.
+	bool testNetworkTasks()
+	{
+		bool ok = true;
+		JobSystem * jobs = JobSystem::getInstance();
+		AsyncTaskPool * pool = AsyncTaskPool::getInstance();
+		const int BLOCKED = (int)jobs->getWorkerCount() + 2;
+		std::atomic<bool> gate(false);
+		std::mutex mutex;
+		std::vector<int> order;
+
+		for (int i = 0; i < BLOCKED; ++i)
+		{
+			pool->enqueue(AsyncTaskPool::TaskType::TASK_NETWORK, nullptr, nullptr, [&, i]() {
+				while (!gate)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				}
+				std::lock_guard<std::mutex> lock(mutex);
+				order.push_back(i);
+			});
+		}
+
+		// a job per worker still runs while the network tasks wait
+		std::atomic<int> jobsRan(0);
+		std::vector<JobSystem::JobHandle> handles;
+		for (unsigned int i = 0; i < jobs->getWorkerCount(); ++i)
+		{
+			handles.push_back(jobs->schedule([&]() { ++jobsRan; }));
+		}
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (jobsRan < (int)handles.size() && std::chrono::steady_clock::now() < deadline)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		ENGINE_CHECK(jobsRan == (int)handles.size());
+
+		gate = true;
+		std::atomic<bool> lastRan(false);
+		pool->enqueue(AsyncTaskPool::TaskType::TASK_NETWORK, nullptr, nullptr, [&]() { lastRan = true; });
+		while (!lastRan)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		bool inOrder = (int)order.size() == BLOCKED;
+		for (int i = 0; inOrder && i < BLOCKED; ++i)
+		{
+			inOrder = order[i] == i;
+		}
+		ENGINE_CHECK(inOrder);
+
+		AsyncTaskPool::destoryInstance();
+		JobSystem::destroyInstance();
+		return ok;
+	}
+}
+
+bool EngineTests::runJobSystem()
+{
+	bool ok = testDependencies();
+	ok = testWaitFromWorker() && ok;
+	ok = testShutdownWithQueuedJobs() && ok;
+	ok = testNetworkTasks() && ok;
+	return ok;
+}
@@ -0,0 +1,94 @@
+#include "EngineTests.h"
+#include "base/CCScheduler.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+USING_NS_CC;
+
+namespace
+{
+	const float FRAME_DT = 1.0f / 60.0f;
+
+	// Producers queue functions while the cocos thread drains them under a time budget:
+	// every function runs once, and the functions of one producer run in the order it queued them.
+	bool testPerformFromThreads()
+	{
+		bool ok = true;
+		const int PRODUCERS = 8;
+		const int FUNCTIONS = 20000;
+		Scheduler scheduler;
+		scheduler.setPerformFunctionsTimeBudget(0.0005f);
+
+		// only touched by the functions, on this thread
+		std::vector<int> last(PRODUCERS, -1);
+		long ran = 0;
+		int outOfOrder = 0;
+		std::atomic<int> producersDone(0);
+
+		std::vector<std::thread> producers;
+		for (int p = 0; p < PRODUCERS; ++p)
+		{
+			producers.emplace_back([&, p]() {
+				for (int i = 0; i < FUNCTIONS; ++i)
+				{
+					scheduler.performFunctionInCocosThread([&, p, i]() {
+						outOfOrder += last[p] == i - 1 ? 0 : 1;
+						last[p] = i;
+						++ran;
+						// queued while the queue drains, it runs on a later frame
+						if (i % 1000 == 0)
+						{
+							scheduler.performFunctionInCocosThread([]() {});
+						}
+					});
+				}
+				++producersDone;
+			});
+		}
+
+		while (producersDone < PRODUCERS || ran < (long)PRODUCERS * FUNCTIONS)
+		{
+			scheduler.update(FRAME_DT);
+		}
+		for (auto& producer : producers)
+		{
+			producer.join();
+		}
+		ENGINE_CHECK(ran == (long)PRODUCERS * FUNCTIONS);
+		ENGINE_CHECK(outOfOrder == 0);
+
+		// functions still queued are released with the scheduler
+		scheduler.performFunctionInCocosThread([]() {});
+		return ok;
+	}
+
+	// A function may tear the scheduler down, e.g. by purging the Director. The functions after it are
+	// dropped and the scheduler isn't touched again, run under -fsanitize=address to see it.
+	bool testPerformDestroysScheduler()
+	{
+		bool ok = true;
+		for (float budget : { 0.0f, 1.0f })
+		{
+			Scheduler * scheduler = new Scheduler();
+			scheduler->setPerformFunctionsTimeBudget(budget);
+			int ranBefore = 0;
+			int ranAfter = 0;
+			scheduler->performFunctionInCocosThread([&]() { ++ranBefore; });
+			scheduler->performFunctionInCocosThread([&]() { delete scheduler; });
+			scheduler->performFunctionInCocosThread([&]() { ++ranAfter; });
+			scheduler->update(FRAME_DT);
+			ENGINE_CHECK(ranBefore == 1);
+			ENGINE_CHECK(ranAfter == 0);
+		}
+		return ok;
+	}
+}
+
+bool EngineTests::runScheduler()
+{
+	bool ok = testPerformFromThreads();
+	ok = testPerformDestroysScheduler() && ok;
+	return ok;
+}
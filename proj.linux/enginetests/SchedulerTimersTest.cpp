@@ -0,0 +1,302 @@
+#include "EngineTests.h"
+#include "../enginebench/BaselineScheduler.h"
+#include "base/CCScheduler.h"
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+USING_NS_CC;
+
+namespace
+{
+	// Frame times and intervals are binary fractions: the baseline sums float deltas where the timer wheel keeps
+	// a double clock, both are exact on them, so the two must agree to the frame instead of within a rounding.
+	const float FRAME_DT = 1.0f / 64.0f;
+
+	struct Event
+	{
+		int frame;
+		int timer;
+		float dt;
+	};
+
+	// The triggers of one run, the frame is set by the scenario before each update.
+	struct Recorder
+	{
+		Recorder() : frame(0) {}
+
+		ccSchedulerFunc record(int timer)
+		{
+			return [this, timer](float dt) { add(timer, dt); };
+		}
+
+		void add(int timer, float dt)
+		{
+			Event event = { frame, timer, dt };
+			events.push_back(event);
+		}
+
+		// the wheel and the baseline hash don't visit the timers due in a frame in the same order
+		void sort()
+		{
+			std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+				return a.frame != b.frame ? a.frame < b.frame : a.timer < b.timer;
+			});
+		}
+
+		int frame;
+		std::vector<Event> events;
+	};
+
+	// targets of the scenarios, one per timer unless a scenario shares them
+	int s_targets[8];
+
+	template <class S>
+	void runFrames(S& scheduler, Recorder& recorder, int frames, float dt = FRAME_DT)
+	{
+		for (int i = 0; i < frames; ++i)
+		{
+			scheduler.update(dt);
+			++recorder.frame;
+		}
+	}
+
+	// delays before the first trigger, with and without an interval afterwards
+	struct DelayScenario
+	{
+		template <class S>
+		void operator()(S& scheduler, Recorder& recorder) const
+		{
+			scheduler.schedule(recorder.record(0), &s_targets[0], 0.25f, 3, 0.5f, false, "delay");
+			scheduler.schedule(recorder.record(1), &s_targets[1], 0.0f, 4, 0.125f, false, "delay then every frame");
+			scheduler.schedule(recorder.record(2), &s_targets[2], 0.5f, CC_REPEAT_FOREVER, 1.0f, false, "delay forever");
+			runFrames(scheduler, recorder, 20);
+			// scheduled between two updates, the delay counts from the next one
+			scheduler.schedule(recorder.record(3), &s_targets[3], 0.125f, 2, 0.25f, false, "late delay");
+			runFrames(scheduler, recorder, 200);
+		}
+	};
+
+	// repeat counts: a repeat of n triggers n + 1 times
+	struct RepeatScenario
+	{
+		template <class S>
+		void operator()(S& scheduler, Recorder& recorder) const
+		{
+			scheduler.schedule(recorder.record(0), &s_targets[0], 0.25f, 0, 0.0f, false, "once");
+			scheduler.schedule(recorder.record(1), &s_targets[1], 0.25f, 1, 0.0f, false, "twice");
+			scheduler.schedule(recorder.record(2), &s_targets[2], 0.125f, 5, 0.0f, false, "six times");
+			scheduler.schedule(recorder.record(3), &s_targets[3], 0.5f, CC_REPEAT_FOREVER, 0.0f, false, "forever");
+			// two timers of one target
+			scheduler.schedule(recorder.record(4), &s_targets[4], 0.25f, 2, 0.0f, false, "shared a");
+			scheduler.schedule(recorder.record(5), &s_targets[4], 0.375f, 3, 0.0f, false, "shared b");
+			runFrames(scheduler, recorder, 200);
+		}
+	};
+
+	// an interval of 0 triggers every frame with the frame time, also when the frame time changes
+	struct EveryFrameScenario
+	{
+		template <class S>
+		void operator()(S& scheduler, Recorder& recorder) const
+		{
+			scheduler.schedule(recorder.record(0), &s_targets[0], 0.0f, false, "every frame");
+			scheduler.schedule(recorder.record(1), &s_targets[1], 0.0f, 9, 0.0f, false, "ten frames");
+			runFrames(scheduler, recorder, 30);
+			runFrames(scheduler, recorder, 30, FRAME_DT * 2);
+			runFrames(scheduler, recorder, 30, FRAME_DT / 2);
+		}
+	};
+
+	// scheduling a scheduled key again changes its interval, the next trigger counts from the previous one
+	struct IntervalChangeScenario
+	{
+		template <class S>
+		void operator()(S& scheduler, Recorder& recorder) const
+		{
+			scheduler.schedule(recorder.record(0), &s_targets[0], 0.5f, false, "longer");
+			scheduler.schedule(recorder.record(1), &s_targets[1], 0.5f, false, "shorter");
+			scheduler.schedule(recorder.record(2), &s_targets[2], 0.25f, false, "to every frame");
+			scheduler.schedule(recorder.record(3), &s_targets[3], 0.0f, false, "from every frame");
+			runFrames(scheduler, recorder, 40);
+			scheduler.schedule(recorder.record(0), &s_targets[0], 1.0f, false, "longer");
+			scheduler.schedule(recorder.record(1), &s_targets[1], 0.125f, false, "shorter");
+			scheduler.schedule(recorder.record(2), &s_targets[2], 0.0f, false, "to every frame");
+			scheduler.schedule(recorder.record(3), &s_targets[3], 0.25f, false, "from every frame");
+			runFrames(scheduler, recorder, 200);
+
+			// from its own callback
+			int calls = 0;
+			scheduler.schedule([&](float dt) {
+				recorder.add(4, dt);
+				if (++calls == 2)
+				{
+					scheduler.schedule(recorder.record(4), &s_targets[4], 0.375f, false, "from callback");
+				}
+			}, &s_targets[4], 0.125f, false, "from callback");
+			runFrames(scheduler, recorder, 200);
+		}
+	};
+
+	// a paused target keeps the time left until its next trigger, also when it is paused during its delay
+	struct PauseScenario
+	{
+		template <class S>
+		void operator()(S& scheduler, Recorder& recorder) const
+		{
+			scheduler.schedule(recorder.record(0), &s_targets[0], 0.25f, false, "paused");
+			scheduler.schedule(recorder.record(1), &s_targets[1], 0.0f, false, "paused every frame");
+			scheduler.schedule(recorder.record(2), &s_targets[2], 0.25f, 2, 1.0f, false, "paused in delay");
+			scheduler.schedule(recorder.record(3), &s_targets[3], 0.25f, false, "running");
+			runFrames(scheduler, recorder, 37);
+			scheduler.pauseTarget(&s_targets[0]);
+			scheduler.pauseTarget(&s_targets[1]);
+			scheduler.pauseTarget(&s_targets[2]);
+			runFrames(scheduler, recorder, 50);
+			scheduler.resumeTarget(&s_targets[0]);
+			scheduler.resumeTarget(&s_targets[1]);
+			scheduler.resumeTarget(&s_targets[2]);
+			runFrames(scheduler, recorder, 150);
+
+			// scheduled paused, then resumed
+			scheduler.schedule(recorder.record(4), &s_targets[4], 0.125f, true, "scheduled paused");
+			runFrames(scheduler, recorder, 20);
+			scheduler.resumeTarget(&s_targets[4]);
+			runFrames(scheduler, recorder, 60);
+		}
+	};
+
+	// callbacks unscheduling themselves, another timer of their target, or a timer of another target
+	struct UnscheduleScenario
+	{
+		template <class S>
+		void operator()(S& scheduler, Recorder& recorder) const
+		{
+			int selfCalls = 0;
+			scheduler.schedule([&](float dt) {
+				recorder.add(0, dt);
+				if (++selfCalls == 3)
+				{
+					scheduler.unschedule("self", &s_targets[0]);
+				}
+			}, &s_targets[0], 0.125f, false, "self");
+
+			int siblingCalls = 0;
+			scheduler.schedule([&](float dt) {
+				recorder.add(1, dt);
+				if (++siblingCalls == 2)
+				{
+					scheduler.unschedule("sibling", &s_targets[1]);
+				}
+			}, &s_targets[1], 0.25f, false, "unscheduler");
+			scheduler.schedule(recorder.record(2), &s_targets[1], 0.125f, false, "sibling");
+
+			int otherCalls = 0;
+			scheduler.schedule([&](float dt) {
+				recorder.add(3, dt);
+				if (++otherCalls == 4)
+				{
+					scheduler.unscheduleAllForTarget(&s_targets[3]);
+					scheduler.unschedule("other", &s_targets[4]);
+				}
+			}, &s_targets[3], 0.0f, false, "all of its target");
+			scheduler.schedule(recorder.record(4), &s_targets[4], 0.25f, false, "other");
+
+			// the catch up of a long frame stops once the timer is unscheduled
+			int catchUpCalls = 0;
+			scheduler.schedule([&](float dt) {
+				recorder.add(5, dt);
+				if (++catchUpCalls == 5)
+				{
+					scheduler.unschedule("catch up", &s_targets[5]);
+				}
+			}, &s_targets[5], 0.125f, false, "catch up");
+
+			// every frame timers of one target run in the order they were scheduled too
+			int everyFrameCalls = 0;
+			scheduler.schedule([&](float dt) {
+				recorder.add(6, dt);
+				if (++everyFrameCalls == 3)
+				{
+					scheduler.unschedule("every frame sibling", &s_targets[6]);
+				}
+			}, &s_targets[6], 0.0f, false, "every frame unscheduler");
+			scheduler.schedule(recorder.record(7), &s_targets[6], 0.0f, false, "every frame sibling");
+
+			runFrames(scheduler, recorder, 100);
+			runFrames(scheduler, recorder, 2, 1.0f);
+			runFrames(scheduler, recorder, 20);
+		}
+	};
+
+	// intervals from a fraction of a second to beyond the third level of the wheel (64^3 ticks of 1/240 s,
+	// about 18 minutes), so timers cascade down the levels; long frames catch up several triggers at once
+	struct CascadeScenario
+	{
+		template <class S>
+		void operator()(S& scheduler, Recorder& recorder) const
+		{
+			const float intervals[] = { 0.5f, 5.0f, 20.0f, 300.0f, 1100.0f, 1250.0f };
+			for (int i = 0; i < 6; ++i)
+			{
+				scheduler.schedule(recorder.record(i), &s_targets[i], intervals[i], false, "cascade");
+			}
+			scheduler.schedule(recorder.record(6), &s_targets[6], 60.0f, 3, 700.0f, false, "long delay");
+			runFrames(scheduler, recorder, 500);
+			runFrames(scheduler, recorder, 5000, 0.5f);
+			runFrames(scheduler, recorder, 200, 4.0f);
+		}
+	};
+
+	template <class Scenario>
+	bool compareWithBaseline(const char * name, const Scenario& scenario)
+	{
+		bool ok = true;
+		Recorder before;
+		{
+			EngineBenchBaseline::Scheduler scheduler;
+			scenario(scheduler, before);
+		}
+		Recorder after;
+		{
+			Scheduler scheduler;
+			scenario(scheduler, after);
+		}
+		before.sort();
+		after.sort();
+
+		ENGINE_CHECK(!before.events.empty());
+		ENGINE_CHECK(after.events.size() == before.events.size());
+		size_t count = std::min(before.events.size(), after.events.size());
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Event& a = before.events[i];
+			const Event& b = after.events[i];
+			if (a.frame != b.frame || a.timer != b.timer || fabsf(a.dt - b.dt) > 1e-5f)
+			{
+				printf("  %s: trigger %d differs: baseline timer %d at frame %d with dt %f, wheel timer %d at frame %d with dt %f\n",
+					name, (int)i, a.timer, a.frame, a.dt, b.timer, b.frame, b.dt);
+				ok = false;
+				break;
+			}
+		}
+		if (!ok)
+		{
+			printf("  %s: %d triggers in the baseline, %d in the wheel\n", name, (int)before.events.size(), (int)after.events.size());
+		}
+		return ok;
+	}
+}
+
+bool EngineTests::runSchedulerTimers()
+{
+	bool ok = compareWithBaseline("delay", DelayScenario());
+	ok = compareWithBaseline("repeat", RepeatScenario()) && ok;
+	ok = compareWithBaseline("every frame", EveryFrameScenario()) && ok;
+	ok = compareWithBaseline("interval change", IntervalChangeScenario()) && ok;
+	ok = compareWithBaseline("pause", PauseScenario()) && ok;
+	ok = compareWithBaseline("unschedule", UnscheduleScenario()) && ok;
+	ok = compareWithBaseline("cascade", CascadeScenario()) && ok;
+	return ok;
+}
@@ -0,0 +1,60 @@
+#include "EngineTests.h"
+
+#include <string.h>
+
+struct Test
+{
+	const char * name;
+	bool (*run)();
+};
+
+static const Test TESTS[] =
+{
+	{ "jobsystem", EngineTests::runJobSystem },
+	{ "scheduler", EngineTests::runScheduler },
+	{ "timers", EngineTests::runSchedulerTimers },
+};
+
+static void usage()
+{
+	printf("usage: enginetests [name...]\n  runs every test when no name is given:");
+	for (const Test& test : TESTS)
+	{
+		printf(" %s", test.name);
+	}
+	printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		bool known = false;
+		for (const Test& test : TESTS)
+		{
+			known = known || strcmp(argv[i], test.name) == 0;
+		}
+		if (!known)
+		{
+			usage();
+			return strcmp(argv[i], "--help") == 0 ? 0 : 2;
+		}
+	}
+
+	int failures = 0;
+	for (const Test& test : TESTS)
+	{
+		bool selected = argc == 1;
+		for (int i = 1; i < argc; ++i)
+		{
+			selected = selected || strcmp(argv[i], test.name) == 0;
+		}
+		if (selected)
+		{
+			bool passed = test.run();
+			printf("%-12s %s\n", test.name, passed ? "ok" : "FAILED");
+			failures += passed ? 0 : 1;
+		}
+	}
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,263 @@
+#include "BenchApp.h"
+#include "CCVideoDecodePool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+USING_NS_CC;
+
+static const std::string START_SCHEDULE_KEY = "BenchApp::start";
+static const std::string LIMIT_SCHEDULE_KEY = "BenchApp::limit";
+
+static double nowSeconds()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// A memory field of /proc/self/status, VmRSS for the resident set size or VmHWM for its peak.
+static size_t statusKB(const char * field)
+{
+	size_t kb = 0;
+	size_t length = strlen(field);
+	FILE * status = fopen("/proc/self/status", "r");
+	if (status)
+	{
+		char line[256];
+		while (fgets(line, sizeof(line), status))
+		{
+			if (strncmp(line, field, length) == 0 && line[length] == ':')
+			{
+				kb = strtoul(line + length + 1, nullptr, 10);
+				break;
+			}
+		}
+		fclose(status);
+	}
+	return kb;
+}
+
+static void printSeries(const char * name, std::vector<double> values)
+{
+	if (values.empty())
+	{
+		printf("  %-14s n/a\n", name);
+		return;
+	}
+	std::sort(values.begin(), values.end());
+	double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+	printf("  %-14s mean %7.3f  p50 %7.3f  p95 %7.3f  p99 %7.3f  max %7.3f ms  (%zu samples)\n", name, mean,
+		values[values.size() / 2], values[values.size() * 95 / 100], values[values.size() * 99 / 100], values.back(), values.size());
+}
+
+//-------------------------------BenchApp----------------------------------------------//
+BenchApp::BenchApp(const Options& options)
+: _options(options)
+, _clipIndex(0)
+, _player(nullptr)
+, _lastPresentTime(-1.0)
+, _startTime(0.0)
+, _csv(nullptr)
+{
+}
+
+int BenchApp::run()
+{
+	if (!_options.csvPath.empty())
+	{
+		_csv = fopen(_options.csvPath.c_str(), _options.appendCsv ? "a" : "w");
+		if (_csv == nullptr)
+		{
+			fprintf(stderr, "videobench: can't write %s\n", _options.csvPath.c_str());
+			return 1;
+		}
+		if (!_options.appendCsv)
+		{
+			writeCsvHeader(_csv);
+		}
+	}
+
+	Application::run();
+
+	if (_csv)
+	{
+		fclose(_csv);
+	}
+	report();
+	CCVideoDecodePool::destroyInstance();
+	bool ok = std::all_of(_results.begin(), _results.end(), [](const ClipResult& result) { return result.ok; });
+	return ok && _results.size() == _options.clips.size() ? 0 : 1;
+}
+
+void BenchApp::writeCsvHeader(FILE * csv)
+{
+	fprintf(csv, "clip,frame,pts,clock,decode_ms,upload_ms,present_interval_ms\n");
+}
+
+void BenchApp::initGLContextAttrs()
+{
+	GLContextAttrs glContextAttrs = { 8, 8, 8, 8, 24, 8 };
+	GLView::setGLContextAttrs(glContextAttrs);
+}
+
+bool BenchApp::applicationDidFinishLaunching()
+{
+	// the window only provides the GL context, it is never shown.
+	glfwInit();
+	glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+
+	auto director = Director::getInstance();
+	auto glview = GLViewImpl::createWithRect("videobench", Rect(0, 0, (float)_options.width, (float)_options.height));
+	director->setOpenGLView(glview);
+	director->setDisplayStats(false);
+	director->setAnimationInterval(1.0 / 60);
+	director->runWithScene(Scene::create());
+
+	// the scene only becomes the running one on the next frame.
+	director->getScheduler()->schedule([this](float) {
+		Director::getInstance()->getScheduler()->unschedule(START_SCHEDULE_KEY, this);
+		startClip();
+	}, this, 0, false, START_SCHEDULE_KEY);
+	return true;
+}
+
+void BenchApp::benchmarkDecode(ClipResult& result)
+{
+	CCVideoDecoder decoder;
+	if (!decoder.open(result.path))
+	{
+		return;
+	}
+	result.frameDuration = decoder.getFrameDuration();
+
+	CCVideoFrame frame;
+	for (int i = 0; i < decoder.getFrameCount(); ++i)
+	{
+		double start = nowSeconds();
+		if (decoder.decodeFrame(i, frame))
+		{
+			result.decodeMs.push_back((nowSeconds() - start) * 1000.0);
+		}
+	}
+	result.ok = !result.decodeMs.empty();
+}
+
+void BenchApp::startClip()
+{
+	if (_clipIndex >= _options.clips.size())
+	{
+		Director::getInstance()->end();
+		return;
+	}
+
+	_results.emplace_back();
+	ClipResult& result = _results.back();
+	result.path = _options.clips[_clipIndex];
+	result.startRssKB = statusKB("VmRSS");
+	printf("videobench: %s\n", result.path.c_str());
+
+	benchmarkDecode(result);
+	_player = result.ok ? CCVideoPlayer::create(result.path) : nullptr;
+	if (_player == nullptr)
+	{
+		result.ok = false;
+		++_clipIndex;
+		startClip();
+		return;
+	}
+
+	_player->retain();
+	_player->setFrameTimingCallback(CC_CALLBACK_1(BenchApp::onFrameTiming, this));
+	_player->setFinishedCallback([this](CCVideoPlayer *) { finishClip(); });
+
+	auto director = Director::getInstance();
+	Size visibleSize = director->getVisibleSize();
+	Sprite * sprite = _player->getSprite();
+	sprite->setPosition(Vec2(visibleSize.width / 2, visibleSize.height / 2));
+	director->getRunningScene()->addChild(sprite);
+
+	_lastPresentTime = -1.0;
+	_startTime = nowSeconds();
+	_player->play();
+
+	if (_options.maxSeconds > 0.0)
+	{
+		director->getScheduler()->schedule([this](float) {
+			if (nowSeconds() - _startTime >= _options.maxSeconds)
+			{
+				finishClip();
+			}
+		}, this, 0, false, LIMIT_SCHEDULE_KEY);
+	}
+}
+
+void BenchApp::onFrameTiming(const CCVideoFrameTiming& timing)
+{
+	ClipResult& result = _results.back();
+	double now = nowSeconds();
+	double intervalMs = _lastPresentTime < 0.0 ? 0.0 : (now - _lastPresentTime) * 1000.0;
+
+	result.playDecodeMs.push_back(timing.decodeMicros / 1000.0);
+	result.uploadMs.push_back(timing.uploadMicros / 1000.0);
+	if (_lastPresentTime >= 0.0)
+	{
+		result.jitterMs.push_back(std::abs(intervalMs - result.frameDuration * 1000.0));
+	}
+	_lastPresentTime = now;
+
+	if (_csv)
+	{
+		fprintf(_csv, "%s,%d,%.6f,%.6f,%.3f,%.3f,%.3f\n", result.path.c_str(), timing.index, timing.pts, timing.clock,
+			timing.decodeMicros / 1000.0, timing.uploadMicros / 1000.0, intervalMs);
+	}
+}
+
+void BenchApp::finishClip()
+{
+	if (_player == nullptr)
+	{
+		return;
+	}
+	Director::getInstance()->getScheduler()->unschedule(LIMIT_SCHEDULE_KEY, this);
+
+	ClipResult& result = _results.back();
+	result.stats = _player->getFrameStats();
+	result.peakRssKB = statusKB("VmHWM");
+
+	_player->setFinishedCallback(nullptr);
+	_player->setFrameTimingCallback(nullptr);
+	_player->getSprite()->removeFromParent();
+	_player->stop();
+	// called from the player's own update, it is released once the frame is over.
+	_player->autorelease();
+	_player = nullptr;
+
+	++_clipIndex;
+	startClip();
+}
+
+void BenchApp::report()
+{
+	printf("\n");
+	for (const auto& result : _results)
+	{
+		printf("%s%s\n", result.path.c_str(), result.ok ? "" : "  FAILED");
+		if (!result.ok)
+		{
+			continue;
+		}
+		printSeries("decode", result.decodeMs);
+		printSeries("decode (play)", result.playDecodeMs);
+		printSeries("upload", result.uploadMs);
+		printSeries("jitter", result.jitterMs);
+		printf("  frames         presented %u  dropped %u  late %u  early %u\n",
+			result.stats.presented, result.stats.dropped, result.stats.late, result.stats.early);
+		// the high water mark covers the whole process, it is the clip's own when the process plays one clip.
+		printf("  peak rss       %zu KB, %zu KB before the clip%s\n", result.peakRssKB, result.startRssKB,
+			_results.size() > 1 ? " (process peak, run clips separately)" : "");
+	}
+	printf("decode workers: %zu\n", CCVideoDecodePool::getInstance()->getWorkerCount());
+}
@@ -0,0 +1,74 @@
+#ifndef _VIDEO_BENCH_APP_
+#define _VIDEO_BENCH_APP_
+
+#include "cocos2d.h"
+#include "CCVideoPlayer.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Benchmark of the texture video backend.
+// Every clip is first decoded flat out on the cocos thread (pure decoder cost), then played in
+// real time through CCVideoPlayer inside a hidden window, recording for each presented frame its
+// decode time, texture upload time and present interval. Results go to stdout, per frame rows
+// optionally to a CSV file.
+// The hidden window still needs an X display for its GL context, use xvfb-run without one.
+// The peak memory is the process' own, main() starts one process per clip when given several.
+class BenchApp : private cocos2d::Application
+{
+public:
+
+	struct Options
+	{
+		std::vector<std::string> clips;
+		std::string csvPath;
+		bool appendCsv = false;  // rows are added to an existing file, written by another process
+		double maxSeconds = 0.0; // limits the real time playback of each clip, 0 plays it whole
+		int width = 1280;        // size of the hidden window
+		int height = 720;
+	};
+
+	explicit BenchApp(const Options& options);
+
+	int run(); // returns 0 if every clip could be benchmarked
+
+	static void writeCsvHeader(FILE * csv);
+
+	virtual void initGLContextAttrs() override;
+	virtual bool applicationDidFinishLaunching() override;
+	virtual void applicationDidEnterBackground() override {}
+	virtual void applicationWillEnterForeground() override {}
+
+private:
+
+	struct ClipResult
+	{
+		std::string path;
+		double frameDuration = 0.0;
+		std::vector<double> decodeMs;  // flat out decode, one entry per frame
+		std::vector<double> playDecodeMs;
+		std::vector<double> uploadMs;
+		std::vector<double> jitterMs;  // |present interval - frame duration|
+		CCVideoFrameStats stats;
+		size_t startRssKB = 0; // resident memory before the clip was opened
+		size_t peakRssKB = 0;
+		bool ok = false;
+	};
+
+	void startClip();
+	void benchmarkDecode(ClipResult& result);
+	void onFrameTiming(const CCVideoFrameTiming& timing);
+	void finishClip();
+	void report();
+
+	Options _options;
+	size_t _clipIndex;
+	std::vector<ClipResult> _results;
+	CCVideoPlayer * _player;
+	double _lastPresentTime; // wall clock of the previous present, negative before the first one
+	double _startTime;
+	FILE * _csv;
+};
+
+#endif /*_VIDEO_BENCH_APP_*/
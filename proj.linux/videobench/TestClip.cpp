@@ -0,0 +1,149 @@
+#include "TestClip.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "jpeglib.h"
+
+namespace
+{
+	const int JPEG_QUALITY = 80;
+	const int BAR_COUNT = 8;
+	const uint8_t BARS[BAR_COUNT][3] = {
+		{ 235, 235, 235 }, { 235, 235, 16 }, { 16, 235, 235 }, { 16, 235, 16 },
+		{ 235, 16, 235 }, { 235, 16, 16 }, { 16, 16, 235 }, { 16, 16, 16 },
+	};
+
+	void putU16(std::vector<uint8_t>& out, uint32_t value)
+	{
+		out.push_back(value & 0xff);
+		out.push_back((value >> 8) & 0xff);
+	}
+
+	void putU32(std::vector<uint8_t>& out, uint32_t value)
+	{
+		putU16(out, value & 0xffff);
+		putU16(out, value >> 16);
+	}
+
+	// Bars scroll by a few pixels per frame, so consecutive frames differ everywhere like camera footage.
+	// The block moves across the lower half, the binary counter in the top left reads the frame index.
+	void drawFrame(std::vector<uint8_t>& rgb, int width, int height, int index, int frameCount)
+	{
+		int barWidth = width / BAR_COUNT > 0 ? width / BAR_COUNT : 1;
+		int blockSize = height / 6 > 0 ? height / 6 : 1;
+		int blockX = (width - blockSize) * index / (frameCount > 1 ? frameCount - 1 : 1);
+		int blockY = height * 2 / 3;
+		int bitSize = blockSize / 2 > 0 ? blockSize / 2 : 1;
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				uint8_t * pixel = &rgb[(y * width + x) * 3];
+				const uint8_t * bar = BARS[((x + index * 4) / barWidth) % BAR_COUNT];
+				// a vertical gradient on top of the bars keeps the encoder busy on every block.
+				int shade = 64 + 191 * y / height;
+				for (int c = 0; c < 3; ++c)
+				{
+					pixel[c] = (uint8_t)(bar[c] * shade / 255);
+				}
+				if (x >= blockX && x < blockX + blockSize && y >= blockY && y < blockY + blockSize)
+				{
+					pixel[0] = pixel[1] = pixel[2] = 255;
+				}
+				if (y < bitSize && x < bitSize * 16)
+				{
+					bool bit = (index >> (15 - x / bitSize)) & 1;
+					pixel[0] = pixel[1] = pixel[2] = bit ? 255 : 0;
+				}
+			}
+		}
+	}
+
+	bool encodeJpeg(const std::vector<uint8_t>& rgb, int width, int height, std::vector<uint8_t>& out)
+	{
+		jpeg_compress_struct cinfo;
+		jpeg_error_mgr jerr;
+		cinfo.err = jpeg_std_error(&jerr);
+		jpeg_create_compress(&cinfo);
+
+		unsigned char * buffer = nullptr;
+		unsigned long size = 0;
+		jpeg_mem_dest(&cinfo, &buffer, &size);
+		cinfo.image_width = width;
+		cinfo.image_height = height;
+		cinfo.input_components = 3;
+		cinfo.in_color_space = JCS_RGB;
+		jpeg_set_defaults(&cinfo); // 2x2 luma sampling, the 4:2:0 layout the YUV decode path expects
+		jpeg_set_quality(&cinfo, JPEG_QUALITY, TRUE);
+		jpeg_start_compress(&cinfo, TRUE);
+		while (cinfo.next_scanline < cinfo.image_height)
+		{
+			JSAMPROW row = const_cast<JSAMPROW>(&rgb[cinfo.next_scanline * width * 3]);
+			jpeg_write_scanlines(&cinfo, &row, 1);
+		}
+		jpeg_finish_compress(&cinfo);
+		jpeg_destroy_compress(&cinfo);
+
+		out.assign(buffer, buffer + size);
+		free(buffer);
+		return size > 0;
+	}
+}
+
+bool writeTestClip(const std::string& path, int width, int height, int frameCount, int fps)
+{
+	if (width <= 0 || height <= 0 || width > 0xffff || height > 0xffff || frameCount <= 0 || fps <= 0)
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> rgb(width * height * 3);
+	std::vector<std::vector<uint8_t>> payloads(frameCount);
+	for (int i = 0; i < frameCount; ++i)
+	{
+		drawFrame(rgb, width, height, i, frameCount);
+		if (!encodeJpeg(rgb, width, height, payloads[i]))
+		{
+			return false;
+		}
+	}
+
+	// header and frame table, see CCVideoDecoder.h. Every frame is a keyframe.
+	const uint32_t HEADER_SIZE = 32;
+	const uint32_t ENTRY_SIZE = 12;
+	std::vector<uint8_t> header;
+	header.insert(header.end(), { 'C', 'C', 'V', 'F' });
+	putU16(header, 1);
+	putU16(header, 1); // CCVideoCodec::JPEG
+	putU16(header, width);
+	putU16(header, height);
+	putU32(header, fps);
+	putU32(header, 1);
+	putU32(header, frameCount);
+	putU32(header, HEADER_SIZE);
+	putU32(header, 0);
+
+	uint32_t offset = HEADER_SIZE + ENTRY_SIZE * frameCount;
+	for (const auto& payload : payloads)
+	{
+		putU32(header, offset);
+		putU32(header, (uint32_t)payload.size());
+		putU32(header, 1); // CCVideoDecoder::FRAME_FLAG_KEYFRAME
+		offset += (uint32_t)payload.size();
+	}
+
+	FILE * file = fopen(path.c_str(), "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	bool ok = fwrite(header.data(), 1, header.size(), file) == header.size();
+	for (const auto& payload : payloads)
+	{
+		ok = ok && fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+	}
+	return fclose(file) == 0 && ok;
+}
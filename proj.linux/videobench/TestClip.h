@@ -0,0 +1,11 @@
+#ifndef _VIDEO_BENCH_TEST_CLIP_
+#define _VIDEO_BENCH_TEST_CLIP_
+
+#include <string>
+
+// Writes a synthetic CCV clip: scrolling colour bars with a moving block and a frame counter,
+// encoded as 4:2:0 JPEG like the clips ccvpack.py builds from ffmpeg output, so it goes through
+// the same YUV decode path. Resources/testpattern.ccv was made with "videobench --make-clip".
+bool writeTestClip(const std::string& path, int width, int height, int frameCount, int fps);
+
+#endif /*_VIDEO_BENCH_TEST_CLIP_*/
@@ -0,0 +1,128 @@
+#include "BenchApp.h"
+#include "TestClip.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static void usage()
+{
+	printf("usage: videobench [--csv file] [--seconds N] [--size WxH] clip.ccv...\n"
+		"       videobench --make-clip out.ccv [--size WxH] [--frames N]\n"
+		"  clips are looked up like any resource, relative to Resources/ next to the binary.\n"
+		"  Playback needs a GL context, run it under xvfb-run on a machine without a display.\n"
+		"  --csv        writes one row per presented frame\n"
+		"  --seconds    plays at most N seconds of each clip\n"
+		"  --size       size of the hidden window (1280x720) or of the clip made (480x270)\n"
+		"  --make-clip  writes a synthetic 30 fps test clip of N frames (60) and exits\n");
+}
+
+// Each clip runs in a process of its own so that the peak memory reported is the clip's own.
+static int runEachClip(const BenchApp::Options& options)
+{
+	if (!options.csvPath.empty())
+	{
+		FILE * csv = fopen(options.csvPath.c_str(), "w");
+		if (csv == nullptr)
+		{
+			fprintf(stderr, "videobench: can't write %s\n", options.csvPath.c_str());
+			return 1;
+		}
+		BenchApp::writeCsvHeader(csv);
+		fclose(csv);
+	}
+
+	int failures = 0;
+	for (const auto& clip : options.clips)
+	{
+		fflush(stdout);
+		pid_t pid = fork();
+		if (pid == 0)
+		{
+			BenchApp::Options clipOptions = options;
+			clipOptions.clips.assign(1, clip);
+			clipOptions.appendCsv = true;
+			BenchApp app(clipOptions);
+			exit(app.run());
+		}
+		int status = 0;
+		if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		{
+			++failures;
+		}
+	}
+	return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+	BenchApp::Options options;
+	const char * makeClipPath = nullptr;
+	int clipFrames = 60;
+	bool sizeGiven = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+		{
+			options.csvPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+		{
+			options.maxSeconds = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+		{
+			if (sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2)
+			{
+				usage();
+				return 2;
+			}
+			sizeGiven = true;
+		}
+		else if (strcmp(argv[i], "--make-clip") == 0 && i + 1 < argc)
+		{
+			makeClipPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+		{
+			clipFrames = atoi(argv[++i]);
+		}
+		else if (argv[i][0] == '-')
+		{
+			usage();
+			return strcmp(argv[i], "--help") == 0 ? 0 : 2;
+		}
+		else
+		{
+			options.clips.push_back(argv[i]);
+		}
+	}
+
+	if (makeClipPath)
+	{
+		int width = sizeGiven ? options.width : 480;
+		int height = sizeGiven ? options.height : 270;
+		if (!writeTestClip(makeClipPath, width, height, clipFrames, 30))
+		{
+			fprintf(stderr, "videobench: can't write %s\n", makeClipPath);
+			return 1;
+		}
+		printf("%s: %d frames, %dx%d, 30 fps\n", makeClipPath, clipFrames, width, height);
+		return 0;
+	}
+
+	if (options.clips.empty())
+	{
+		// the test clip shipped with the demo.
+		options.clips.push_back("testpattern.ccv");
+	}
+	if (options.clips.size() > 1)
+	{
+		return runEachClip(options);
+	}
+
+	BenchApp app(options);
+	return app.run();
+}
@@ -0,0 +1,103 @@
+#!/usr/bin/env python
+# Packs a folder of JPEG or WebP frames into a .ccv clip for the CCVideoManager texture backend.
+# The layout is documented in Classes/CCVideoDecoder.h.
+#
+# Frames can be extracted from any video with ffmpeg, e.g.
+#   ffmpeg -i showreel.mov -q:v 3 frames/%05d.jpg
+#   python tools/ccvpack.py frames Resources/showreel.ccv --fps 30
+
+import argparse
+import os
+import struct
+import sys
+
+CODEC_JPEG = 1
+CODEC_WEBP = 2
+
+KEYFRAME = 0x1
+
+
+def jpeg_size(data):
+    # walk the markers until the start of frame segment that holds the picture size
+    pos = 2
+    while pos + 9 < len(data):
+        if data[pos] != 0xFF:
+            pos += 1
+            continue
+        marker = data[pos + 1]
+        length = struct.unpack('>H', data[pos + 2:pos + 4])[0]
+        if marker in (0xC0, 0xC1, 0xC2):
+            height, width = struct.unpack('>HH', data[pos + 5:pos + 9])
+            return width, height
+        pos += 2 + length
+    return None
+
+
+def frame_codec(data):
+    if data[:2] == b'\xff\xd8':
+        return CODEC_JPEG
+    if data[:4] == b'RIFF' and data[8:12] == b'WEBP':
+        return CODEC_WEBP
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Pack JPEG/WebP frames into a CCV clip.')
+    parser.add_argument('frames', help='folder holding the frames, packed in file name order')
+    parser.add_argument('output', help='.ccv file to write')
+    parser.add_argument('--fps', default='30', help='frame rate, either an integer or num/den (e.g. 30000/1001)')
+    parser.add_argument('--size', help='WxH, required for WebP frames')
+    parser.add_argument('--keyframes', default='all',
+                        help='seek points for CCVideoPlayer::seek(t, true): "all" or comma separated frame numbers (0 based)')
+    args = parser.parse_args()
+
+    names = sorted(n for n in os.listdir(args.frames) if os.path.splitext(n)[1].lower() in ('.jpg', '.jpeg', '.webp'))
+    if not names:
+        sys.exit('no frames found in %s' % args.frames)
+
+    payloads = []
+    for name in names:
+        with open(os.path.join(args.frames, name), 'rb') as f:
+            payloads.append(bytearray(f.read()))
+
+    codec = frame_codec(payloads[0])
+    if codec is None or any(frame_codec(p) != codec for p in payloads):
+        sys.exit('all frames must be either JPEG or WebP')
+
+    if args.size:
+        width, height = (int(v) for v in args.size.lower().split('x'))
+    elif codec == CODEC_JPEG:
+        width, height = jpeg_size(payloads[0])
+    else:
+        sys.exit('--size is required for WebP frames')
+
+    if '/' in args.fps:
+        fps_num, fps_den = (int(v) for v in args.fps.split('/'))
+    else:
+        fps_num, fps_den = int(args.fps), 1
+
+    if args.keyframes == 'all':
+        keyframes = set(range(len(payloads)))
+    else:
+        keyframes = set(int(v) for v in args.keyframes.split(',') if v.strip())
+        keyframes.add(0)
+
+    header_size = 32
+    entry_size = 12
+    index_offset = header_size
+    offset = index_offset + entry_size * len(payloads)
+
+    with open(args.output, 'wb') as out:
+        out.write(struct.pack('<4sHHHHIIIII', b'CCVF', 1, codec, width, height,
+                              fps_num, fps_den, len(payloads), index_offset, 0))
+        for i, payload in enumerate(payloads):
+            out.write(struct.pack('<III', offset, len(payload), KEYFRAME if i in keyframes else 0))
+            offset += len(payload)
+        for payload in payloads:
+            out.write(payload)
+
+    print('%s: %d frames, %dx%d, %d/%d fps' % (args.output, len(payloads), width, height, fps_num, fps_den))
+
+
+if __name__ == '__main__':
+    main()